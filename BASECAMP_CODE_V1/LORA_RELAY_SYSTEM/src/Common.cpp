@@ -11,9 +11,8 @@ Preferences prefs;
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
 // Relay system globals
-std::vector<PacketInfo> packetHistory;
 std::vector<ForwardTarget> forwardTargets;
-std::map<String, unsigned long> packetHashes;
+DedupTable dedupTable(PACKET_DUPLICATE_WINDOW);
 unsigned long lastCleanup = 0;
 int totalReceived = 0;
 int totalForwarded = 0;
@@ -13,7 +13,7 @@
 #include <Adafruit_SSD1306.h>
 #include <ESPAsyncWebServer.h>
 #include <vector>
-#include <map>
+#include "DedupTable.h"
 
 // === HARDWARE CONFIGURATION ===
 // LoRa pins (same as BASECAMP for compatibility)
@@ -36,28 +36,80 @@
 #define MAX_PACKET_HISTORY 1000
 #define PACKET_CLEANUP_INTERVAL 300000  // 5 minutes
 #define PACKET_DUPLICATE_WINDOW 60000   // 1 minute duplicate detection window
-#define MAX_FORWARD_RETRIES 3
-#define FORWARD_RETRY_DELAY 1000
+#define MAX_FORWARD_RETRIES 8           // Failed attempts before a queued packet is dropped
+#define FORWARD_RETRY_DELAY 1000        // First backoff step, doubled per attempt
+#define FORWARD_RETRY_MAX_DELAY 60000
+#define FORWARD_PERSIST_QUEUE true      // Keep queued packets across reboots (NVS)
+#define BREAKER_FAILURE_THRESHOLD 5     // Consecutive failures that open a target's breaker
+#define BREAKER_OPEN_TIME 10000         // First open period before a probe, doubled on each failed probe
+#define BREAKER_MAX_OPEN_TIME 600000
+#define MAX_TARGET_NAME_LENGTH 24
+#define MAX_LORA_PACKET_SIZE 255
+#define MAX_NODE_ID_LENGTH 24
+#define MAX_FORWARD_TARGETS 32          // One bit each in a forward rule's target set
 
 // === DATA STRUCTURES ===
-struct PacketInfo {
-  String packetHash;
-  String nodeId;
-  unsigned long timestamp;
+// What a packet carries: its "type" field if it has one, otherwise position
+// when it has coordinates and telemetry when it does not
+enum PacketKind : uint8_t {
+  PACKET_TELEMETRY,
+  PACKET_POSITION,
+  PACKET_SOS
+};
+
+// Decoded once when a packet arrives and passed by reference through
+// dedup, history and every forwarder. `data` is a view into the receive
+// buffer and is only valid until the next packet is read.
+struct RelayPacket {
+  const char* data;
+  size_t length;
+  char nodeId[MAX_NODE_ID_LENGTH];
+  long sequence;            // -1 when the sender does not number its packets
   int rssi;
-  String data;
-  bool forwarded;
-  int forwardAttempts;
+  float snr;
+  uint64_t hash;            // FNV-1a over node ID and payload
+  unsigned long receivedAt;
+  bool isJson;              // Payload is a JSON object and can be embedded as-is
+  uint8_t hops;             // Relay hops so far; 0 when heard straight from the sender
+  PacketKind kind;
+  bool sos;                 // "sos_status" set by the hiker, or an SOS packet
+};
+
+// Closed: traffic flows. Open: the target is failing, packets only queue.
+// Half-open: the open period ran out and the next attempt is a probe.
+enum BreakerState {
+  BREAKER_CLOSED,
+  BREAKER_OPEN,
+  BREAKER_HALF_OPEN
+};
+
+enum ForwardType {
+  FORWARD_LORA,
+  FORWARD_HTTP,
+  FORWARD_TCP,
+  FORWARD_UDP,
+  FORWARD_SERIAL,
+  FORWARD_UNKNOWN
 };
 
 struct ForwardTarget {
   String name;
-  String type;  // "lora", "http", "tcp", "udp"
+  String type;  // "lora", "http", "tcp", "udp", "serial"
+  ForwardType protocol;         // `type` resolved once, so dispatch is a switch
   String address;
   int port;
+  String path;                  // HTTP only, e.g. "/post"
   bool enabled;
   unsigned long lastSuccess;
-  int failureCount;
+  int failureCount;             // Consecutive failures
+  
+  // Runtime only, never saved to preferences
+  BreakerState breaker;
+  unsigned long breakerChangedAt;
+  unsigned long openTime;       // Current open period, grows with failed probes
+  uint32_t delivered;
+  uint32_t deliveredFromQueue;
+  uint32_t dropped;
 };
 
 // === GLOBAL VARIABLES ===
@@ -68,9 +120,8 @@ extern bool configMode;
 extern Preferences prefs;
 
 // Relay system globals
-extern std::vector<PacketInfo> packetHistory;
 extern std::vector<ForwardTarget> forwardTargets;
-extern std::map<String, unsigned long> packetHashes;
+extern DedupTable dedupTable;
 extern unsigned long lastCleanup;
 extern int totalReceived;
 extern int totalForwarded;
@@ -0,0 +1,101 @@
+#include "DedupTable.h"
+#include <string.h>
+
+DedupTable::DedupTable(uint32_t window) : window(window) {
+  clear();
+}
+
+void DedupTable::clear() {
+  memset(slots, 0, sizeof(slots));
+  count = 0;
+  agingCursor = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+bool DedupTable::checkAndInsert(uint64_t hash, uint32_t now) {
+  if (hash == 0) hash = 1;  // 0 is reserved for empty slots
+  age(now, DEDUP_AGING_STEP);
+  stats.lookups++;
+
+  size_t index = hash & MASK;
+  size_t reuse = DEDUP_TABLE_SIZE;   // First expired slot on the probe path
+  size_t oldest = index;
+  size_t probe = 0;
+
+  for (; probe < DEDUP_TABLE_SIZE; probe++, index = (index + 1) & MASK) {
+    Slot& slot = slots[index];
+    if (slot.hash == 0) break;
+
+    if (slot.hash == hash) {
+      bool duplicate = !expired(slot, now);
+      slot.seenAt = now;
+      if (duplicate) stats.duplicates++;
+      if (probe > stats.maxProbe) stats.maxProbe = probe;
+      return duplicate;
+    }
+    if (reuse == DEDUP_TABLE_SIZE && expired(slot, now)) reuse = index;
+    if (now - slot.seenAt > now - slots[oldest].seenAt) oldest = index;
+  }
+  if (probe > stats.maxProbe) stats.maxProbe = probe;
+
+  // Overwriting a slot on our own probe path keeps every other chain intact
+  if (reuse != DEDUP_TABLE_SIZE) {
+    slots[reuse].hash = hash;
+    slots[reuse].seenAt = now;
+  } else if (probe == DEDUP_TABLE_SIZE) {
+    // Full of live entries: forget the oldest rather than refuse the packet
+    slots[oldest].hash = hash;
+    slots[oldest].seenAt = now;
+    stats.evictions++;
+  } else {
+    slots[index].hash = hash;
+    slots[index].seenAt = now;
+    count++;
+  }
+  return false;
+}
+
+void DedupTable::age(uint32_t now, size_t budget) {
+  if (count == 0) return;
+
+  for (size_t i = 0; i < budget; i++) {
+    Slot& slot = slots[agingCursor];
+    if (slot.hash != 0 && expired(slot, now)) {
+      // The shift may pull a later entry into this slot, look again next step
+      removeAt(agingCursor);
+    } else {
+      agingCursor = (agingCursor + 1) & MASK;
+    }
+  }
+}
+
+// Backward-shift deletion: move later entries of the cluster up so lookups
+// never stop early at the hole
+void DedupTable::removeAt(size_t index) {
+  size_t hole = index;
+  size_t next = index;
+
+  for (;;) {
+    next = (next + 1) & MASK;
+    if (slots[next].hash == 0) break;
+
+    size_t home = slots[next].hash & MASK;
+    // Entries whose home lies cyclically in (hole, next] must stay put
+    bool stays = hole <= next ? (hole < home && home <= next)
+                              : (hole < home || home <= next);
+    if (stays) continue;
+
+    slots[hole] = slots[next];
+    hole = next;
+  }
+
+  slots[hole].hash = 0;
+  slots[hole].seenAt = 0;
+  count--;
+}
+
+DedupStats DedupTable::getStats() const {
+  DedupStats result = stats;
+  result.entries = count;
+  return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef DEDUP_TABLE_H
+#define DEDUP_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// === DEDUP TABLE ===
+// Fixed-capacity open-addressing set of 64-bit packet hashes with the time
+// each was last seen. Linear probing with backward-shift deletion, so there
+// are no tombstones; expired entries are aged out a few slots per call
+// instead of in a full sweep. All storage is static - no heap after boot.
+// Kept free of Arduino headers so it builds on the host as well.
+
+#ifndef DEDUP_TABLE_SIZE
+#define DEDUP_TABLE_SIZE   1024   // Slots, power of two; keep live entries under ~50%
+#endif
+#define DEDUP_AGING_STEP   8      // Slots examined for expiry per lookup
+
+struct DedupStats {
+  uint32_t entries;
+  uint32_t lookups;
+  uint32_t duplicates;
+  uint32_t evictions;     // Live entries overwritten because the table was full
+  uint32_t maxProbe;      // Longest probe sequence seen
+};
+
+class DedupTable {
+public:
+  explicit DedupTable(uint32_t window);
+
+  // True if `hash` was seen less than `window` ms before `now`.
+  // Either way the entry ends up recorded with time `now`.
+  bool checkAndInsert(uint64_t hash, uint32_t now);
+
+  // Age out up to `slots` entries; called from checkAndInsert and idle time
+  void age(uint32_t now, size_t slots);
+
+  void clear();
+  size_t size() const { return count; }
+  DedupStats getStats() const;
+
+private:
+  struct Slot {
+    uint64_t hash;        // 0 marks an empty slot
+    uint32_t seenAt;
+  };
+
+  static const size_t MASK = DEDUP_TABLE_SIZE - 1;
+
+  bool expired(const Slot& slot, uint32_t now) const { return now - slot.seenAt >= window; }
+  void removeAt(size_t index);
+
+  Slot slots[DEDUP_TABLE_SIZE];
+  uint32_t window;
+  size_t count;
+  size_t agingCursor;
+  DedupStats stats;
+};
+
+#endif // DEDUP_TABLE_H
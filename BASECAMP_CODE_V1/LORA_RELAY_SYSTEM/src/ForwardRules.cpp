@@ -0,0 +1,232 @@
+#include "ForwardRules.h"
+
+// External references
+extern std::vector<ForwardTarget> forwardTargets;
+
+#define RULE_KIND_ALL (RULE_KIND_TELEMETRY | RULE_KIND_POSITION | RULE_KIND_SOS)
+
+static std::vector<ForwardRule> rules;
+static CompiledRule table[MAX_FORWARD_RULES];
+static uint32_t ruleMatches[MAX_FORWARD_RULES];
+static size_t tableSize = 0;
+static uint32_t defaultMatches = 0;
+
+// Up to RULE_PREFIX_LENGTH characters, first one in the top byte; the
+// bytes past a shorter string stay zero
+static uint64_t packNodeId(const char* id, size_t& length) {
+  uint64_t packed = 0;
+  for (length = 0; length < RULE_PREFIX_LENGTH && id[length] != '\0'; length++) {
+    packed |= (uint64_t)(uint8_t)id[length] << (56 - 8 * length);
+  }
+  return packed;
+}
+
+static uint32_t allTargetsMask() {
+  size_t count = min(forwardTargets.size(), (size_t)MAX_FORWARD_TARGETS);
+  return count == MAX_FORWARD_TARGETS ? 0xFFFFFFFFUL : (1UL << count) - 1;
+}
+
+static uint32_t resolveTargets(const String& names) {
+  if (names == RULE_ALL_TARGETS) {
+    return allTargetsMask();
+  }
+  
+  uint32_t mask = 0;
+  int start = 0;
+  while (start <= (int)names.length()) {
+    int comma = names.indexOf(',', start);
+    if (comma < 0) comma = names.length();
+    String name = names.substring(start, comma);
+    name.trim();
+    start = comma + 1;
+    if (name.length() == 0) continue;
+    
+    bool found = false;
+    for (size_t i = 0; i < forwardTargets.size() && i < MAX_FORWARD_TARGETS; i++) {
+      if (forwardTargets[i].name == name) {
+        mask |= 1UL << i;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      Serial.print("Forward rule names unknown target: ");
+      Serial.println(name);
+    }
+  }
+  return mask;
+}
+
+// Rebuilt whenever rules or targets change, since target bits are indices
+void compileForwardRules() {
+  tableSize = 0;
+  defaultMatches = 0;
+  
+  for (const auto& rule : rules) {
+    if (tableSize >= MAX_FORWARD_RULES) break;
+    
+    CompiledRule& compiled = table[tableSize];
+    size_t length;
+    compiled.prefix = packNodeId(rule.nodePrefix.c_str(), length);
+    compiled.prefixMask = length == 0 ? 0 : ~0ULL << (64 - 8 * length);
+    compiled.minRssi = constrain(rule.minRssi, RULE_RSSI_ANY, 0);
+    compiled.kinds = rule.kinds & RULE_KIND_ALL ? rule.kinds & RULE_KIND_ALL : RULE_KIND_ALL;
+    compiled.sos = rule.sos == RULE_SOS_ONLY ? 0x02 : rule.sos == RULE_SOS_NEVER ? 0x01 : 0x03;
+    compiled.targets = resolveTargets(rule.targets);
+    ruleMatches[tableSize] = 0;
+    
+    if (rule.nodePrefix.length() > RULE_PREFIX_LENGTH) {
+      Serial.print("Forward rule prefix cut to ");
+      Serial.print(RULE_PREFIX_LENGTH);
+      Serial.print(" characters: ");
+      Serial.println(rule.nodePrefix);
+    }
+    tableSize++;
+  }
+}
+
+// First match wins; no match means every target
+uint32_t selectForwardTargets(const RelayPacket& packet) {
+  size_t length;
+  uint64_t node = packNodeId(packet.nodeId, length);
+  uint8_t kind = 1 << packet.kind;
+  uint8_t sos = packet.sos ? 0x02 : 0x01;
+  
+  for (size_t i = 0; i < tableSize; i++) {
+    const CompiledRule& rule = table[i];
+    if ((node & rule.prefixMask) == rule.prefix && (rule.kinds & kind) && (rule.sos & sos) &&
+        packet.rssi >= rule.minRssi) {
+      ruleMatches[i]++;
+      return rule.targets;
+    }
+  }
+  defaultMatches++;
+  return 0xFFFFFFFFUL;
+}
+
+void loadForwardRules() {
+  prefs.begin("rules", true);
+  
+  int ruleCount = min((int)prefs.getUInt("rule_count", 0), MAX_FORWARD_RULES);
+  rules.clear();
+  
+  for (int i = 0; i < ruleCount; i++) {
+    ForwardRule rule;
+    String prefix = "r" + String(i) + "_";
+    
+    rule.nodePrefix = prefs.getString((prefix + "node").c_str(), "");
+    rule.kinds = prefs.getUChar((prefix + "kinds").c_str(), 0);
+    rule.sos = (RuleSos)prefs.getUChar((prefix + "sos").c_str(), RULE_SOS_ANY);
+    rule.minRssi = prefs.getInt((prefix + "rssi").c_str(), RULE_RSSI_ANY);
+    rule.targets = prefs.getString((prefix + "targets").c_str(), RULE_ALL_TARGETS);
+    rules.push_back(rule);
+  }
+  
+  prefs.end();
+  compileForwardRules();
+  
+  Serial.print("Loaded ");
+  Serial.print(rules.size());
+  Serial.println(" forward rules");
+}
+
+void saveForwardRules() {
+  prefs.begin("rules", false);
+  prefs.clear();
+  
+  prefs.putUInt("rule_count", rules.size());
+  
+  for (size_t i = 0; i < rules.size(); i++) {
+    String prefix = "r" + String(i) + "_";
+    const ForwardRule& rule = rules[i];
+    
+    prefs.putString((prefix + "node").c_str(), rule.nodePrefix);
+    prefs.putUChar((prefix + "kinds").c_str(), rule.kinds);
+    prefs.putUChar((prefix + "sos").c_str(), rule.sos);
+    prefs.putInt((prefix + "rssi").c_str(), rule.minRssi);
+    prefs.putString((prefix + "targets").c_str(), rule.targets);
+  }
+  
+  prefs.end();
+  Serial.println("Forward rules saved to preferences");
+}
+
+// Appended after the existing rules, so it only sees what they let through
+bool addForwardRule(const ForwardRule& rule) {
+  if (rules.size() >= MAX_FORWARD_RULES) {
+    Serial.println("Forward rule table full");
+    return false;
+  }
+  
+  rules.push_back(rule);
+  saveForwardRules();
+  compileForwardRules();
+  return true;
+}
+
+void clearForwardRules() {
+  rules.clear();
+  saveForwardRules();
+  compileForwardRules();
+}
+
+// "telemetry,position,sos" to RULE_KIND_* bits; 0 if any name is unknown
+uint8_t parseRuleKinds(const String& names) {
+  uint8_t kinds = 0;
+  int start = 0;
+  while (start <= (int)names.length()) {
+    int comma = names.indexOf(',', start);
+    if (comma < 0) comma = names.length();
+    String name = names.substring(start, comma);
+    start = comma + 1;
+    
+    if (name == "telemetry") kinds |= RULE_KIND_TELEMETRY;
+    else if (name == "position") kinds |= RULE_KIND_POSITION;
+    else if (name == "sos") kinds |= RULE_KIND_SOS;
+    else return 0;
+  }
+  return kinds;
+}
+
+static void printKinds(uint8_t kinds) {
+  if (kinds == RULE_KIND_ALL) {
+    Serial.print("any");
+    return;
+  }
+  const char* separator = "";
+  if (kinds & RULE_KIND_TELEMETRY) { Serial.print(separator); Serial.print("telemetry"); separator = ","; }
+  if (kinds & RULE_KIND_POSITION)  { Serial.print(separator); Serial.print("position"); separator = ","; }
+  if (kinds & RULE_KIND_SOS)       { Serial.print(separator); Serial.print("sos"); }
+}
+
+void printForwardRules() {
+  Serial.println("=== Forward Rules ===");
+  
+  for (size_t i = 0; i < tableSize; i++) {
+    const ForwardRule& rule = rules[i];
+    const CompiledRule& compiled = table[i];
+    
+    Serial.print("[");
+    Serial.print(i);
+    Serial.print("] node ");
+    Serial.print(rule.nodePrefix.length() > 0 ? rule.nodePrefix : String("any"));
+    Serial.print(", kind ");
+    printKinds(compiled.kinds);
+    Serial.print(", SOS ");
+    Serial.print(compiled.sos == 0x02 ? "only" : compiled.sos == 0x01 ? "never" : "any");
+    if (compiled.minRssi > RULE_RSSI_ANY) {
+      Serial.print(", RSSI >= ");
+      Serial.print(compiled.minRssi);
+    }
+    Serial.print(" -> ");
+    Serial.print(rule.targets);
+    Serial.print(" (mask 0x");
+    Serial.print(compiled.targets, HEX);
+    Serial.print("), matched ");
+    Serial.println(ruleMatches[i]);
+  }
+  
+  Serial.print("No rule matched, sent to all: ");
+  Serial.println(defaultMatches);
+  Serial.println("======================");
+}
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef FORWARD_RULES_H
+#define FORWARD_RULES_H
+
+#include "Common.h"
+
+// === FORWARD RULES ===
+// Decide which targets get a packet. Each rule matches on a node ID
+// prefix, the packet kind, the SOS flag and a minimum RSSI, and names the
+// targets it sends to. The first matching rule wins; a packet no rule
+// matches goes to every target, so an empty rule set behaves like before.
+//
+// Rules are kept in preferences as written and compiled into a flat table
+// whenever they or the target list change: the prefix is packed into a
+// 64-bit value and mask, and the target names become a bit per index in
+// forwardTargets. Matching a packet is then a handful of integer
+// comparisons per rule, with no strings involved.
+
+#define MAX_FORWARD_RULES   16
+#define RULE_PREFIX_LENGTH  8       // Node ID characters a prefix can compare
+#define RULE_RSSI_ANY       -32768  // minRssi that lets every packet through
+#define RULE_ALL_TARGETS    "*"
+
+// Bit per PacketKind; 0 in a rule means any kind
+#define RULE_KIND_TELEMETRY (1 << PACKET_TELEMETRY)
+#define RULE_KIND_POSITION  (1 << PACKET_POSITION)
+#define RULE_KIND_SOS       (1 << PACKET_SOS)
+
+enum RuleSos {
+  RULE_SOS_ANY,
+  RULE_SOS_ONLY,            // Only packets with the SOS flag
+  RULE_SOS_NEVER            // Only packets without it
+};
+
+// As configured and saved
+struct ForwardRule {
+  String nodePrefix;        // Empty matches every node
+  uint8_t kinds;            // RULE_KIND_* bits, 0 for any
+  RuleSos sos;
+  int minRssi;              // dBm
+  String targets;           // Comma separated target names, or RULE_ALL_TARGETS
+};
+
+// As matched per packet
+struct CompiledRule {
+  uint64_t prefix;          // Node ID prefix, first character in the top byte
+  uint64_t prefixMask;
+  int16_t minRssi;
+  uint8_t kinds;            // Never 0 once compiled
+  uint8_t sos;              // Bit 0: packets without the flag, bit 1: with it
+  uint32_t targets;         // Bit per index in forwardTargets
+};
+
+// === RULE FUNCTIONS ===
+void loadForwardRules();
+void saveForwardRules();
+bool addForwardRule(const ForwardRule& rule);
+void clearForwardRules();
+uint8_t parseRuleKinds(const String& names);
+void compileForwardRules();
+uint32_t selectForwardTargets(const RelayPacket& packet);
+void printForwardRules();
+
+#endif // FORWARD_RULES_H
@@ -1,20 +1,45 @@
 #include "Forwarder.h"
-#include <HTTPClient.h>
-#include <WiFiUdp.h>
+#include "RetryQueue.h"
+#include "HttpSession.h"
+#include "SocketSession.h"
+#include "Metrics.h"
+#include "Routing.h"
+#include "ForwardRules.h"
 
 // External references  
 extern int totalForwarded;
 extern std::vector<ForwardTarget> forwardTargets;
 
-// Local variables
-WiFiClient tcpClient;
-WiFiUDP udpClient;
-std::vector<PacketInfo> retryQueue;
+#define RETRY_ATTEMPTS_PER_PASS 4   // Bounds how long one loop() can spend on retries
+
+// Breaker and counters start fresh on every boot
+static void resetTargetRuntime(ForwardTarget& target) {
+  target.lastSuccess = 0;
+  target.failureCount = 0;
+  target.breaker = BREAKER_CLOSED;
+  target.breakerChangedAt = millis();
+  target.openTime = BREAKER_OPEN_TIME;
+  target.delivered = 0;
+  target.deliveredFromQueue = 0;
+  target.dropped = 0;
+}
+
+ForwardType parseForwardType(const String& type) {
+  if (type == "lora") return FORWARD_LORA;
+  if (type == "http") return FORWARD_HTTP;
+  if (type == "tcp") return FORWARD_TCP;
+  if (type == "udp") return FORWARD_UDP;
+  if (type == "serial") return FORWARD_SERIAL;
+  return FORWARD_UNKNOWN;
+}
 
 bool initializeForwarder() {
   Serial.println("=== Initializing Packet Forwarder ===");
   
   loadForwardTargets();
+  loadForwardRules();
+  loadRetryQueue();
+  initializeSocketSessions();
   
   Serial.print("Loaded ");
   Serial.print(forwardTargets.size());
@@ -30,17 +55,18 @@ void loadForwardTargets() {
   int targetCount = prefs.getUInt("target_count", 0);
   forwardTargets.clear();
   
-  for (int i = 0; i < targetCount; i++) {
+  for (int i = 0; i < targetCount && forwardTargets.size() < MAX_FORWARD_TARGETS; i++) {
     ForwardTarget target;
     String prefix = "t" + String(i) + "_";
     
     target.name = prefs.getString((prefix + "name").c_str(), "");
     target.type = prefs.getString((prefix + "type").c_str(), "http");
+    target.protocol = parseForwardType(target.type);
     target.address = prefs.getString((prefix + "addr").c_str(), "");
     target.port = prefs.getInt((prefix + "port").c_str(), 80);
+    target.path = prefs.getString((prefix + "path").c_str(), "/post");
     target.enabled = prefs.getBool((prefix + "enabled").c_str(), true);
-    target.lastSuccess = 0;
-    target.failureCount = 0;
+    resetTargetRuntime(target);
     
     if (target.name.length() > 0) {
       forwardTargets.push_back(target);
@@ -65,6 +91,7 @@ void loadForwardTargets() {
     Serial.println("No forward targets found, adding default HTTP target");
     addForwardTarget("default-http", FORWARD_HTTP, "httpbin.org", 80);
   }
+  compileForwardRules();
 }
 
 void saveForwardTargets() {
@@ -81,6 +108,7 @@ void saveForwardTargets() {
     prefs.putString((prefix + "type").c_str(), target.type);
     prefs.putString((prefix + "addr").c_str(), target.address);
     prefs.putInt((prefix + "port").c_str(), target.port);
+    prefs.putString((prefix + "path").c_str(), target.path);
     prefs.putBool((prefix + "enabled").c_str(), target.enabled);
   }
   
@@ -88,9 +116,24 @@ void saveForwardTargets() {
   Serial.println("Forward targets saved to preferences");
 }
 
-bool addForwardTarget(const String& name, ForwardType type, const String& address, int port) {
+bool addForwardTarget(const String& name, ForwardType type, const String& address, int port,
+                      const String& path) {
+  // Rules address targets by bit, so the count is capped
+  if (forwardTargets.size() >= MAX_FORWARD_TARGETS) {
+    Serial.println("Forward target list full");
+    return false;
+  }
+  for (const auto& existing : forwardTargets) {
+    if (existing.name == name) {
+      Serial.print("Forward target already exists: ");
+      Serial.println(name);
+      return false;
+    }
+  }
+  
   ForwardTarget target;
   target.name = name;
+  target.protocol = type;
   
   switch (type) {
     case FORWARD_LORA:
@@ -113,12 +156,13 @@ bool addForwardTarget(const String& name, ForwardType type, const String& addres
   
   target.address = address;
   target.port = port;
+  target.path = path;
   target.enabled = true;
-  target.lastSuccess = 0;
-  target.failureCount = 0;
+  resetTargetRuntime(target);
   
   forwardTargets.push_back(target);
   saveForwardTargets();
+  compileForwardRules();
   
   Serial.print("Added forward target: ");
   Serial.println(name);
@@ -129,8 +173,12 @@ bool addForwardTarget(const String& name, ForwardType type, const String& addres
 bool removeForwardTarget(const String& name) {
   for (auto it = forwardTargets.begin(); it != forwardTargets.end(); ++it) {
     if (it->name == name) {
+      retryDropTarget(*it);
+      closeHttpSession(*it);
+      closeSocketSession(*it);
       forwardTargets.erase(it);
       saveForwardTargets();
+      compileForwardRules();
       Serial.print("Removed forward target: ");
       Serial.println(name);
       return true;
@@ -152,15 +200,146 @@ void enableForwardTarget(const String& name, bool enabled) {
   }
 }
 
-bool forwardPacket(const String& packet, const String& nodeId) {
+static const char* breakerName(BreakerState state) {
+  switch (state) {
+    case BREAKER_OPEN:      return "open";
+    case BREAKER_HALF_OPEN: return "half-open";
+    default:                return "closed";
+  }
+}
+
+static void setBreaker(ForwardTarget& target, BreakerState state) {
+  if (target.breaker == state) return;
+  target.breaker = state;
+  target.breakerChangedAt = millis();
+  Serial.print("Target ");
+  Serial.print(target.name);
+  Serial.print(" breaker ");
+  Serial.println(breakerName(state));
+}
+
+// Closed lets everything through; an open breaker turns half-open once its
+// open period has passed, and then lets exactly the next attempt probe
+static bool breakerAllows(ForwardTarget& target) {
+  if (target.breaker == BREAKER_OPEN && millis() - target.breakerChangedAt >= target.openTime) {
+    setBreaker(target, BREAKER_HALF_OPEN);
+  }
+  return target.breaker != BREAKER_OPEN;
+}
+
+bool isTargetAvailable(ForwardTarget& target) {
+  return breakerAllows(target);
+}
+
+static bool sendToTarget(const RelayPacket& packet, const ForwardTarget& target) {
+  switch (target.protocol) {
+    case FORWARD_LORA:   return forwardToLoRa(packet, target);
+    case FORWARD_HTTP:   return forwardToHTTP(packet, target);
+    case FORWARD_TCP:    return forwardToTCP(packet, target);
+    case FORWARD_UDP:    return forwardToUDP(packet, target);
+    case FORWARD_SERIAL: return forwardToSerial(packet, target);
+    default:             return false;
+  }
+}
+
+// Equal jitter: half the exponential step fixed, half random, so targets
+// recovering together do not get hit by every relay at once
+static unsigned long retryBackoff(uint8_t attempts) {
+  unsigned long delayMs = FORWARD_RETRY_DELAY << min((int)attempts - 1, 16);
+  delayMs = min(delayMs, (unsigned long)FORWARD_RETRY_MAX_DELAY);
+  return delayMs / 2 + random(delayMs / 2 + 1);
+}
+
+enum AttemptResult {
+  ATTEMPT_FAILED,
+  ATTEMPT_DELIVERED,
+  ATTEMPT_BATCHED               // In a session batch; see markTargetDelivered()
+};
+
+// Sessions only buffer the packet; the batch send decides whether it was
+// delivered, and tells the breaker itself
+static bool isBatched(const ForwardTarget& target) {
+  return target.protocol == FORWARD_HTTP || target.protocol == FORWARD_TCP ||
+         target.protocol == FORWARD_UDP;
+}
+
+static AttemptResult attemptTarget(const RelayPacket& packet, ForwardTarget& target) {
+  uint32_t start = micros();
+  bool success = sendToTarget(packet, target);
+  metricsObserveForward(target, micros() - start);
+  if (!success) {
+    metricsCountForward(target, false);
+  }
+  if (isBatched(target)) {
+    return success ? ATTEMPT_BATCHED : ATTEMPT_FAILED;
+  }
+  if (success) {
+    metricsCountForward(target, true);
+    markTargetSuccess(target.name);
+  } else {
+    markTargetFailure(target.name);
+  }
+  return success ? ATTEMPT_DELIVERED : ATTEMPT_FAILED;
+}
+
+// A batched packet is held outside the retry pool while its batch is open;
+// markTargetUndelivered() moves it into the pool only if the batch fails
+static AttemptResult attemptBatched(const RelayPacket& packet, ForwardTarget& target) {
+  RetryEntry* held = retryHold(target, packet, NULL);
+  if (held == NULL) {
+    Serial.println("No free batch slot");
+    return ATTEMPT_FAILED;
+  }
+  AttemptResult result = attemptTarget(packet, target);
+  if (result == ATTEMPT_FAILED) {
+    retryRelease(held);
+  }
+  return result;
+}
+
+// A held packet that failed goes back into the pool, or is dropped once it
+// has used up its attempts
+static void requeueOrDrop(ForwardTarget& target, RetryEntry* held, bool countAttempt) {
+  if (countAttempt && ++held->attempts >= MAX_FORWARD_RETRIES) {
+    Serial.print("Dropping packet from ");
+    Serial.print(held->nodeId);
+    Serial.print(" for ");
+    Serial.print(target.name);
+    Serial.println(" after max retries");
+    target.dropped++;
+    retryRelease(held);
+    return;
+  }
+  retryRequeue(held, countAttempt ? millis() + retryBackoff(held->attempts) : millis());
+}
+
+// True once some target delivered the packet or took it into a batch
+bool forwardPacket(const RelayPacket& packet) {
   bool anySuccess = false;
+  bool anyBatched = false;
   
   Serial.println("=== Forwarding Packet ===");
   Serial.print("From: ");
-  Serial.println(nodeId);
+  Serial.println(packet.nodeId);
   
-  for (auto& target : forwardTargets) {
-    if (!target.enabled) {
+  // Bit per index in forwardTargets, from the compiled forward rules
+  uint32_t selected = selectForwardTargets(packet);
+  
+  for (size_t i = 0; i < forwardTargets.size(); i++) {
+    ForwardTarget& target = forwardTargets[i];
+    if (!target.enabled || !(selected & (1UL << i))) {
+      continue;
+    }
+    
+    // Queue behind earlier packets so a target always sees them in order,
+    // and queue outright while its breaker is open
+    if (retryHead(target) != NULL || !breakerAllows(target)) {
+      retryEnqueue(target, packet, 0, millis(), false);
+      Serial.print("Queued for ");
+      Serial.print(target.name);
+      Serial.print(" (breaker ");
+      Serial.print(breakerName(target.breaker));
+      Serial.println(")");
       continue;
     }
     
@@ -170,189 +349,132 @@ bool forwardPacket(const String& packet, const String& nodeId) {
     Serial.print(target.type);
     Serial.println(")...");
     
-    bool success = false;
-    
-    if (target.type == "lora") {
-      success = forwardToLoRa(packet, target);
-    } else if (target.type == "http") {
-      success = forwardToHTTP(packet, target);
-    } else if (target.type == "tcp") {
-      success = forwardToTCP(packet, target);
-    } else if (target.type == "udp") {
-      success = forwardToUDP(packet, target);
-    } else if (target.type == "serial") {
-      success = forwardToSerial(packet, target);
+    AttemptResult result = isBatched(target) ? attemptBatched(packet, target)
+                                             : attemptTarget(packet, target);
+    if (result == ATTEMPT_FAILED) {
+      retryEnqueue(target, packet, 1, millis() + retryBackoff(1), false);
     }
     
-    if (success) {
-      markTargetSuccess(target.name);
+    if (result == ATTEMPT_DELIVERED) {
+      target.delivered++;
       anySuccess = true;
       Serial.println("✓ Forward successful");
+    } else if (result == ATTEMPT_BATCHED) {
+      anyBatched = true;
+      Serial.println("✓ Added to batch");
     } else {
-      markTargetFailure(target.name);
-      Serial.println("✗ Forward failed");
+      Serial.println("✗ Forward failed, queued for retry");
     }
   }
   
   if (anySuccess) {
     totalForwarded++;
+    retryMarkCounted(packet.hash);
   }
   
   Serial.println("======================");
-  return anySuccess;
+  return anySuccess || anyBatched;
 }
 
-bool forwardToLoRa(const String& packet, const ForwardTarget& target) {
-  // Forward via LoRa (re-transmission)
-  // This could be used to create a mesh network
-  
-  if (!LoRa.beginPacket()) {
-    return false;
-  }
-  
-  // Add relay prefix to indicate this is a forwarded packet
-  String relayPacket = "{\"relay\":\"" + target.address + "\",\"data\":" + packet + "}";
-  
-  LoRa.print(relayPacket);
-  bool success = LoRa.endPacket();
-  
-  if (success) {
-    Serial.print("LoRa forward to ");
-    Serial.print(target.address);
-    Serial.println(" completed");
-  }
-  
-  return success;
+// Unicast to the next hop toward a basecamp (see Routing.cpp); the target
+// address names a preferred basecamp, or is empty for the nearest one
+bool forwardToLoRa(const RelayPacket& packet, const ForwardTarget& target) {
+  return routePacket(packet, target);
 }
 
-bool forwardToHTTP(const String& packet, const ForwardTarget& target) {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected, skipping HTTP forward");
-    return false;
-  }
-  
-  HTTPClient http;
-  String url = "http://" + target.address;
-  
-  if (target.port != 80) {
-    url += ":" + String(target.port);
-  }
-  
-  // Default path for testing
-  url += "/post";
-  
-  http.begin(url);
-  http.addHeader("Content-Type", "application/json");
-  http.addHeader("User-Agent", "LoRa-Relay/1.0");
-  
-  // Create forwarded packet with metadata
-  JsonDocument doc;
-  doc["relay_id"] = relayId;
-  doc["timestamp"] = millis();
-  doc["original_packet"] = packet;
-  doc["rssi"] = -80; // TODO: Get actual RSSI
-  
-  String jsonString;
-  serializeJson(doc, jsonString);
-  
-  int httpResponseCode = http.POST(jsonString);
-  
-  bool success = (httpResponseCode >= 200 && httpResponseCode < 300);
-  
-  if (success) {
-    Serial.print("HTTP forward successful (");
-    Serial.print(httpResponseCode);
-    Serial.println(")");
-  } else {
-    Serial.print("HTTP forward failed (");
-    Serial.print(httpResponseCode);
-    Serial.println(")");
-  }
-  
-  http.end();
-  return success;
+// Packets join the target's keep-alive batch (see HttpSession.cpp); the
+// batch POST reports success or failure to the breaker itself
+bool forwardToHTTP(const RelayPacket& packet, const ForwardTarget& target) {
+  return httpSessionAppend(packet, target);
 }
 
-bool forwardToTCP(const String& packet, const ForwardTarget& target) {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected, skipping TCP forward");
-    return false;
-  }
-  
-  if (tcpClient.connect(target.address.c_str(), target.port)) {
-    // Send packet with newline delimiter
-    tcpClient.println(packet);
-    tcpClient.stop();
-    
-    Serial.print("TCP forward to ");
-    Serial.print(target.address);
-    Serial.print(":");
-    Serial.print(target.port);
-    Serial.println(" completed");
-    
-    return true;
-  } else {
-    Serial.println("TCP connection failed");
-    return false;
-  }
+// TCP and UDP packets are framed and coalesced per target (see SocketSession.cpp)
+bool forwardToTCP(const RelayPacket& packet, const ForwardTarget& target) {
+  return socketSessionAppend(packet, target);
 }
 
-bool forwardToUDP(const String& packet, const ForwardTarget& target) {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected, skipping UDP forward");
-    return false;
-  }
-  
-  udpClient.begin(8080); // Local port
-  
-  if (udpClient.beginPacket(target.address.c_str(), target.port)) {
-    udpClient.print(packet);
-    bool success = udpClient.endPacket();
-    
-    if (success) {
-      Serial.print("UDP forward to ");
-      Serial.print(target.address);
-      Serial.print(":");
-      Serial.print(target.port);
-      Serial.println(" completed");
-    }
-    
-    return success;
-  }
-  
-  return false;
+bool forwardToUDP(const RelayPacket& packet, const ForwardTarget& target) {
+  return socketSessionAppend(packet, target);
 }
 
-bool forwardToSerial(const String& packet, const ForwardTarget& target) {
+bool forwardToSerial(const RelayPacket& packet, const ForwardTarget& target) {
   // Forward to serial port (useful for debugging or connecting to other systems)
   Serial.print("RELAY_DATA: ");
-  Serial.println(packet);
+  Serial.write((const uint8_t*)packet.data, packet.length);
+  Serial.println();
   
   return true; // Serial always "succeeds"
 }
 
+// Called by a session once a batch is sent: its packets are let go and
+// only now count as delivered
+void markTargetDelivered(const String& name, const uint64_t* hashes, size_t count) {
+  for (auto& target : forwardTargets) {
+    if (target.name != name) continue;
+    
+    for (size_t i = 0; i < count; i++) {
+      target.delivered++;
+      RetryEntry* entry = retryFindHeld(target, hashes[i]);
+      if (entry == NULL) continue;   // Target removed and re-added meanwhile
+      
+      if (entry->retried) {
+        target.deliveredFromQueue++;
+      }
+      if (!entry->counted) {
+        totalForwarded++;
+        retryMarkCounted(entry->hash);
+      }
+      retryRelease(entry);
+    }
+    metricsCountForward(target, true, count);
+    markTargetSuccess(name);
+    return;
+  }
+}
+
+// Called by a session whose batch could not be sent: its packets move into
+// the retry pool as one failed attempt each. The session tells the breaker
+// itself, since a batch given up while WiFi is down was never tried.
+void markTargetUndelivered(const String& name, const uint64_t* hashes, size_t count) {
+  for (auto& target : forwardTargets) {
+    if (target.name != name) continue;
+    
+    for (size_t i = 0; i < count; i++) {
+      RetryEntry* entry = retryFindHeld(target, hashes[i]);
+      if (entry != NULL) {
+        requeueOrDrop(target, entry, true);
+      }
+    }
+    metricsCountForward(target, false, count);
+    return;
+  }
+}
+
 void markTargetSuccess(const String& name) {
   for (auto& target : forwardTargets) {
     if (target.name == name) {
       target.lastSuccess = millis();
       target.failureCount = 0;
+      target.openTime = BREAKER_OPEN_TIME;
+      setBreaker(target, BREAKER_CLOSED);
       return;
     }
   }
 }
 
+// Failures only move the breaker; the target stays enabled and nothing is
+// written to preferences
 void markTargetFailure(const String& name) {
   for (auto& target : forwardTargets) {
     if (target.name == name) {
       target.failureCount++;
       
-      // Disable target after too many failures
-      if (target.failureCount >= 5) {
-        Serial.print("Disabling target ");
-        Serial.print(name);
-        Serial.println(" due to repeated failures");
-        target.enabled = false;
-        saveForwardTargets();
+      if (target.breaker == BREAKER_HALF_OPEN) {
+        // Failed probe: stay away longer next time
+        target.openTime = min(target.openTime * 2, (unsigned long)BREAKER_MAX_OPEN_TIME);
+        setBreaker(target, BREAKER_OPEN);
+      } else if (target.breaker == BREAKER_CLOSED && target.failureCount >= BREAKER_FAILURE_THRESHOLD) {
+        setBreaker(target, BREAKER_OPEN);
       }
       return;
     }
@@ -360,20 +482,20 @@ void markTargetFailure(const String& name) {
 }
 
 void checkTargetHealth() {
-  unsigned long currentTime = millis();
-  
   for (auto& target : forwardTargets) {
     if (!target.enabled) continue;
     
-    // Re-enable targets after 10 minutes if they were disabled due to failures
-    if (target.failureCount >= 5 && currentTime - target.lastSuccess > 600000) {
-      Serial.print("Re-enabling target ");
+    // Moves expired open breakers to half-open so the next retry probes
+    breakerAllows(target);
+    
+    if (target.breaker != BREAKER_CLOSED) {
+      Serial.print("Target ");
       Serial.print(target.name);
-      Serial.println(" after cooldown period");
-      
-      target.enabled = true;
-      target.failureCount = 0;
-      saveForwardTargets();
+      Serial.print(" breaker ");
+      Serial.print(breakerName(target.breaker));
+      Serial.print(", ");
+      Serial.print(retryDepth(target));
+      Serial.println(" packets queued");
     }
   }
 }
@@ -405,18 +527,98 @@ void printForwardTargets() {
       Serial.print(":");
       Serial.print(target.port);
     }
+    if (target.protocol == FORWARD_HTTP) {
+      Serial.print(target.path);
+    }
     
     Serial.print(") Failures: ");
-    Serial.println(target.failureCount);
+    Serial.print(target.failureCount);
+    Serial.print(", breaker ");
+    Serial.print(breakerName(target.breaker));
+    Serial.print(", queued ");
+    Serial.print(retryDepth(target));
+    Serial.print(", delivered ");
+    Serial.print(target.delivered);
+    Serial.print(" (");
+    Serial.print(target.deliveredFromQueue);
+    Serial.print(" from queue), dropped ");
+    Serial.println(target.dropped);
   }
   
+  RetryStats retry = getRetryStats();
+  Serial.print("Retry queue: ");
+  Serial.print(retry.queued);
+  Serial.print("/");
+  Serial.print(RETRY_POOL_SIZE);
+  Serial.print(", held in batches ");
+  Serial.print(retry.held);
+  Serial.print(", overflow drops ");
+  Serial.print(retry.overflowDrops);
+  Serial.print(", restored ");
+  Serial.println(retry.restored);
   Serial.println("======================");
 }
 
+// Called every loop(): sends each target's oldest queued packet once it is
+// due and the breaker allows it, draining the queue in order on success
 void processRetryQueue() {
-  // Implementation for retry mechanism
-  // This would handle packets that failed to forward
-  // For now, we keep it simple and don't implement retry queue
+  int budget = RETRY_ATTEMPTS_PER_PASS;
+  
+  for (auto& target : forwardTargets) {
+    if (!target.enabled) continue;
+    
+    while (budget > 0) {
+      RetryEntry* entry = retryHead(target);
+      if (entry == NULL || (long)(millis() - entry->nextAttemptAt) < 0) break;
+      if (!breakerAllows(target)) break;
+      
+      bool probe = target.breaker == BREAKER_HALF_OPEN;
+      budget--;
+      
+      if (isBatched(target)) {
+        // Out of the pool before the attempt: a full batch flushing on the
+        // way in may requeue packets into the pool, which must not land on
+        // this entry's slot
+        RetryEntry* held = retryHold(target, retryPacket(*entry), entry);
+        if (held == NULL) break;   // Every batch slot taken, try next loop
+        retryRemove(entry);
+        if (attemptTarget(retryPacket(*held), target) != ATTEMPT_BATCHED) {
+          // A failed probe is the target's fault, not the packet's
+          requeueOrDrop(target, held, !probe);
+          break;
+        }
+        continue;
+      }
+      
+      AttemptResult result = attemptTarget(retryPacket(*entry), target);
+      if (result == ATTEMPT_DELIVERED) {
+        target.delivered++;
+        target.deliveredFromQueue++;
+        if (!entry->counted) {
+          totalForwarded++;
+          retryMarkCounted(entry->hash);
+        }
+        retryRemove(entry);
+        continue;
+      }
+      
+      // A failed probe is the target's fault, not the packet's
+      if (!probe && ++entry->attempts >= MAX_FORWARD_RETRIES) {
+        Serial.print("Dropping packet from ");
+        Serial.print(entry->nodeId);
+        Serial.print(" for ");
+        Serial.print(target.name);
+        Serial.println(" after max retries");
+        target.dropped++;
+        retryRemove(entry);
+      } else if (!probe) {
+        entry->nextAttemptAt = millis() + retryBackoff(entry->attempts);
+      }
+      break;
+    }
+  }
+  
+  saveRetryQueue();
 }
 
 void retryFailedForwards() {
@@ -4,35 +4,31 @@
 
 #include "Common.h"
 
-// === FORWARDING MECHANISMS ===
-enum ForwardType {
-  FORWARD_LORA,
-  FORWARD_HTTP,
-  FORWARD_TCP,
-  FORWARD_UDP,
-  FORWARD_SERIAL
-};
-
 // === FORWARDER FUNCTIONS ===
 bool initializeForwarder();
 void loadForwardTargets();
 void saveForwardTargets();
-bool addForwardTarget(const String& name, ForwardType type, const String& address, int port = 0);
+bool addForwardTarget(const String& name, ForwardType type, const String& address, int port = 0,
+                      const String& path = "/post");
 bool removeForwardTarget(const String& name);
 void enableForwardTarget(const String& name, bool enabled = true);
+ForwardType parseForwardType(const String& type);
 
 // === PACKET FORWARDING ===
-bool forwardPacket(const String& packet, const String& nodeId);
-bool forwardToLoRa(const String& packet, const ForwardTarget& target);
-bool forwardToHTTP(const String& packet, const ForwardTarget& target);
-bool forwardToTCP(const String& packet, const ForwardTarget& target);
-bool forwardToUDP(const String& packet, const ForwardTarget& target);
-bool forwardToSerial(const String& packet, const ForwardTarget& target);
+bool forwardPacket(const RelayPacket& packet);
+bool forwardToLoRa(const RelayPacket& packet, const ForwardTarget& target);
+bool forwardToHTTP(const RelayPacket& packet, const ForwardTarget& target);
+bool forwardToTCP(const RelayPacket& packet, const ForwardTarget& target);
+bool forwardToUDP(const RelayPacket& packet, const ForwardTarget& target);
+bool forwardToSerial(const RelayPacket& packet, const ForwardTarget& target);
 
 // === TARGET MANAGEMENT ===
 void checkTargetHealth();
 void markTargetFailure(const String& name);
 void markTargetSuccess(const String& name);
+void markTargetDelivered(const String& name, const uint64_t* hashes, size_t count);
+void markTargetUndelivered(const String& name, const uint64_t* hashes, size_t count);
+bool isTargetAvailable(ForwardTarget& target);
 std::vector<ForwardTarget> getActiveTargets();
 void printForwardTargets();
 
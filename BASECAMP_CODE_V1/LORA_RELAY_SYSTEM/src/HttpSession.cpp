@@ -0,0 +1,268 @@
+#include "HttpSession.h"
+#include "Forwarder.h"
+#include <HTTPClient.h>
+#include <algorithm>
+
+struct HttpSession {
+  bool used;
+  char target[MAX_TARGET_NAME_LENGTH];
+  WiFiClient client;
+  HTTPClient http;
+  bool begun;                // begin() done, the connection may be reused
+  String body;
+  uint16_t packets;
+  uint64_t hashes[HTTP_BATCH_MAX_PACKETS];  // Packets in the body, for markTargetDelivered()
+  unsigned long firstQueuedAt;
+  unsigned long firstRequestAt;
+  HttpSessionStats stats;
+  uint32_t latencies[HTTP_LATENCY_SAMPLES];
+  uint8_t latencyCount;
+  uint8_t latencyNext;
+};
+
+static HttpSession sessions[HTTP_MAX_SESSIONS];
+
+static HttpSession* findSession(const String& name, bool create) {
+  HttpSession* freeSession = NULL;
+  for (size_t i = 0; i < HTTP_MAX_SESSIONS; i++) {
+    HttpSession& session = sessions[i];
+    if (!session.used) {
+      if (freeSession == NULL) freeSession = &session;
+      continue;
+    }
+    if (strncmp(session.target, name.c_str(), MAX_TARGET_NAME_LENGTH - 1) == 0) {
+      return &session;
+    }
+  }
+  if (!create || freeSession == NULL) return NULL;
+  
+  HttpSession& session = *freeSession;
+  session.used = true;
+  strncpy(session.target, name.c_str(), MAX_TARGET_NAME_LENGTH - 1);
+  session.target[MAX_TARGET_NAME_LENGTH - 1] = '\0';
+  session.begun = false;
+  session.body = "";
+  session.body.reserve(HTTP_BATCH_MAX_BYTES);
+  session.packets = 0;
+  session.firstRequestAt = 0;
+  memset(&session.stats, 0, sizeof(session.stats));
+  session.latencyCount = 0;
+  session.latencyNext = 0;
+  return &session;
+}
+
+// Escape arbitrary bytes as a JSON string
+static void appendJsonString(String& out, const char* data, size_t length) {
+  out += '"';
+  for (size_t i = 0; i < length; i++) {
+    char c = data[i];
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if ((uint8_t)c < 0x20) {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+// One NDJSON line with the same fields the single-packet POST used to send.
+// A JSON payload is embedded as an object, anything else as a string.
+static void appendPacketLine(String& body, const RelayPacket& packet) {
+  body += "{\"relay_id\":";
+  appendJsonString(body, relayId.c_str(), relayId.length());
+  body += ",\"node_id\":";
+  appendJsonString(body, packet.nodeId, strlen(packet.nodeId));
+  body += ",\"timestamp\":";
+  body += packet.receivedAt;
+  body += ",\"rssi\":";
+  body += packet.rssi;
+  body += ",\"snr\":";
+  body += String(packet.snr, 1);
+  body += ",\"original_packet\":";
+  if (packet.isJson) {
+    body.concat(packet.data, packet.length);
+  } else {
+    appendJsonString(body, packet.data, packet.length);
+  }
+  body += "}\n";
+}
+
+static void recordLatency(HttpSession& session, uint32_t latencyMs) {
+  session.latencies[session.latencyNext] = latencyMs;
+  session.latencyNext = (session.latencyNext + 1) % HTTP_LATENCY_SAMPLES;
+  if (session.latencyCount < HTTP_LATENCY_SAMPLES) session.latencyCount++;
+}
+
+// The packets go back to the retry queue, which persists them and backs off
+static void giveUpBatch(HttpSession& session, const ForwardTarget& target) {
+  markTargetUndelivered(target.name, session.hashes, session.packets);
+  session.body = "";
+  session.packets = 0;
+}
+
+static bool flushSession(HttpSession& session, const ForwardTarget& target) {
+  if (session.packets == 0) return true;
+  if (WiFi.status() != WL_CONNECTED) {
+    giveUpBatch(session, target);
+    return false;
+  }
+  
+  if (!session.begun) {
+    String url = "http://" + target.address;
+    if (target.port != 80) {
+      url += ":" + String(target.port);
+    }
+    url += target.path.length() > 0 ? target.path : "/post";
+    
+    session.http.setReuse(true);
+    session.http.setTimeout(HTTP_TIMEOUT);
+    session.http.begin(session.client, url);
+    session.begun = true;
+  }
+  if (!session.client.connected()) {
+    session.stats.connects++;
+  }
+  
+  // Request headers are cleared after every request
+  session.http.addHeader("Content-Type", "application/x-ndjson");
+  session.http.addHeader("User-Agent", "LoRa-Relay/1.0");
+  
+  unsigned long start = millis();
+  int code = session.http.POST((uint8_t*)session.body.c_str(), session.body.length());
+  uint32_t latency = millis() - start;
+  
+  if (session.firstRequestAt == 0) session.firstRequestAt = start;
+  session.stats.requests++;
+  
+  bool success = code >= 200 && code < 300;
+  if (code > 0) {
+    // Read the response out so the connection can carry the next request
+    session.http.getString();
+  } else {
+    // Transport error: start over with a fresh connection next time
+    session.http.end();
+    session.begun = false;
+  }
+  
+  if (success) {
+    recordLatency(session, latency);
+    session.stats.packets += session.packets;
+    session.stats.bytes += session.body.length();
+    session.body = "";
+    uint16_t sent = session.packets;
+    session.packets = 0;
+    markTargetDelivered(target.name, session.hashes, sent);
+  } else {
+    session.stats.failures++;
+    Serial.print("HTTP batch to ");
+    Serial.print(target.name);
+    Serial.print(" failed (");
+    Serial.print(code);
+    Serial.println("), queued for retry");
+    giveUpBatch(session, target);
+    markTargetFailure(target.name);
+  }
+  return success;
+}
+
+bool httpSessionAppend(const RelayPacket& packet, const ForwardTarget& target) {
+  HttpSession* session = findSession(target.name, true);
+  if (session == NULL) {
+    Serial.println("No free HTTP session slot");
+    return false;
+  }
+  
+  // Worst case is every payload byte escaped, plus the metadata
+  size_t needed = packet.length * 2 + 160 + relayId.length();
+  if (session->packets >= HTTP_BATCH_MAX_PACKETS ||
+      (session->packets > 0 && session->body.length() + needed > HTTP_BATCH_MAX_BYTES)) {
+    // The failed batch went to the retry queue; this packet queues behind it
+    if (!flushSession(*session, target)) {
+      return false;
+    }
+  }
+  
+  if (session->packets == 0) {
+    session->firstQueuedAt = millis();
+  }
+  appendPacketLine(session->body, packet);
+  session->hashes[session->packets++] = packet.hash;
+  
+  if (session->packets >= HTTP_BATCH_MAX_PACKETS) {
+    flushSession(*session, target);
+  }
+  return true;
+}
+
+// Called every loop(): flushes batches that have waited long enough
+void serviceHttpSessions() {
+  unsigned long now = millis();
+  
+  for (size_t i = 0; i < HTTP_MAX_SESSIONS; i++) {
+    HttpSession& session = sessions[i];
+    if (!session.used || session.packets == 0) continue;
+    if (now - session.firstQueuedAt < HTTP_BATCH_MAX_AGE) continue;
+    
+    for (auto& target : forwardTargets) {
+      if (strncmp(session.target, target.name.c_str(), MAX_TARGET_NAME_LENGTH - 1) != 0) continue;
+      if (target.enabled && isTargetAvailable(target)) {
+        flushSession(session, target);
+      } else {
+        // Disabled or breaker open meanwhile: wait in the retry queue instead
+        giveUpBatch(session, target);
+      }
+      break;
+    }
+  }
+}
+
+void closeHttpSession(const ForwardTarget& target) {
+  HttpSession* session = findSession(target.name, false);
+  if (session == NULL) return;
+  
+  if (session->begun) {
+    session->http.end();
+  }
+  session->body = "";
+  session->used = false;
+}
+
+bool getHttpSessionStats(const ForwardTarget& target, HttpSessionStats& stats) {
+  HttpSession* session = findSession(target.name, false);
+  if (session == NULL) return false;
+  
+  stats = session->stats;
+  stats.pendingPackets = session->packets;
+  
+  unsigned long elapsed = session->firstRequestAt > 0 ? millis() - session->firstRequestAt : 0;
+  stats.requestsPerSecond = elapsed > 0 ? stats.requests * 1000.0 / elapsed : 0;
+  uint32_t succeeded = stats.requests - stats.failures;
+  stats.packetsPerRequest = succeeded > 0 ? (float)stats.packets / succeeded : 0;
+  
+  // Percentiles over the recent window, on a copy so the ring keeps its order
+  uint32_t sorted[HTTP_LATENCY_SAMPLES];
+  size_t count = session->latencyCount;
+  memcpy(sorted, session->latencies, count * sizeof(uint32_t));
+  std::sort(sorted, sorted + count);
+  stats.p50LatencyMs = count > 0 ? sorted[(count - 1) / 2] : 0;
+  stats.p99LatencyMs = count > 0 ? sorted[(count - 1) * 99 / 100] : 0;
+  return true;
+}
+
+void printHttpSessionStats() {
+  for (const auto& target : forwardTargets) {
+    HttpSessionStats stats;
+    if (!getHttpSessionStats(target, stats)) continue;
+    
+    Serial.printf("HTTP %s: %u req (%.2f/s), %u failed, %.1f packets/req, "
+                  "p50 %u ms, p99 %u ms, %u connects, %u pending\n",
+                  target.name.c_str(), stats.requests, stats.requestsPerSecond, stats.failures,
+                  stats.packetsPerRequest, stats.p50LatencyMs, stats.p99LatencyMs,
+                  stats.connects, stats.pendingPackets);
+  }
+}
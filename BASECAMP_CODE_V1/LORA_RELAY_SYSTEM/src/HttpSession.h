@@ -0,0 +1,42 @@
+#pragma once
+#ifndef HTTP_SESSION_H
+#define HTTP_SESSION_H
+
+#include "Common.h"
+
+// === HTTP SESSIONS ===
+// One keep-alive connection per HTTP target. Packets are appended to the
+// target's batch as NDJSON lines (one JSON object per line) and POSTed
+// together once the batch is big enough or old enough. Packets in a batch
+// are held apart from the retry queue and count as delivered once the POST
+// succeeds; if it fails they move into the retry queue, which resends
+// them with its backoff, and the batch starts empty.
+
+#define HTTP_MAX_SESSIONS       4
+#define HTTP_BATCH_MAX_BYTES    4096   // Body size that triggers a flush
+#define HTTP_BATCH_MAX_PACKETS  8      // Half of RETRY_HELD_SIZE, so two batches fit at once
+#define HTTP_BATCH_MAX_AGE      2000   // ms the first packet may wait in a batch
+#define HTTP_TIMEOUT            5000   // ms per request
+#define HTTP_LATENCY_SAMPLES    64     // Recent POSTs kept for percentiles
+
+struct HttpSessionStats {
+  uint32_t requests;
+  uint32_t failures;
+  uint32_t packets;          // Packets in successful POSTs
+  uint32_t bytes;
+  uint32_t connects;         // Requests that had to open a new connection
+  float requestsPerSecond;   // Since the first request
+  float packetsPerRequest;
+  uint32_t p50LatencyMs;
+  uint32_t p99LatencyMs;
+  size_t pendingPackets;
+};
+
+// === SESSION FUNCTIONS ===
+bool httpSessionAppend(const RelayPacket& packet, const ForwardTarget& target);
+void serviceHttpSessions();
+void closeHttpSession(const ForwardTarget& target);
+bool getHttpSessionStats(const ForwardTarget& target, HttpSessionStats& stats);
+void printHttpSessionStats();
+
+#endif // HTTP_SESSION_H
@@ -1,15 +1,12 @@
 #include "LoRa_Relay.h"
+#include "Forwarder.h"
+#include "PacketHistory.h"
+#include "Metrics.h"
+#include "Routing.h"
 
-// Global variables definition
+// Global variables definition (relay statistics live in Common.cpp)
 String loraStatus = "Initializing";
 bool loraInitialized = false;
-std::vector<PacketInfo> packetHistory;
-std::map<String, unsigned long> packetHashes;
-unsigned long lastCleanup = 0;
-int totalReceived = 0;
-int totalForwarded = 0;
-int totalDuplicates = 0;
-String lastReceivedFrom = "None";
 
 // Hardware reset function
 void resetLoRaHardware() {
@@ -147,152 +144,164 @@ bool initializeLoRaRelay(int syncWord) {
   return false;
 }
 
-String generatePacketHash(const String& packet, const String& nodeId) {
-  // Simple hash based on packet content + node ID + time window
-  // Time window ensures same packet from same node within 1 minute is considered duplicate
-  unsigned long timeWindow = millis() / PACKET_DUPLICATE_WINDOW;
-  
-  String hashInput = packet + nodeId + String(timeWindow);
-  
-  // Simple hash algorithm (could be improved with proper hash function)
-  unsigned long hash = 0;
-  for (int i = 0; i < hashInput.length(); i++) {
-    hash = hash * 31 + hashInput.charAt(i);
+// FNV-1a, 64 bit: cheap on the ESP32 and wide enough that unrelated packets
+// practically never collide within the duplicate window
+static uint64_t fnv1a(uint64_t hash, const char* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 0x100000001B3ULL;
   }
-  
-  return String(hash, HEX);
+  return hash;
 }
 
-bool isPacketDuplicate(const String& packet, const String& nodeId) {
-  String hash = generatePacketHash(packet, nodeId);
-  
-  // Check if this hash exists in recent history
-  if (packetHashes.find(hash) != packetHashes.end()) {
-    // Check if the duplicate is within our detection window
-    unsigned long lastSeen = packetHashes[hash];
-    if (millis() - lastSeen < PACKET_DUPLICATE_WINDOW) {
-      totalDuplicates++;
-      Serial.print("Duplicate packet detected from ");
-      Serial.print(nodeId);
-      Serial.print(" (hash: ");
-      Serial.print(hash);
-      Serial.println(")");
-      return true;
+uint64_t hashRelayPacket(const char* nodeId, const char* data, size_t length) {
+  uint64_t hash = fnv1a(0xCBF29CE484222325ULL, nodeId, strlen(nodeId));
+  return fnv1a(hash, data, length);
+}
+
+// Find a top-level "key": value pair in a flat JSON object without building
+// a document. String values are returned without their quotes.
+bool findJsonField(const char* data, size_t length, const char* key,
+                   const char*& value, size_t& valueLength) {
+  size_t keyLength = strlen(key);
+  const char* end = data + length;
+  
+  for (const char* p = data; p + keyLength + 2 < end; p++) {
+    if (*p != '"' || p[keyLength + 1] != '"' || memcmp(p + 1, key, keyLength) != 0) {
+      continue;
+    }
+    
+    const char* cursor = p + keyLength + 2;
+    while (cursor < end && isspace((unsigned char)*cursor)) cursor++;
+    if (cursor >= end || *cursor != ':') continue;  // A value that happens to match the key
+    cursor++;
+    while (cursor < end && isspace((unsigned char)*cursor)) cursor++;
+    if (cursor >= end) return false;
+    
+    if (*cursor == '"') {
+      value = ++cursor;
+      while (cursor < end && *cursor != '"') {
+        if (*cursor == '\\') cursor++;
+        cursor++;
+      }
+      if (cursor >= end) return false;
+    } else {
+      value = cursor;
+      while (cursor < end && *cursor != ',' && *cursor != '}' && !isspace((unsigned char)*cursor)) cursor++;
     }
+    valueLength = cursor - value;
+    return true;
   }
-  
-  // Not a duplicate, add to hash map
-  packetHashes[hash] = millis();
   return false;
 }
 
-void addToPacketHistory(const String& packet, const String& nodeId, int rssi) {
-  PacketInfo info;
-  info.packetHash = generatePacketHash(packet, nodeId);
-  info.nodeId = nodeId;
-  info.timestamp = millis();
-  info.rssi = rssi;
-  info.data = packet;
-  info.forwarded = false;
-  info.forwardAttempts = 0;
-  
-  packetHistory.push_back(info);
-  
-  // Limit history size
-  if (packetHistory.size() > MAX_PACKET_HISTORY) {
-    packetHistory.erase(packetHistory.begin());
+bool decodeRelayPacket(const char* data, size_t length, int rssi, float snr, RelayPacket& packet) {
+  packet.data = data;
+  packet.length = length;
+  packet.rssi = rssi;
+  packet.snr = snr;
+  packet.receivedAt = millis();
+  packet.sequence = -1;
+  packet.hops = 0;
+  packet.isJson = length >= 2 && data[0] == '{' && data[length - 1] == '}';
+  
+  // Same key fallbacks the JSON based lookup used
+  const char* value = NULL;
+  size_t valueLength = 0;
+  bool found = packet.isJson &&
+               (findJsonField(data, length, "node_id", value, valueLength) ||
+                findJsonField(data, length, "nodeId", value, valueLength) ||
+                findJsonField(data, length, "id", value, valueLength));
+  
+  if (found && valueLength > 0) {
+    valueLength = min(valueLength, (size_t)MAX_NODE_ID_LENGTH - 1);
+    memcpy(packet.nodeId, value, valueLength);
+    packet.nodeId[valueLength] = '\0';
+  } else {
+    strcpy(packet.nodeId, "UNKNOWN");
+    found = false;
   }
-}
-
-void cleanupPacketHistory() {
-  unsigned long currentTime = millis();
   
-  // Remove old entries from packet hashes
-  auto it = packetHashes.begin();
-  while (it != packetHashes.end()) {
-    if (currentTime - it->second > PACKET_DUPLICATE_WINDOW * 2) {
-      it = packetHashes.erase(it);
-    } else {
-      ++it;
-    }
+  if (packet.isJson && findJsonField(data, length, "seq", value, valueLength)) {
+    packet.sequence = strtol(value, NULL, 10);
   }
   
-  // Remove old entries from packet history
-  auto histIt = packetHistory.begin();
-  while (histIt != packetHistory.end()) {
-    if (currentTime - histIt->timestamp > PACKET_CLEANUP_INTERVAL) {
-      histIt = packetHistory.erase(histIt);
-    } else {
-      ++histIt;
+  // Kind and SOS flag, matched by the forward rules
+  packet.kind = PACKET_TELEMETRY;
+  packet.sos = false;
+  if (packet.isJson) {
+    if (findJsonField(data, length, "type", value, valueLength)) {
+      if (valueLength == 3 && strncasecmp(value, "sos", 3) == 0) {
+        packet.kind = PACKET_SOS;
+      } else if (valueLength == 8 && strncasecmp(value, "position", 8) == 0) {
+        packet.kind = PACKET_POSITION;
+      }
+    } else if (findJsonField(data, length, "latitude", value, valueLength) ||
+               findJsonField(data, length, "lat", value, valueLength)) {
+      packet.kind = PACKET_POSITION;
     }
+    packet.sos = packet.kind == PACKET_SOS ||
+                 (findJsonField(data, length, "sos_status", value, valueLength) &&
+                  ((valueLength == 4 && memcmp(value, "true", 4) == 0) || (valueLength == 1 && *value == '1')));
   }
   
-  lastCleanup = currentTime;
-  Serial.println("Cleaned up packet history and hash cache");
+  packet.hash = hashRelayPacket(packet.nodeId, data, length);
+  return found;
 }
 
-JsonDocument parseLoRaPacket(const String& packet) {
-  JsonDocument doc;
-  DeserializationError error = deserializeJson(doc, packet);
-  
-  if (error) {
-    Serial.print("JSON parse error: ");
-    Serial.println(error.c_str());
+bool isPacketDuplicate(const RelayPacket& packet) {
+  // Judged by age alone, so repeats straddling a window boundary are caught
+  if (dedupTable.checkAndInsert(packet.hash, packet.receivedAt)) {
+    totalDuplicates++;
+    Serial.printf("Duplicate packet detected from %s (hash: %08lx%08lx)\n", packet.nodeId,
+                  (unsigned long)(packet.hash >> 32), (unsigned long)packet.hash);
+    return true;
   }
-  
-  return doc;
+  return false;
 }
 
-bool extractNodeId(const String& packet, String& nodeId) {
-  JsonDocument doc = parseLoRaPacket(packet);
-  
-  if (doc.containsKey("node_id")) {
-    nodeId = doc["node_id"].as<String>();
-    return true;
-  }
-  
-  // Fallback: try to extract from different possible keys
-  if (doc.containsKey("nodeId")) {
-    nodeId = doc["nodeId"].as<String>();
-    return true;
-  }
+HistoryRecord& addToPacketHistory(const RelayPacket& packet) {
+  // The ring evicts the oldest record itself when it or the slab is full
+  return historyAppend(packet);
+}
+
+void cleanupPacketHistory() {
+  unsigned long currentTime = millis();
   
-  if (doc.containsKey("id")) {
-    nodeId = doc["id"].as<String>();
-    return true;
-  }
+  // Remove old entries from packet history
+  historyExpire(currentTime, PACKET_CLEANUP_INTERVAL);
   
-  // If no ID found, use "UNKNOWN"
-  nodeId = "UNKNOWN";
-  return false;
+  lastCleanup = currentTime;
+  Serial.println("Cleaned up packet history");
 }
 
-void processReceivedPacket(const String& packet, int rssi) {
+void processReceivedPacket(const RelayPacket& packet) {
   totalReceived++;
-  
-  String nodeId;
-  extractNodeId(packet, nodeId);
-  lastReceivedFrom = nodeId;
+  lastReceivedFrom = packet.nodeId;
   
   Serial.println("=== Received LoRa Packet ===");
   Serial.print("From: ");
-  Serial.println(nodeId);
+  Serial.println(packet.nodeId);
   Serial.print("RSSI: ");
-  Serial.println(rssi);
+  Serial.print(packet.rssi);
+  Serial.print(" dBm, SNR: ");
+  Serial.print(packet.snr, 1);
+  Serial.println(" dB");
+  metricsObserveReceive(packet);
   Serial.print("Data: ");
-  Serial.println(packet);
+  Serial.write((const uint8_t*)packet.data, packet.length);
+  Serial.println();
   
   // Check for duplicates
-  if (isPacketDuplicate(packet, nodeId)) {
+  if (isPacketDuplicate(packet)) {
     Serial.println("Packet marked as duplicate, skipping forward");
     return;
   }
   
-  // Add to history
-  addToPacketHistory(packet, nodeId, rssi);
-  
-  // Forward packet (will be implemented in forwarding module)
-  Serial.println("Packet ready for forwarding");
+  // Add to history, then hand the same descriptor to the forwarders
+  HistoryRecord& record = addToPacketHistory(packet);
+  record.forwarded = forwardPacket(packet);
+  record.forwardAttempts = 1;
   Serial.println("========================");
 }
 
@@ -303,15 +312,35 @@ void handleIncomingLoRaPackets() {
   
   int packetSize = LoRa.parsePacket();
   if (packetSize) {
-    String packet = "";
+    uint32_t start = micros();
+    
+    // Read straight into a fixed buffer; the descriptor points into it
+    static char buffer[MAX_LORA_PACKET_SIZE + 1];
+    size_t length = 0;
     while (LoRa.available()) {
-      packet += (char)LoRa.read();
+      int c = LoRa.read();
+      if (length < MAX_LORA_PACKET_SIZE) {
+        buffer[length++] = (char)c;
+      }
     }
+    buffer[length] = '\0';
     
-    int rssi = LoRa.packetRssi();
-    processReceivedPacket(packet, rssi);
+    // Route beacons and frames for other relays stop here; a frame for
+    // us continues with its payload as the packet
+    RelayPacket packet;
+    RoutingResult routing = handleRoutingFrame(buffer, length, LoRa.packetRssi(), LoRa.packetSnr(), packet);
+    if (routing == ROUTING_NONE) {
+      decodeRelayPacket(buffer, length, LoRa.packetRssi(), LoRa.packetSnr(), packet);
+    }
+    if (routing != ROUTING_CONSUMED) {
+      processReceivedPacket(packet);
+    }
+    metricsObservePipeline(micros() - start);
     
     loraStatus = "Received";
+  } else {
+    // Quiet loop, keep aging the dedup table so it stays sparse
+    dedupTable.age(millis(), DEDUP_AGING_STEP);
   }
   
   // Periodic cleanup
@@ -385,8 +414,8 @@ void resetStatistics() {
   totalReceived = 0;
   totalForwarded = 0;
   totalDuplicates = 0;
-  packetHistory.clear();
-  packetHashes.clear();
+  historyClear();
+  dedupTable.clear();
   lastReceivedFrom = "None";
   Serial.println("Relay statistics reset");
 }
@@ -401,9 +430,12 @@ void printRelayStatistics() {
   Serial.println(totalDuplicates);
   Serial.print("Last Received From: ");
   Serial.println(lastReceivedFrom);
-  Serial.print("History Size: ");
-  Serial.println(packetHistory.size());
-  Serial.print("Hash Cache Size: ");
-  Serial.println(packetHashes.size());
+  HistoryStats history = getHistoryStats();
+  Serial.printf("History: %u/%u records, %u nodes, %u/%u payload bytes, %u evicted early\n",
+                history.records, MAX_PACKET_HISTORY, history.nodes,
+                history.slabUsed, HISTORY_SLAB_SIZE, history.evictions);
+  DedupStats dedup = dedupTable.getStats();
+  Serial.printf("Dedup Table: %u/%u entries, longest probe %u, evictions %u\n",
+                dedup.entries, DEDUP_TABLE_SIZE, dedup.maxProbe, dedup.evictions);
   Serial.println("===========================");
 }
\ No newline at end of file
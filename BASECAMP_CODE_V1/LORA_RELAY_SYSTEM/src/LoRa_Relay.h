@@ -3,22 +3,24 @@
 #define LORA_RELAY_H
 
 #include "Common.h"
+#include "PacketHistory.h"
 
 // === LORA RELAY FUNCTIONS ===
 bool initializeLoRaRelay(int syncWord = 0xF3);
 void handleIncomingLoRaPackets();
-bool isPacketDuplicate(const String& packet, const String& nodeId);
-String generatePacketHash(const String& packet, const String& nodeId);
-void addToPacketHistory(const String& packet, const String& nodeId, int rssi);
+bool isPacketDuplicate(const RelayPacket& packet);
+uint64_t hashRelayPacket(const char* nodeId, const char* data, size_t length);
+HistoryRecord& addToPacketHistory(const RelayPacket& packet);
 void cleanupPacketHistory();
 bool attemptLoRaRecovery(int syncWord = 0xF3);
 void setLoRaRelayStatus(const String& status);
 String getLoRaRelayStatus();
 
 // === PACKET PROCESSING ===
-JsonDocument parseLoRaPacket(const String& packet);
-bool extractNodeId(const String& packet, String& nodeId);
-void processReceivedPacket(const String& packet, int rssi);
+bool findJsonField(const char* data, size_t length, const char* key,
+                   const char*& value, size_t& valueLength);
+bool decodeRelayPacket(const char* data, size_t length, int rssi, float snr, RelayPacket& packet);
+void processReceivedPacket(const RelayPacket& packet);
 
 // === STATISTICS ===
 int getTotalReceivedPackets();
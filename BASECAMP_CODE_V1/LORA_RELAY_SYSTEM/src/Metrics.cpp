@@ -0,0 +1,309 @@
+#include "Metrics.h"
+#include "RetryQueue.h"
+#include "Routing.h"
+#include <esp_heap_caps.h>
+
+// Bucket bounds; all exported as base Prometheus units
+static const int32_t LATENCY_BOUNDS_US[] = {
+  100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 5000000
+};
+static const int32_t LOOP_BOUNDS_US[] = {
+  50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 500000
+};
+static const int32_t RSSI_BOUNDS_DBM[] = {
+  -125, -120, -115, -110, -105, -100, -95, -90, -80, -70, -60, -50
+};
+static const int32_t SNR_BOUNDS_QUARTER_DB[] = {   // -20 dB .. +12 dB
+  -80, -60, -40, -30, -20, -10, 0, 10, 20, 30, 40, 48
+};
+
+#define BOUNDS(bounds) bounds, sizeof(bounds) / sizeof(bounds[0])
+
+static MetricHistogram pipelineLatency(BOUNDS(LATENCY_BOUNDS_US), 1e-6);
+static MetricHistogram loopTime(BOUNDS(LOOP_BOUNDS_US), 1e-6);
+static MetricHistogram packetRssi(BOUNDS(RSSI_BOUNDS_DBM), 1);
+static MetricHistogram packetSnr(BOUNDS(SNR_BOUNDS_QUARTER_DB), 0.25);
+static MetricSum stageTime[STAGE_COUNT];
+static const char* STAGE_NAMES[STAGE_COUNT] = {"wifi", "lora", "retry", "sessions", "display"};
+
+// Per target, keyed by name: a series stays with its target when another
+// target is removed and the list shifts
+struct TargetMetrics {
+  char name[MAX_TARGET_NAME_LENGTH];   // Empty while the slot is unused
+  std::atomic<bool> live;              // Target still configured, sampled
+  MetricHistogram latency;
+  MetricCounter succeeded;
+  MetricCounter failed;
+  MetricCounter queueDepth;     // Gauge, sampled
+  
+  TargetMetrics() : live(false), latency(BOUNDS(LATENCY_BOUNDS_US), 1e-6) { name[0] = '\0'; }
+};
+
+static TargetMetrics targetMetrics[METRICS_MAX_TARGETS];
+
+// Sampled gauges
+static MetricCounter retryQueued;
+static MetricCounter dedupLookups;
+static MetricCounter dedupHits;
+static MetricCounter dedupEntries;
+
+void MetricSum::add(uint32_t amount) {
+  uint32_t started = sequence.load(std::memory_order_relaxed) + 1;
+  sequence.store(started, std::memory_order_relaxed);
+  // Odd sequence visible before either half changes
+  std::atomic_thread_fence(std::memory_order_release);
+  
+  uint32_t before = low.load(std::memory_order_relaxed);
+  uint32_t after = before + amount;
+  if (after < before) {
+    high.store(high.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+  low.store(after, std::memory_order_relaxed);
+  
+  sequence.store(started + 1, std::memory_order_release);
+}
+
+void MetricSum::reset() {
+  uint32_t started = sequence.load(std::memory_order_relaxed) + 1;
+  sequence.store(started, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  low.store(0, std::memory_order_relaxed);
+  high.store(0, std::memory_order_relaxed);
+  sequence.store(started + 1, std::memory_order_release);
+}
+
+uint64_t MetricSum::get() const {
+  uint32_t before, after, lowValue, highValue;
+  do {
+    before = sequence.load(std::memory_order_acquire);
+    lowValue = low.load(std::memory_order_relaxed);
+    highValue = high.load(std::memory_order_relaxed);
+    // Both halves read before the sequence is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = sequence.load(std::memory_order_relaxed);
+  } while ((before & 1) || before != after);
+  return ((uint64_t)highValue << 32) | lowValue;
+}
+
+MetricHistogram::MetricHistogram(const int32_t* bounds, uint8_t boundCount, float scale)
+  : bounds(bounds), boundCount(min(boundCount, (uint8_t)METRICS_MAX_BUCKETS)), scale(scale),
+    offset(bounds[0] < 0 ? -2 * bounds[0] : 0) {
+}
+
+void MetricHistogram::observe(int32_t value) {
+  uint8_t bucket = 0;
+  while (bucket < boundCount && value > bounds[bucket]) {
+    bucket++;
+  }
+  buckets[bucket].add();
+  count.add();
+  // Signed values (RSSI, SNR) are offset so the sum stays unsigned
+  sum.add((uint32_t)max(value + offset, (int32_t)0));
+}
+
+void MetricHistogram::reset() {
+  for (uint8_t i = 0; i <= boundCount; i++) {
+    buckets[i].value.store(0, std::memory_order_relaxed);
+  }
+  count.value.store(0, std::memory_order_relaxed);
+  sum.reset();
+}
+
+void MetricHistogram::render(Print& out, const char* name, const char* labels) const {
+  const char* separator = labels[0] != '\0' ? "," : "";
+  uint32_t cumulative = 0;
+  
+  for (uint8_t i = 0; i < boundCount; i++) {
+    cumulative += buckets[i].get();
+    out.printf("%s_bucket{%s%sle=\"%g\"} %u\n", name, labels, separator, bounds[i] * scale, cumulative);
+  }
+  // From the same bucket reads, so +Inf and _count never fall below the
+  // last finite bucket while the loop task keeps observing
+  uint32_t total = cumulative + buckets[boundCount].get();
+  out.printf("%s_bucket{%s%sle=\"+Inf\"} %u\n", name, labels, separator, total);
+  
+  // Undo the offset added per observation
+  double rawSum = (double)sum.get() - (double)total * offset;
+  if (labels[0] != '\0') {
+    out.printf("%s_sum{%s} %.6f\n", name, labels, rawSum * scale);
+    out.printf("%s_count{%s} %u\n", name, labels, total);
+  } else {
+    out.printf("%s_sum %.6f\n", name, rawSum * scale);
+    out.printf("%s_count %u\n", name, total);
+  }
+}
+
+void metricsObserveReceive(const RelayPacket& packet) {
+  packetRssi.observe(packet.rssi);
+  packetSnr.observe((int32_t)lroundf(packet.snr * 4));
+}
+
+void metricsObservePipeline(uint32_t micros) {
+  pipelineLatency.observe(micros);
+}
+
+static bool isConfigured(const char* name) {
+  for (const auto& target : forwardTargets) {
+    if (strncmp(target.name.c_str(), name, MAX_TARGET_NAME_LENGTH - 1) == 0) return true;
+  }
+  return false;
+}
+
+// The target's slot; a new name takes an unused slot or one whose target
+// is gone, starting its series from zero
+static TargetMetrics* metricsFor(const ForwardTarget& target) {
+  const char* name = target.name.c_str();
+  for (auto& metrics : targetMetrics) {
+    if (metrics.name[0] != '\0' && strncmp(metrics.name, name, MAX_TARGET_NAME_LENGTH - 1) == 0) {
+      return &metrics;
+    }
+  }
+  
+  for (auto& metrics : targetMetrics) {
+    if (metrics.name[0] != '\0' && isConfigured(metrics.name)) continue;
+    
+    metrics.live.store(false, std::memory_order_relaxed);
+    metrics.latency.reset();
+    metrics.succeeded.value.store(0, std::memory_order_relaxed);
+    metrics.failed.value.store(0, std::memory_order_relaxed);
+    metrics.queueDepth.value.store(0, std::memory_order_relaxed);
+    strncpy(metrics.name, name, MAX_TARGET_NAME_LENGTH - 1);
+    metrics.name[MAX_TARGET_NAME_LENGTH - 1] = '\0';
+    return &metrics;
+  }
+  return NULL;
+}
+
+void metricsObserveForward(const ForwardTarget& target, uint32_t micros) {
+  TargetMetrics* metrics = metricsFor(target);
+  if (metrics == NULL) return;
+  
+  metrics->latency.observe(micros);
+}
+
+// Batched targets count their packets when the batch goes out, not when
+// a packet joins it
+void metricsCountForward(const ForwardTarget& target, bool delivered, uint32_t packets) {
+  TargetMetrics* metrics = metricsFor(target);
+  if (metrics == NULL) return;
+  
+  if (delivered) {
+    metrics->succeeded.add(packets);
+  } else {
+    metrics->failed.add(packets);
+  }
+}
+
+void metricsObserveLoop(uint32_t micros) {
+  loopTime.observe(micros);
+}
+
+void metricsAddStageTime(MetricStage stage, uint32_t micros) {
+  stageTime[stage].add(micros);
+}
+
+// Called every loop(); samples the gauges that cost more than a store
+void updateMetrics() {
+  static unsigned long lastSample = 0;
+  if (millis() - lastSample < METRICS_SAMPLE_INTERVAL) return;
+  lastSample = millis();
+  
+  // Removed targets stop being rendered; their slot is reused by the next new name
+  bool live[METRICS_MAX_TARGETS] = {};
+  for (const auto& target : forwardTargets) {
+    TargetMetrics* metrics = metricsFor(target);
+    if (metrics == NULL) continue;
+    
+    live[metrics - targetMetrics] = true;
+    metrics->queueDepth.value.store(retryDepth(target), std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < METRICS_MAX_TARGETS; i++) {
+    targetMetrics[i].live.store(live[i], std::memory_order_relaxed);
+  }
+  
+  retryQueued.value.store(getRetryStats().queued, std::memory_order_relaxed);
+  DedupStats dedup = dedupTable.getStats();
+  dedupLookups.value.store(dedup.lookups, std::memory_order_relaxed);
+  dedupHits.value.store(dedup.duplicates, std::memory_order_relaxed);
+  dedupEntries.value.store(dedup.entries, std::memory_order_relaxed);
+}
+
+static void renderHeader(Print& out, const char* name, const char* type, const char* help) {
+  out.printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void renderValue(Print& out, const char* name, const char* type, const char* help, double value) {
+  renderHeader(out, name, type, help);
+  out.printf("%s %.0f\n", name, value);
+}
+
+void handleMetrics(AsyncWebServerRequest *request) {
+  AsyncResponseStream* response = request->beginResponseStream("text/plain; version=0.0.4");
+  Print& out = *response;
+  
+  renderValue(out, "relay_uptime_seconds", "gauge", "Time since boot", millis() / 1000);
+  renderValue(out, "relay_packets_received_total", "counter", "LoRa packets received", totalReceived);
+  renderValue(out, "relay_packets_forwarded_total", "counter",
+              "Packets delivered to at least one target", totalForwarded);
+  renderValue(out, "relay_packets_duplicate_total", "counter", "Packets dropped as duplicates", totalDuplicates);
+  
+  renderValue(out, "relay_dedup_lookups_total", "counter", "Dedup table lookups", dedupLookups.get());
+  renderValue(out, "relay_dedup_hits_total", "counter", "Dedup table lookups that found a duplicate",
+              dedupHits.get());
+  renderValue(out, "relay_dedup_entries", "gauge", "Live dedup table entries", dedupEntries.get());
+  
+  renderHeader(out, "relay_receive_to_forward_seconds", "histogram",
+               "Time from reading a packet off the radio until every target was tried");
+  pipelineLatency.render(out, "relay_receive_to_forward_seconds", "");
+  renderHeader(out, "relay_packet_rssi_dbm", "histogram", "RSSI of received packets");
+  packetRssi.render(out, "relay_packet_rssi_dbm", "");
+  renderHeader(out, "relay_packet_snr_db", "histogram", "SNR of received packets");
+  packetSnr.render(out, "relay_packet_snr_db", "");
+  
+  char labels[MAX_TARGET_NAME_LENGTH + 32];
+  renderHeader(out, "relay_forward_seconds", "histogram",
+               "Time to hand a packet to a target (HTTP and TCP/UDP only buffer it)");
+  for (const auto& metrics : targetMetrics) {
+    if (!metrics.live.load(std::memory_order_relaxed)) continue;
+    snprintf(labels, sizeof(labels), "target=\"%s\"", metrics.name);
+    metrics.latency.render(out, "relay_forward_seconds", labels);
+  }
+  renderHeader(out, "relay_forward_total", "counter",
+               "Packets delivered (ok) or refused (failed) by target; batched packets count once sent");
+  for (const auto& metrics : targetMetrics) {
+    if (!metrics.live.load(std::memory_order_relaxed)) continue;
+    out.printf("relay_forward_total{target=\"%s\",result=\"ok\"} %u\n",
+               metrics.name, metrics.succeeded.get());
+    out.printf("relay_forward_total{target=\"%s\",result=\"failed\"} %u\n",
+               metrics.name, metrics.failed.get());
+  }
+  renderHeader(out, "relay_retry_queue_depth", "gauge", "Packets waiting in the retry queue by target");
+  for (const auto& metrics : targetMetrics) {
+    if (!metrics.live.load(std::memory_order_relaxed)) continue;
+    out.printf("relay_retry_queue_depth{target=\"%s\"} %u\n",
+               metrics.name, metrics.queueDepth.get());
+  }
+  renderValue(out, "relay_retry_queue_packets", "gauge", "Packets in the retry pool", retryQueued.get());
+  
+  RoutingStats routing = getRoutingStats();
+  renderValue(out, "relay_routes", "gauge", "Basecamps with a live route", routing.routes);
+  renderValue(out, "relay_routed_frames_total", "counter", "Frames sent toward a basecamp", routing.framesSent);
+  renderValue(out, "relay_suppressed_total", "counter",
+              "Held packets dropped because a closer relay sent them", routing.suppressed);
+  renderHeader(out, "relay_lora_airtime_seconds_total", "counter", "LoRa transmit time, frames and beacons");
+  out.printf("relay_lora_airtime_seconds_total %.3f\n", routing.airtimeMs / 1000.0);
+  
+  renderValue(out, "relay_heap_free_bytes", "gauge", "Free heap", ESP.getFreeHeap());
+  renderValue(out, "relay_heap_min_free_bytes", "gauge", "Lowest free heap since boot", ESP.getMinFreeHeap());
+  renderValue(out, "relay_heap_largest_block_bytes", "gauge", "Largest allocatable heap block",
+              heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+  
+  renderHeader(out, "relay_loop_seconds", "histogram", "Duration of one loop() pass");
+  loopTime.render(out, "relay_loop_seconds", "");
+  renderHeader(out, "relay_stage_seconds_total", "counter", "Time spent in each loop() stage");
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    out.printf("relay_stage_seconds_total{stage=\"%s\"} %.6f\n", STAGE_NAMES[i], stageTime[i].get() / 1e6);
+  }
+  
+  request->send(response);
+}
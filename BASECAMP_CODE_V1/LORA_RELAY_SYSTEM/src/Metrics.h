@@ -0,0 +1,84 @@
+#pragma once
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "Common.h"
+#include <atomic>
+
+// === METRICS ===
+// Counters and fixed-bucket histograms rendered in Prometheus text format
+// on /metrics. Every update happens on the loop task, so an update is a
+// relaxed load/add/store with no lock; the web server task only reads.
+// Values that are expensive to get (queue depths, dedup stats) are sampled
+// into gauges once per METRICS_SAMPLE_INTERVAL instead of per packet.
+
+#define METRICS_MAX_BUCKETS     14
+#define METRICS_MAX_TARGETS     MAX_FORWARD_TARGETS   // Every target gets its series
+#define METRICS_SAMPLE_INTERVAL 1000   // ms
+
+// Only the loop task writes, so a plain read-modify-write cannot lose updates
+struct MetricCounter {
+  std::atomic<uint32_t> value;
+  
+  void add(uint32_t amount = 1) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+  uint32_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// 64-bit total for microsecond sums. The halves are two stores, so the
+// writer bumps `sequence` to odd before and even after them; readers retry
+// until they see the same even sequence on both sides of their loads.
+struct MetricSum {
+  std::atomic<uint32_t> sequence;
+  std::atomic<uint32_t> low;
+  std::atomic<uint32_t> high;
+  
+  void add(uint32_t amount);
+  void reset();
+  uint64_t get() const;
+};
+
+class MetricHistogram {
+public:
+  // `bounds` are ascending upper bounds in the observed unit; `scale`
+  // converts that unit to the exported one (e.g. 1e-6 for us -> s)
+  MetricHistogram(const int32_t* bounds, uint8_t boundCount, float scale);
+  
+  void observe(int32_t value);
+  void reset();
+  void render(Print& out, const char* name, const char* labels) const;
+  
+private:
+  const int32_t* bounds;
+  uint8_t boundCount;
+  float scale;
+  int32_t offset;                                   // Keeps signed values positive in the sum
+  MetricCounter buckets[METRICS_MAX_BUCKETS + 1];   // Last one is +Inf
+  MetricCounter count;
+  MetricSum sum;
+};
+
+// === METRIC HOOKS ===
+// Called from the pipeline; each is a bucket scan and a few stores
+void metricsObserveReceive(const RelayPacket& packet);
+void metricsObservePipeline(uint32_t micros);
+void metricsObserveForward(const ForwardTarget& target, uint32_t micros);
+void metricsCountForward(const ForwardTarget& target, bool delivered, uint32_t packets = 1);
+void metricsObserveLoop(uint32_t micros);
+
+enum MetricStage {
+  STAGE_WIFI,
+  STAGE_LORA,
+  STAGE_RETRY,
+  STAGE_SESSIONS,
+  STAGE_DISPLAY,
+  STAGE_COUNT
+};
+void metricsAddStageTime(MetricStage stage, uint32_t micros);
+
+// === METRICS FUNCTIONS ===
+void updateMetrics();
+void handleMetrics(AsyncWebServerRequest *request);
+
+#endif // METRICS_H
@@ -0,0 +1,178 @@
+#include "PacketHistory.h"
+
+struct HistoryNode {
+  char id[MAX_NODE_ID_LENGTH];
+  uint16_t references;     // Records pointing here; 0 means the slot is free
+};
+
+static HistoryRecord records[MAX_PACKET_HISTORY];
+static size_t oldest = 0;
+static size_t recordCount = 0;
+
+static char slab[HISTORY_SLAB_SIZE];
+static size_t slabHead = 0;       // Where the next payload goes
+static size_t slabUsed = 0;
+
+static HistoryNode nodes[HISTORY_MAX_NODES];
+static size_t nodeCount = 0;
+static uint32_t evictions = 0;
+
+static SemaphoreHandle_t historyMutex = NULL;
+static StaticSemaphore_t historyMutexBuffer;
+
+void initializePacketHistory() {
+  historyMutex = xSemaphoreCreateMutexStatic(&historyMutexBuffer);
+  historyClear();
+}
+
+void lockHistory() {
+  if (historyMutex != NULL) {
+    xSemaphoreTake(historyMutex, portMAX_DELAY);
+  }
+}
+
+void unlockHistory() {
+  if (historyMutex != NULL) {
+    xSemaphoreGive(historyMutex);
+  }
+}
+
+static uint8_t internNode(const char* id) {
+  size_t freeSlot = HISTORY_MAX_NODES;
+  for (size_t i = 0; i < HISTORY_MAX_NODES; i++) {
+    if (nodes[i].references == 0) {
+      if (freeSlot == HISTORY_MAX_NODES) freeSlot = i;
+      continue;
+    }
+    if (strcmp(nodes[i].id, id) == 0) {
+      nodes[i].references++;
+      return i;
+    }
+  }
+  
+  // More distinct senders than slots: record the packet without a name
+  if (freeSlot == HISTORY_MAX_NODES) return HISTORY_NO_NODE;
+  
+  strncpy(nodes[freeSlot].id, id, MAX_NODE_ID_LENGTH - 1);
+  nodes[freeSlot].id[MAX_NODE_ID_LENGTH - 1] = '\0';
+  nodes[freeSlot].references = 1;
+  nodeCount++;
+  return freeSlot;
+}
+
+static void releaseNode(uint8_t node) {
+  if (node == HISTORY_NO_NODE) return;
+  if (--nodes[node].references == 0) {
+    nodeCount--;
+  }
+}
+
+static void evictOldest() {
+  HistoryRecord& record = records[oldest];
+  releaseNode(record.node);
+  slabUsed -= record.length;
+  oldest = (oldest + 1) % MAX_PACKET_HISTORY;
+  recordCount--;
+}
+
+// Contiguous space for `length` bytes, evicting the oldest records in
+// arrival order until it fits. Payloads never wrap, so readers get a
+// plain pointer; the unused tail before a wrap is simply skipped.
+static size_t reserveSlab(size_t length) {
+  for (;;) {
+    if (recordCount == 0) {
+      slabHead = 0;
+      return 0;
+    }
+    
+    size_t oldestOffset = records[oldest].offset;
+    if (slabHead > oldestOffset) {
+      // Live bytes are [oldestOffset, slabHead)
+      if (HISTORY_SLAB_SIZE - slabHead >= length) return slabHead;
+      if (oldestOffset >= length) return 0;
+    } else if (slabHead < oldestOffset) {
+      // Live bytes wrap: [oldestOffset, end) and [0, slabHead)
+      if (oldestOffset - slabHead >= length) return slabHead;
+    }
+    // slabHead == oldestOffset with records left means the slab is full
+    
+    evictOldest();
+    evictions++;
+  }
+}
+
+HistoryRecord& historyAppend(const RelayPacket& packet) {
+  lockHistory();
+  
+  if (recordCount == MAX_PACKET_HISTORY) {
+    evictOldest();
+    evictions++;
+  }
+  
+  size_t length = min(packet.length, (size_t)MAX_LORA_PACKET_SIZE);
+  size_t offset = reserveSlab(length);
+  memcpy(slab + offset, packet.data, length);
+  slabHead = offset + length;
+  slabUsed += length;
+  
+  HistoryRecord& record = records[(oldest + recordCount) % MAX_PACKET_HISTORY];
+  record.hash = packet.hash;
+  record.timestamp = packet.receivedAt;
+  record.offset = offset;
+  record.length = length;
+  record.node = internNode(packet.nodeId);
+  record.rssi = packet.rssi;
+  record.snrQuarterDb = constrain((int)roundf(packet.snr * 4), -128, 127);
+  record.forwardAttempts = 0;
+  record.forwarded = false;
+  recordCount++;
+  
+  unlockHistory();
+  return record;
+}
+
+// Records are in arrival order, so expiry only ever looks at the front
+void historyExpire(uint32_t now, uint32_t maxAge) {
+  lockHistory();
+  while (recordCount > 0 && now - records[oldest].timestamp > maxAge) {
+    evictOldest();
+  }
+  unlockHistory();
+}
+
+void historyClear() {
+  lockHistory();
+  oldest = 0;
+  recordCount = 0;
+  slabHead = 0;
+  slabUsed = 0;
+  memset(nodes, 0, sizeof(nodes));
+  nodeCount = 0;
+  evictions = 0;
+  unlockHistory();
+}
+
+size_t historySize() {
+  return recordCount;
+}
+
+const HistoryRecord& historyNewest(size_t age) {
+  return records[(oldest + recordCount - 1 - age) % MAX_PACKET_HISTORY];
+}
+
+const char* historyPayload(const HistoryRecord& record) {
+  return slab + record.offset;
+}
+
+const char* historyNodeId(const HistoryRecord& record) {
+  return record.node == HISTORY_NO_NODE ? "UNKNOWN" : nodes[record.node].id;
+}
+
+HistoryStats getHistoryStats() {
+  HistoryStats stats;
+  stats.records = recordCount;
+  stats.nodes = nodeCount;
+  stats.slabUsed = slabUsed;
+  stats.evictions = evictions;
+  return stats;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef PACKET_HISTORY_H
+#define PACKET_HISTORY_H
+
+#include "Common.h"
+
+// === PACKET HISTORY ===
+// Ring of fixed-size records. Node IDs are interned in a small table and
+// payloads live in a byte slab that is reused in arrival order, so both
+// insert and eviction are O(1) and the memory footprint is fixed at boot.
+// Readers get references into the ring; take lockHistory() around reads
+// from another task (the web server) so records are not evicted mid-use.
+
+#define HISTORY_SLAB_SIZE  24576  // Payload bytes kept across all records
+#define HISTORY_MAX_NODES  64     // Distinct node IDs referenced by the ring
+#define HISTORY_NO_NODE    0xFF
+
+struct HistoryRecord {
+  uint64_t hash;
+  uint32_t timestamp;
+  uint16_t offset;         // Payload position in the slab
+  uint8_t length;
+  uint8_t node;            // Index into the node table
+  int16_t rssi;
+  int8_t snrQuarterDb;     // SNR in 0.25 dB steps
+  uint8_t forwardAttempts : 7;
+  uint8_t forwarded : 1;
+};
+
+struct HistoryStats {
+  size_t records;
+  size_t nodes;
+  size_t slabUsed;         // Payload bytes held by live records
+  uint32_t evictions;      // Records dropped to make room, not by age
+};
+
+// === HISTORY FUNCTIONS ===
+void initializePacketHistory();
+HistoryRecord& historyAppend(const RelayPacket& packet);
+void historyExpire(uint32_t now, uint32_t maxAge);
+void historyClear();
+
+// === READ ACCESS (no copies) ===
+void lockHistory();
+void unlockHistory();
+size_t historySize();
+const HistoryRecord& historyNewest(size_t age);   // 0 = most recent
+const char* historyPayload(const HistoryRecord& record);
+const char* historyNodeId(const HistoryRecord& record);
+HistoryStats getHistoryStats();
+
+#endif // PACKET_HISTORY_H
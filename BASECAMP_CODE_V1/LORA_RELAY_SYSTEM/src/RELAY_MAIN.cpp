@@ -4,6 +4,13 @@
 #include "Common.h"
 #include "LoRa_Relay.h"
 #include "Forwarder.h"
+#include "HttpSession.h"
+#include "SocketSession.h"
+#include "Metrics.h"
+#include "StatusEvents.h"
+#include "Routing.h"
+#include "ForwardRules.h"
+#include "SerialConsole.h"
 #include "Display_Module.h"
 #include "WiFi_Config.h"
 
@@ -51,6 +58,9 @@ void setup() {
   Serial.print("Relay ID: ");
   Serial.println(relayId);
   
+  initializePacketHistory();
+  initializeRouting();
+  
   // Initialize display
   if (initializeDisplay()) {
     showSplashScreen();
@@ -106,35 +116,63 @@ void setup() {
   // Show initial statistics
   printRelayStatistics();
   printForwardTargets();
+  printForwardRules();
   
   displayMessage("System Ready!", 2000);
 }
 
 void loop() {
+  // Stage times feed /metrics
+  uint32_t loopStart = micros();
+  uint32_t stageStart = loopStart;
+  
   // Check configuration button
   checkConfigButton();
   
-  // Handle WiFi configuration
+  // Handle WiFi configuration and console commands
   handleWiFiConfig();
+  handleSerialConsole();
+  metricsAddStageTime(STAGE_WIFI, micros() - stageStart);
   
   // Handle incoming LoRa packets
+  stageStart = micros();
   handleIncomingLoRaPackets();
+  metricsAddStageTime(STAGE_LORA, micros() - stageStart);
+  
+  // Retry queued forwards as their backoff expires
+  stageStart = micros();
+  retryFailedForwards();
+  metricsAddStageTime(STAGE_RETRY, micros() - stageStart);
+  
+  // Send HTTP batches and TCP/UDP buffers that have waited long enough,
+  // held LoRa packets and route beacons
+  stageStart = micros();
+  serviceHttpSessions();
+  serviceSocketSessions();
+  serviceRouting();
+  metricsAddStageTime(STAGE_SESSIONS, micros() - stageStart);
+  updateMetrics();
   
-  // Process any retry forwards
   static unsigned long lastRetryCheck = 0;
   if (millis() - lastRetryCheck > 30000) { // Every 30 seconds
-    retryFailedForwards();
     checkTargetHealth();
     lastRetryCheck = millis();
   }
   
-  // Update display
+  // Update display and push status page events
+  stageStart = micros();
   updateRelayDisplay();
+  updateStatusEvents();
+  metricsAddStageTime(STAGE_DISPLAY, micros() - stageStart);
   
   // Print statistics periodically
   static unsigned long lastStatsReport = 0;
   if (millis() - lastStatsReport > 60000) { // Every minute
     printRelayStatistics();
+    printHttpSessionStats();
+    printSocketSessionStats();
+    printRoutingTable();
+    printForwardRules();
     lastStatsReport = millis();
   }
   
@@ -166,16 +204,17 @@ void loop() {
     lastLoRaRecovery = millis();
   }
   
+  metricsObserveLoop(micros() - loopStart);
   delay(100); // Small delay to prevent overwhelming the CPU
 }
 
 // Forward declaration for external access
 extern "C" void forwardPacketToRelay(String packet) {
   // This function can be called from other modules to forward packets
-  String nodeId;
-  if (extractNodeId(packet, nodeId)) {
-    if (!isPacketDuplicate(packet, nodeId)) {
-      forwardPacket(packet, nodeId);
+  RelayPacket descriptor;
+  if (decodeRelayPacket(packet.c_str(), packet.length(), 0, 0, descriptor)) {
+    if (!isPacketDuplicate(descriptor)) {
+      forwardPacket(descriptor);
     }
   }
 }
\ No newline at end of file
@@ -0,0 +1,332 @@
+#include "RetryQueue.h"
+
+// On-flash layout of one entry; the payload follows it
+struct __attribute__((packed)) PersistedRetry {
+  uint64_t hash;
+  int32_t sequence;
+  int16_t rssi;
+  int8_t snrQuarterDb;
+  uint8_t attempts;
+  uint8_t length;
+  uint8_t flags;                // bit 0: counted, bit 1: JSON payload, bits 2-5: hops, bit 6: SOS
+  uint8_t kind;                 // PacketKind
+  char target[MAX_TARGET_NAME_LENGTH];
+  char nodeId[MAX_NODE_ID_LENGTH];
+};
+
+#define RETRY_PERSIST_VERSION 2
+
+static RetryEntry pool[RETRY_POOL_SIZE];
+static RetryEntry held[RETRY_HELD_SIZE];     // Not persisted, not evicted
+static uint32_t nextOrder = 0;
+static RetryStats stats = {};
+static bool dirty = false;
+static unsigned long lastPersist = 0;
+
+static bool matchesTarget(const RetryEntry& entry, const char* name) {
+  return entry.used && strncmp(entry.target, name, MAX_TARGET_NAME_LENGTH - 1) == 0;
+}
+
+static RetryEntry* oldestEntry(const char* name) {
+  RetryEntry* oldest = NULL;
+  for (size_t i = 0; i < RETRY_POOL_SIZE; i++) {
+    RetryEntry& entry = pool[i];
+    if (!entry.used || (name != NULL && !matchesTarget(entry, name))) continue;
+    if (oldest == NULL || (int32_t)(entry.order - oldest->order) < 0) {
+      oldest = &entry;
+    }
+  }
+  return oldest;
+}
+
+static size_t depthOf(const char* name) {
+  size_t depth = 0;
+  for (size_t i = 0; i < RETRY_POOL_SIZE; i++) {
+    if (matchesTarget(pool[i], name)) depth++;
+  }
+  return depth;
+}
+
+static RetryEntry* allocateEntry(const char* name) {
+  // Per-target bound first, so one dead target cannot starve the others
+  if (depthOf(name) >= RETRY_MAX_PER_TARGET) {
+    retryRemove(oldestEntry(name));
+    stats.overflowDrops++;
+  }
+  
+  for (size_t i = 0; i < RETRY_POOL_SIZE; i++) {
+    if (!pool[i].used) return &pool[i];
+  }
+  
+  RetryEntry* victim = oldestEntry(NULL);
+  retryRemove(victim);
+  stats.overflowDrops++;
+  return victim;
+}
+
+static RetryEntry* storeEntry(const char* target, const char* nodeId, const char* data, size_t length) {
+  RetryEntry* entry = allocateEntry(target);
+  memset(entry, 0, offsetof(RetryEntry, data));
+  entry->used = true;
+  entry->order = nextOrder++;
+  strncpy(entry->target, target, MAX_TARGET_NAME_LENGTH - 1);
+  strncpy(entry->nodeId, nodeId, MAX_NODE_ID_LENGTH - 1);
+  entry->length = min(length, (size_t)MAX_LORA_PACKET_SIZE);
+  memcpy(entry->data, data, entry->length);
+  
+  stats.queued++;
+  stats.enqueued++;
+  dirty = true;
+  return entry;
+}
+
+RetryEntry* retryEnqueue(const ForwardTarget& target, const RelayPacket& packet, uint8_t attempts,
+                         unsigned long nextAttemptAt, bool counted) {
+  RetryEntry* entry = storeEntry(target.name.c_str(), packet.nodeId, packet.data, packet.length);
+  entry->counted = counted;
+  entry->isJson = packet.isJson;
+  entry->hops = packet.hops;
+  entry->kind = packet.kind;
+  entry->sos = packet.sos;
+  entry->attempts = attempts;
+  entry->rssi = packet.rssi;
+  entry->snr = packet.snr;
+  entry->hash = packet.hash;
+  entry->sequence = packet.sequence;
+  entry->nextAttemptAt = nextAttemptAt;
+  return entry;
+}
+
+RetryEntry* retryHead(const ForwardTarget& target) {
+  return oldestEntry(target.name.c_str());
+}
+
+void retryRemove(RetryEntry* entry) {
+  if (entry == NULL || !entry->used) return;
+  entry->used = false;
+  stats.queued--;
+  dirty = true;
+}
+
+void retryDropTarget(const ForwardTarget& target) {
+  for (size_t i = 0; i < RETRY_POOL_SIZE; i++) {
+    if (matchesTarget(pool[i], target.name.c_str())) {
+      retryRemove(&pool[i]);
+    }
+  }
+  for (size_t i = 0; i < RETRY_HELD_SIZE; i++) {
+    if (matchesTarget(held[i], target.name.c_str())) {
+      retryRelease(&held[i]);
+    }
+  }
+}
+
+// A packet delivered to one target must not be counted again by another.
+// Only flags the pool dirty when a persisted entry actually changes.
+void retryMarkCounted(uint64_t hash) {
+  for (size_t i = 0; i < RETRY_POOL_SIZE; i++) {
+    if (pool[i].used && pool[i].hash == hash && !pool[i].counted) {
+      pool[i].counted = true;
+      dirty = true;
+    }
+  }
+  for (size_t i = 0; i < RETRY_HELD_SIZE; i++) {
+    if (held[i].used && held[i].hash == hash) {
+      held[i].counted = true;
+    }
+  }
+}
+
+// Descriptor over the stored copy, valid while the entry stays queued
+RelayPacket retryPacket(const RetryEntry& entry) {
+  RelayPacket packet;
+  packet.data = entry.data;
+  packet.length = entry.length;
+  memcpy(packet.nodeId, entry.nodeId, MAX_NODE_ID_LENGTH);
+  packet.sequence = entry.sequence;
+  packet.rssi = entry.rssi;
+  packet.snr = entry.snr;
+  packet.hash = entry.hash;
+  packet.receivedAt = millis();
+  packet.isJson = entry.isJson;
+  packet.hops = entry.hops;
+  packet.kind = entry.kind;
+  packet.sos = entry.sos;
+  return packet;
+}
+
+size_t retryDepth(const ForwardTarget& target) {
+  return depthOf(target.name.c_str());
+}
+
+// Takes a copy of the packet for the length of one batch; `queued` is the
+// pool entry it is being retried from, if any, and keeps its place and
+// attempts. NULL when every held slot is taken.
+RetryEntry* retryHold(const ForwardTarget& target, const RelayPacket& packet, const RetryEntry* queued) {
+  RetryEntry* entry = NULL;
+  for (size_t i = 0; i < RETRY_HELD_SIZE && entry == NULL; i++) {
+    if (!held[i].used) entry = &held[i];
+  }
+  if (entry == NULL) return NULL;
+  
+  memset(entry, 0, offsetof(RetryEntry, data));
+  entry->used = true;
+  entry->order = queued != NULL ? queued->order : nextOrder++;
+  entry->counted = queued != NULL && queued->counted;
+  entry->retried = queued != NULL;
+  entry->attempts = queued != NULL ? queued->attempts : 0;
+  strncpy(entry->target, target.name.c_str(), MAX_TARGET_NAME_LENGTH - 1);
+  strncpy(entry->nodeId, packet.nodeId, MAX_NODE_ID_LENGTH - 1);
+  entry->length = min(packet.length, (size_t)MAX_LORA_PACKET_SIZE);
+  memcpy(entry->data, packet.data, entry->length);
+  entry->isJson = packet.isJson;
+  entry->hops = packet.hops;
+  entry->kind = packet.kind;
+  entry->sos = packet.sos;
+  entry->rssi = packet.rssi;
+  entry->snr = packet.snr;
+  entry->hash = packet.hash;
+  entry->sequence = packet.sequence;
+  stats.held++;
+  return entry;
+}
+
+RetryEntry* retryFindHeld(const ForwardTarget& target, uint64_t hash) {
+  for (size_t i = 0; i < RETRY_HELD_SIZE; i++) {
+    RetryEntry& entry = held[i];
+    if (entry.hash == hash && matchesTarget(entry, target.name.c_str())) {
+      return &entry;
+    }
+  }
+  return NULL;
+}
+
+// The batch went out, or the packet is no longer wanted
+void retryRelease(RetryEntry* entry) {
+  if (entry == NULL || !entry->used) return;
+  entry->used = false;
+  stats.held--;
+}
+
+// The batch failed: the packet moves into the pool at its original place
+void retryRequeue(RetryEntry* entry, unsigned long nextAttemptAt) {
+  if (entry == NULL || !entry->used) return;
+  
+  RetryEntry* queued = storeEntry(entry->target, entry->nodeId, entry->data, entry->length);
+  memcpy(queued, entry, offsetof(RetryEntry, data));
+  queued->nextAttemptAt = nextAttemptAt;
+  retryRelease(entry);
+}
+
+void retryClear() {
+  for (size_t i = 0; i < RETRY_POOL_SIZE; i++) {
+    pool[i].used = false;
+  }
+  stats.queued = 0;
+  dirty = true;
+}
+
+RetryStats getRetryStats() {
+  return stats;
+}
+
+void loadRetryQueue() {
+  if (!FORWARD_PERSIST_QUEUE) return;
+  
+  static uint8_t blob[RETRY_PERSIST_MAX_BYTES];
+  Preferences store;
+  store.begin("retryq", true);
+  size_t size = store.getBytes("queue", blob, sizeof(blob));
+  store.end();
+  
+  if (size < 1 || blob[0] != RETRY_PERSIST_VERSION) return;
+  
+  unsigned long now = millis();
+  size_t offset = 1;
+  while (offset + sizeof(PersistedRetry) <= size) {
+    PersistedRetry header;
+    memcpy(&header, blob + offset, sizeof(header));
+    offset += sizeof(header);
+    if (offset + header.length > size) break;
+    
+    header.target[MAX_TARGET_NAME_LENGTH - 1] = '\0';
+    header.nodeId[MAX_NODE_ID_LENGTH - 1] = '\0';
+    RetryEntry* entry = storeEntry(header.target, header.nodeId, (const char*)blob + offset, header.length);
+    entry->counted = header.flags & 0x01;
+    entry->isJson = header.flags & 0x02;
+    entry->hops = (header.flags >> 2) & 0x0F;
+    entry->sos = header.flags & 0x40;
+    entry->kind = (PacketKind)min(header.kind, (uint8_t)PACKET_SOS);
+    entry->attempts = header.attempts;
+    entry->rssi = header.rssi;
+    entry->snr = header.snrQuarterDb / 4.0;
+    entry->hash = header.hash;
+    entry->sequence = header.sequence;
+    entry->nextAttemptAt = now;   // Timers restarted with the boot
+    offset += header.length;
+    stats.restored++;
+  }
+  dirty = false;
+  
+  if (stats.restored > 0) {
+    Serial.print("Restored ");
+    Serial.print(stats.restored);
+    Serial.println(" queued packets from flash");
+  }
+}
+
+// Rate limited so a long outage does not wear the flash
+void saveRetryQueue(bool force) {
+  if (!FORWARD_PERSIST_QUEUE || !dirty) return;
+  if (!force && millis() - lastPersist < RETRY_PERSIST_INTERVAL) return;
+  
+  static uint8_t blob[RETRY_PERSIST_MAX_BYTES];
+  size_t size = 0;
+  blob[size++] = RETRY_PERSIST_VERSION;
+  
+  // Oldest first, until the blob is full
+  uint32_t after = 0;
+  bool first = true;
+  for (size_t n = 0; n < stats.queued; n++) {
+    RetryEntry* next = NULL;
+    for (size_t i = 0; i < RETRY_POOL_SIZE; i++) {
+      RetryEntry& entry = pool[i];
+      if (!entry.used || (!first && (int32_t)(entry.order - after) <= 0)) continue;
+      if (next == NULL || (int32_t)(entry.order - next->order) < 0) next = &entry;
+    }
+    if (next == NULL || size + sizeof(PersistedRetry) + next->length > sizeof(blob)) break;
+    
+    PersistedRetry header = {};
+    header.hash = next->hash;
+    header.sequence = next->sequence;
+    header.rssi = next->rssi;
+    header.snrQuarterDb = constrain((int)roundf(next->snr * 4), -128, 127);
+    header.attempts = next->attempts;
+    header.length = next->length;
+    header.flags = (next->counted ? 0x01 : 0) | (next->isJson ? 0x02 : 0) | ((next->hops & 0x0F) << 2) |
+                   (next->sos ? 0x40 : 0);
+    header.kind = next->kind;
+    memcpy(header.target, next->target, MAX_TARGET_NAME_LENGTH);
+    memcpy(header.nodeId, next->nodeId, MAX_NODE_ID_LENGTH);
+    memcpy(blob + size, &header, sizeof(header));
+    size += sizeof(header);
+    memcpy(blob + size, next->data, next->length);
+    size += next->length;
+    
+    after = next->order;
+    first = false;
+  }
+  
+  Preferences store;
+  store.begin("retryq", false);
+  if (size > 1) {
+    store.putBytes("queue", blob, size);
+  } else {
+    store.remove("queue");
+  }
+  store.end();
+  
+  dirty = false;
+  lastPersist = millis();
+  stats.persisted++;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef RETRY_QUEUE_H
+#define RETRY_QUEUE_H
+
+#include "Common.h"
+
+// === RETRY QUEUE ===
+// Packets a target could not take wait here, in a static pool shared by
+// all targets. Each target keeps FIFO order and at most
+// RETRY_MAX_PER_TARGET entries; when either limit is hit the oldest
+// packet goes first. The pool is optionally mirrored to NVS so a reboot
+// during an outage does not lose it.
+//
+// Packets in an open HTTP, TCP or UDP session batch are held apart, in
+// RETRY_HELD_SIZE slots of their own: they are never evicted by queued
+// packets, never written to flash, and only join the pool (and so NVS) if
+// their batch fails to go out. Healthy traffic leaves the pool untouched.
+
+#define RETRY_POOL_SIZE          32
+#define RETRY_MAX_PER_TARGET     16
+#define RETRY_HELD_SIZE          16     // Packets in open batches, all sessions together
+#define RETRY_PERSIST_INTERVAL   30000  // ms between NVS writes while the queue changes
+#define RETRY_PERSIST_MAX_BYTES  4000   // Keeps the blob well inside the NVS partition
+
+struct RetryEntry {
+  bool used;
+  bool counted;                 // Already counted in totalForwarded
+  bool retried;                 // Came out of the pool through processRetryQueue()
+  bool isJson;
+  uint8_t hops;
+  PacketKind kind;
+  bool sos;
+  uint8_t attempts;
+  uint8_t length;
+  int16_t rssi;
+  float snr;
+  uint32_t order;               // FIFO position across the whole pool
+  uint64_t hash;
+  long sequence;
+  unsigned long nextAttemptAt;
+  char target[MAX_TARGET_NAME_LENGTH];
+  char nodeId[MAX_NODE_ID_LENGTH];
+  char data[MAX_LORA_PACKET_SIZE];
+};
+
+struct RetryStats {
+  size_t queued;
+  size_t held;                  // In open session batches
+  uint32_t enqueued;
+  uint32_t overflowDrops;       // Pushed out by a full pool or target limit
+  uint32_t persisted;           // NVS writes
+  uint32_t restored;            // Entries loaded at boot
+};
+
+// === QUEUE FUNCTIONS ===
+RetryEntry* retryEnqueue(const ForwardTarget& target, const RelayPacket& packet, uint8_t attempts,
+                         unsigned long nextAttemptAt, bool counted);
+RetryEntry* retryHead(const ForwardTarget& target);
+void retryRemove(RetryEntry* entry);
+void retryDropTarget(const ForwardTarget& target);
+void retryMarkCounted(uint64_t hash);
+RelayPacket retryPacket(const RetryEntry& entry);
+size_t retryDepth(const ForwardTarget& target);
+void retryClear();
+RetryStats getRetryStats();
+
+// === HELD FOR A BATCH ===
+RetryEntry* retryHold(const ForwardTarget& target, const RelayPacket& packet, const RetryEntry* queued);
+RetryEntry* retryFindHeld(const ForwardTarget& target, uint64_t hash);
+void retryRelease(RetryEntry* held);
+void retryRequeue(RetryEntry* held, unsigned long nextAttemptAt);
+
+// === PERSISTENCE ===
+void loadRetryQueue();
+void saveRetryQueue(bool force = false);
+
+#endif // RETRY_QUEUE_H
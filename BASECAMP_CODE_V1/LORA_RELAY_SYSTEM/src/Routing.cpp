@@ -0,0 +1,468 @@
+#include "Routing.h"
+#include "LoRa_Relay.h"
+
+// Radio settings from initializeLoRaRelay(), for airtime accounting
+#define ROUTE_LORA_SF        7
+#define ROUTE_LORA_BW        125000
+#define ROUTE_LORA_CR        1      // 4/5
+#define ROUTE_LORA_PREAMBLE  8
+
+struct PendingFrame {
+  bool used;
+  uint64_t hash;
+  unsigned long sendAt;
+  uint8_t hops;             // Our distance to the basecamp when it was held
+  uint8_t length;
+  char destination[MAX_NODE_ID_LENGTH];   // Preferred basecamp, may be empty
+  char data[MAX_LORA_PACKET_SIZE];
+};
+
+static RouteEntry routes[ROUTE_MAX_ENTRIES];
+static PendingFrame pending[ROUTE_PENDING_SLOTS];
+static RoutingStats stats = {};
+static unsigned long nextBeaconAt = 0;
+static unsigned long lastBeaconAt = 0;
+static bool routesChanged = false;
+static uint32_t suppressSlot = 0;
+
+// Semtech time-on-air formula, explicit header with CRC
+uint32_t loraAirtimeMs(size_t length) {
+  const uint32_t symbolUs = (1000000UL << ROUTE_LORA_SF) / ROUTE_LORA_BW;
+  const bool lowRateOptimize = symbolUs > 16000;
+  int32_t numerator = 8 * (int32_t)length - 4 * ROUTE_LORA_SF + 28 + 16;
+  int32_t denominator = 4 * (ROUTE_LORA_SF - (lowRateOptimize ? 2 : 0));
+  int32_t payloadSymbols = 8 + max((numerator + denominator - 1) / denominator, (int32_t)0) * (ROUTE_LORA_CR + 4);
+  uint32_t micros = (ROUTE_LORA_PREAMBLE * 4 + 17) * symbolUs / 4 + payloadSymbols * symbolUs;
+  return (micros + 999) / 1000;
+}
+
+// 0 at -10 dB SNR, 100 at +10 dB
+static uint8_t linkQuality(float snr) {
+  return constrain((int)((snr + 10) * 5), 0, 100);
+}
+
+static bool sameId(const char* a, const char* b, size_t bLength) {
+  return strlen(a) == bLength && memcmp(a, b, bLength) == 0;
+}
+
+static void copyId(char* out, const char* value, size_t length) {
+  length = min(length, (size_t)MAX_NODE_ID_LENGTH - 1);
+  memcpy(out, value, length);
+  out[length] = '\0';
+}
+
+// Best route to `preferred`, or to any basecamp: fewest hops, then cleanest path
+static RouteEntry* bestRoute(const char* preferred) {
+  RouteEntry* best = NULL;
+  for (size_t i = 0; i < ROUTE_MAX_ENTRIES; i++) {
+    RouteEntry& route = routes[i];
+    if (!route.valid) continue;
+    if (preferred[0] != '\0' && strcmp(route.destination, preferred) == 0) return &route;
+    if (best == NULL || route.hops < best->hops ||
+        (route.hops == best->hops && route.quality > best->quality)) {
+      best = &route;
+    }
+  }
+  return best;
+}
+
+static bool transmit(const char* data, size_t length) {
+  if (!LoRa.beginPacket()) return false;
+  LoRa.write((const uint8_t*)data, length);
+  bool success = LoRa.endPacket();
+  if (success) {
+    stats.airtimeMs += loraAirtimeMs(length);
+  }
+  return success;
+}
+
+// Wraps the payload in a frame for the route's next hop
+static bool sendFrame(const char* data, size_t length, const RouteEntry& route, uint8_t hops) {
+  char frame[MAX_LORA_PACKET_SIZE + 1];
+  int header = snprintf(frame, sizeof(frame), "{\"to\":\"%s\",\"fr\":\"%s\",\"dst\":\"%s\",\"h\":%u,\"c\":%u,\"data\":",
+                        route.nextHop, relayId.c_str(), route.destination, hops + 1, route.hops);
+  if (header < 0 || header + length + 1 > MAX_LORA_PACKET_SIZE) {
+    Serial.println("Packet too large to route, dropped");
+    return false;
+  }
+  memcpy(frame + header, data, length);
+  frame[header + length] = '}';
+  
+  if (!transmit(frame, header + length + 1)) return false;
+  stats.framesSent++;
+  Serial.print("Routed to ");
+  Serial.print(route.destination);
+  Serial.print(" via ");
+  Serial.print(route.nextHop);
+  Serial.print(" (");
+  Serial.print(route.hops);
+  Serial.println(" hops)");
+  return true;
+}
+
+// Length of the JSON object at `data`, or 0 if it does not close within `length`
+static size_t jsonObjectLength(const char* data, size_t length) {
+  int depth = 0;
+  bool inString = false;
+  for (size_t i = 0; i < length; i++) {
+    char c = data[i];
+    if (inString) {
+      if (c == '\\') i++;
+      else if (c == '"') inString = false;
+    } else if (c == '"') {
+      inString = true;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if ((c == '}' || c == ']') && --depth == 0) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+// === BEACONS ===
+
+// Minimal cursor parser for the beacon's route array
+struct BeaconReader {
+  const char* cursor;
+  const char* end;
+  
+  void skipSpace() { while (cursor < end && isspace((unsigned char)*cursor)) cursor++; }
+  bool expect(char c) {
+    skipSpace();
+    if (cursor >= end || *cursor != c) return false;
+    cursor++;
+    return true;
+  }
+  bool peek(char c) { skipSpace(); return cursor < end && *cursor == c; }
+  bool text(const char*& value, size_t& length) {
+    if (!expect('"')) return false;
+    value = cursor;
+    while (cursor < end && *cursor != '"') cursor++;
+    if (cursor >= end) return false;
+    length = cursor - value;
+    cursor++;
+    return true;
+  }
+  bool number(uint32_t& value) {
+    skipSpace();
+    if (cursor >= end || !isdigit((unsigned char)*cursor)) return false;
+    value = 0;
+    while (cursor < end && isdigit((unsigned char)*cursor)) {
+      value = value * 10 + (*cursor++ - '0');
+    }
+    return true;
+  }
+  bool atEnd() { skipSpace(); return cursor == end; }
+};
+
+// One route as read from a beacon, applied only once the whole beacon parsed
+struct BeaconEntry {
+  const char* destination;
+  const char* nextHop;
+  size_t destinationLength;
+  size_t nextHopLength;
+  uint32_t sequence;
+  uint32_t hops;
+  uint32_t quality;
+};
+
+#define ROUTE_BEACON_MAX_ENTRIES 8   // More than any sender fits in one packet
+
+static void updateRoute(const char* destination, size_t destinationLength, const char* neighbor,
+                        uint32_t sequence, uint8_t hops, uint8_t quality) {
+  RouteEntry* route = NULL;
+  RouteEntry* spare = NULL;
+  for (size_t i = 0; i < ROUTE_MAX_ENTRIES; i++) {
+    if (routes[i].valid && sameId(routes[i].destination, destination, destinationLength)) {
+      route = &routes[i];
+      break;
+    }
+    if (!routes[i].valid && spare == NULL) spare = &routes[i];
+  }
+  
+  if (route == NULL) {
+    if (spare == NULL) return;   // Table full of live routes
+    route = spare;
+    copyId(route->destination, destination, destinationLength);
+  } else {
+    // Newer sequence always wins. At the same sequence the current next hop
+    // may update its own path, others must be strictly better.
+    int32_t age = (int32_t)(sequence - route->sequence);
+    bool fromNextHop = strcmp(route->nextHop, neighbor) == 0;
+    bool better = hops < route->hops ||
+                  (hops == route->hops && quality >= route->quality + ROUTE_QUALITY_HYSTERESIS);
+    if (age < 0 || (age == 0 && !fromNextHop && !better)) return;
+  }
+  
+  bool changed = !route->valid || route->hops != hops || strcmp(route->nextHop, neighbor) != 0;
+  route->valid = true;
+  route->sequence = sequence;
+  route->hops = hops;
+  route->quality = quality;
+  route->updatedAt = millis();
+  strncpy(route->nextHop, neighbor, MAX_NODE_ID_LENGTH - 1);
+  route->nextHop[MAX_NODE_ID_LENGTH - 1] = '\0';
+  
+  if (changed) {
+    routesChanged = true;
+    Serial.printf("Route to %s: %u hops via %s (quality %u)\n",
+                  route->destination, hops, route->nextHop, quality);
+  }
+}
+
+static void handleBeacon(const char* data, size_t length, float snr) {
+  stats.beaconsHeard++;
+  uint8_t link = linkQuality(snr);
+  if (link < ROUTE_MIN_LINK_QUALITY) return;
+  
+  BeaconReader reader = {data, data + length};
+  const char* key;
+  const char* sender;
+  size_t keyLength, senderLength;
+  if (!reader.expect('{') || !reader.text(key, keyLength) || !reader.expect(':') ||
+      !reader.text(sender, senderLength) || senderLength == 0) {
+    return;
+  }
+  char neighbor[MAX_NODE_ID_LENGTH];
+  copyId(neighbor, sender, senderLength);
+  if (strcmp(neighbor, relayId.c_str()) == 0) return;
+  
+  if (!reader.expect(',') || !reader.text(key, keyLength) || !reader.expect(':') || !reader.expect('[')) {
+    return;
+  }
+  
+  // Each entry: ["destination", sequence, hops, quality, "nextHop"]
+  BeaconEntry entries[ROUTE_BEACON_MAX_ENTRIES];
+  size_t count = 0;
+  while (count < ROUTE_BEACON_MAX_ENTRIES && reader.expect('[')) {
+    BeaconEntry& entry = entries[count++];
+    if (!reader.text(entry.destination, entry.destinationLength) || !reader.expect(',') ||
+        !reader.number(entry.sequence) || !reader.expect(',') ||
+        !reader.number(entry.hops) || !reader.expect(',') ||
+        !reader.number(entry.quality) || !reader.expect(',') ||
+        !reader.text(entry.nextHop, entry.nextHopLength) || !reader.expect(']')) {
+      return;
+    }
+    if (!reader.peek(',')) break;
+    reader.expect(',');
+  }
+  
+  // Anything after the route array means someone else re-sent the beacon
+  // (hikers append their relay fields); its SNR says nothing about the sender
+  if (!reader.expect(']') || !reader.expect('}') || !reader.atEnd()) {
+    stats.beaconsRejected++;
+    return;
+  }
+  
+  for (size_t i = 0; i < count; i++) {
+    const BeaconEntry& entry = entries[i];
+    // Split horizon: a route through us is no route for us
+    bool viaUs = sameId(relayId.c_str(), entry.nextHop, entry.nextHopLength);
+    if (!viaUs && entry.hops < ROUTE_MAX_HOPS &&
+        !sameId(relayId.c_str(), entry.destination, entry.destinationLength)) {
+      // Clamped, not cast: a quality of 300 must not wrap to 44
+      uint8_t quality = min(entry.quality, (uint32_t)link);
+      updateRoute(entry.destination, entry.destinationLength, neighbor, entry.sequence,
+                  entry.hops + 1, quality);
+    }
+  }
+}
+
+static void sendBeacon() {
+  char beacon[MAX_LORA_PACKET_SIZE + 1];
+  int length = snprintf(beacon, sizeof(beacon), "{\"rb\":\"%s\",\"r\":[", relayId.c_str());
+  int advertised = 0;
+  
+  for (size_t i = 0; i < ROUTE_MAX_ENTRIES; i++) {
+    const RouteEntry& route = routes[i];
+    if (!route.valid) continue;
+    int written = snprintf(beacon + length, sizeof(beacon) - length, "%s[\"%s\",%u,%u,%u,\"%s\"]",
+                           advertised > 0 ? "," : "", route.destination, route.sequence,
+                           route.hops, route.quality, route.nextHop);
+    if (written < 0 || length + written + 2 > MAX_LORA_PACKET_SIZE) break;
+    length += written;
+    advertised++;
+  }
+  lastBeaconAt = millis();
+  nextBeaconAt = lastBeaconAt + ROUTE_BEACON_INTERVAL + random(ROUTE_BEACON_JITTER);
+  routesChanged = false;
+  
+  // Without a route there is nothing worth the airtime
+  if (advertised == 0) return;
+  
+  length += snprintf(beacon + length, sizeof(beacon) - length, "]}");
+  if (transmit(beacon, length)) {
+    stats.beaconsSent++;
+  }
+}
+
+// === FRAMES ===
+
+RoutingResult handleRoutingFrame(const char* data, size_t length, int rssi, float snr, RelayPacket& inner) {
+  if (length > 7 && memcmp(data, "{\"rb\":", 6) == 0) {
+    handleBeacon(data, length, snr);
+    return ROUTING_CONSUMED;
+  }
+  if (length < 8 || memcmp(data, "{\"to\":", 6) != 0) {
+    return ROUTING_NONE;
+  }
+  
+  const char* to;
+  const char* value;
+  size_t toLength, valueLength;
+  const char* payload = NULL;
+  static const char DATA_KEY[] = ",\"data\":";
+  for (const char* p = data; p + sizeof(DATA_KEY) - 1 < data + length; p++) {
+    if (memcmp(p, DATA_KEY, sizeof(DATA_KEY) - 1) == 0) {
+      payload = p + sizeof(DATA_KEY) - 1;
+      break;
+    }
+  }
+  // Header fields all come before "data", so only that part is searched
+  size_t headerLength = payload != NULL ? payload - data : 0;
+  if (payload == NULL || data[length - 1] != '}' ||
+      !findJsonField(data, headerLength, "to", to, toLength)) {
+    return ROUTING_CONSUMED;   // Malformed frame, never treat it as hiker data
+  }
+  // "data" must close the frame; keys after it mean a hiker re-sent the frame
+  size_t payloadLength = data + length - 1 - payload;
+  if (*payload == '{' && jsonObjectLength(payload, payloadLength) != payloadLength) {
+    stats.framesRejected++;
+    return ROUTING_CONSUMED;
+  }
+  
+  uint32_t hops = 0;
+  uint32_t senderHops = ROUTE_MAX_HOPS;
+  if (findJsonField(data, headerLength, "h", value, valueLength)) hops = strtoul(value, NULL, 10);
+  if (findJsonField(data, headerLength, "c", value, valueLength)) senderHops = strtoul(value, NULL, 10);
+  
+  decodeRelayPacket(payload, payloadLength, rssi, snr, inner);
+  inner.hops = min(hops, (uint32_t)ROUTE_MAX_HOPS);
+  
+  if (!sameId(relayId.c_str(), to, toLength)) {
+    stats.framesOverheard++;
+    // A relay at least as close already carries this packet
+    for (size_t i = 0; i < ROUTE_PENDING_SLOTS; i++) {
+      if (pending[i].used && pending[i].hash == inner.hash && senderHops <= pending[i].hops) {
+        pending[i].used = false;
+        stats.suppressed++;
+        Serial.println("Held packet already forwarded by a closer relay, dropped");
+      }
+    }
+    return ROUTING_CONSUMED;
+  }
+  
+  if (hops >= ROUTE_MAX_HOPS) {
+    Serial.println("Routed frame exceeded max hops, dropped");
+    return ROUTING_CONSUMED;
+  }
+  return ROUTING_DELIVER;
+}
+    
+// Forwarder entry point for LoRa targets; the target's address names a
+// preferred basecamp, empty means the nearest one
+bool routePacket(const RelayPacket& packet, const ForwardTarget& target) {
+  RouteEntry* route = bestRoute(target.address.c_str());
+  if (route == NULL) {
+    stats.noRoute++;
+    return false;
+  }
+  if (packet.hops >= ROUTE_MAX_HOPS) {
+    return true;   // Nowhere left to go; retrying would not help
+  }
+  if (packet.hops > 0) {
+    // Already routed to us: we are on the chosen path, send at once
+    return sendFrame(packet.data, packet.length, *route, packet.hops);
+  }
+  
+  // Heard straight from a hiker: hold it so closer relays get to go first
+  for (size_t i = 0; i < ROUTE_PENDING_SLOTS; i++) {
+    PendingFrame& frame = pending[i];
+    if (frame.used) continue;
+    frame.used = true;
+    frame.hash = packet.hash;
+    frame.hops = route->hops;
+    frame.length = packet.length;
+    frame.sendAt = millis() + route->hops * suppressSlot + random(ROUTE_SUPPRESS_JITTER);
+    strncpy(frame.destination, target.address.c_str(), MAX_NODE_ID_LENGTH - 1);
+    frame.destination[MAX_NODE_ID_LENGTH - 1] = '\0';
+    memcpy(frame.data, packet.data, packet.length);
+    return true;
+  }
+  // Every slot busy: better to send now than to lose it
+  return sendFrame(packet.data, packet.length, *route, 0);
+}
+    
+void initializeRouting() {
+  memset(routes, 0, sizeof(routes));
+  memset(pending, 0, sizeof(pending));
+  nextBeaconAt = millis() + random(ROUTE_BEACON_JITTER);
+  suppressSlot = loraAirtimeMs(MAX_LORA_PACKET_SIZE) + ROUTE_LOOP_LATENCY;
+  Serial.printf("Routing initialized, %u ms hold per hop, waiting for basecamp beacons\n", suppressSlot);
+}
+    
+// Called every loop(): ages routes, sends held packets and beacons
+void serviceRouting() {
+  unsigned long now = millis();
+  
+  for (size_t i = 0; i < ROUTE_MAX_ENTRIES; i++) {
+    RouteEntry& route = routes[i];
+    if (route.valid && now - route.updatedAt > ROUTE_TIMEOUT) {
+      route.valid = false;
+      routesChanged = true;
+      stats.expired++;
+      Serial.print("Route to ");
+      Serial.print(route.destination);
+      Serial.println(" expired");
+    }
+  }
+  
+  for (size_t i = 0; i < ROUTE_PENDING_SLOTS; i++) {
+    PendingFrame& frame = pending[i];
+    if (!frame.used || (long)(now - frame.sendAt) < 0) continue;
+    frame.used = false;
+    RouteEntry* route = bestRoute(frame.destination);
+    if (route == NULL) {
+      stats.noRoute++;
+      continue;
+    }
+    sendFrame(frame.data, frame.length, *route, 0);
+  }
+  
+  bool triggered = routesChanged && now - lastBeaconAt >= ROUTE_TRIGGER_HOLDOFF;
+  if (triggered || (long)(now - nextBeaconAt) >= 0) {
+    sendBeacon();
+  }
+}
+    
+RoutingStats getRoutingStats() {
+  RoutingStats result = stats;
+  result.suppressSlotMs = suppressSlot;
+  result.routes = 0;
+  for (size_t i = 0; i < ROUTE_MAX_ENTRIES; i++) {
+    if (routes[i].valid) result.routes++;
+  }
+  return result;
+}
+    
+void printRoutingTable() {
+  RoutingStats current = getRoutingStats();
+  Serial.println("=== Routes ===");
+  unsigned long now = millis();
+  for (size_t i = 0; i < ROUTE_MAX_ENTRIES; i++) {
+    const RouteEntry& route = routes[i];
+    if (!route.valid) continue;
+    Serial.printf("%s via %s: %u hops, quality %u, seq %u, %lu s old\n",
+                  route.destination, route.nextHop, route.hops, route.quality,
+                  route.sequence, (now - route.updatedAt) / 1000);
+  }
+  Serial.printf("Beacons %u sent / %u heard, %u frames sent, %u overheard, %u suppressed, "
+                "%u without route, %u re-sent by hikers, airtime %u ms (%.0f ms per frame)\n",
+                current.beaconsSent, current.beaconsHeard, current.framesSent, current.framesOverheard,
+                current.suppressed, current.noRoute, current.beaconsRejected + current.framesRejected,
+                current.airtimeMs,
+                current.framesSent > 0 ? (float)current.airtimeMs / current.framesSent : 0);
+  Serial.println("==============");
+}
+    
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef ROUTING_H
+#define ROUTING_H
+
+#include "Common.h"
+
+// === ROUTING ===
+// Distance-vector routes toward basecamps, DSDV style. Basecamps broadcast
+// beacons numbered with a sequence; each relay keeps the best route per
+// basecamp and re-advertises it in its own beacon. A route is replaced by
+// a newer sequence, or by a shorter/cleaner path at the same sequence, so
+// stale information can never form a loop. Routes age out when their
+// beacons stop.
+//
+// Data travels as unicast frames addressed to the next hop:
+//   {"to":"R2","fr":"R1","dst":"BASECAMP_01","h":1,"c":2,"data":{...}}
+// Relays that are not addressed ignore the frame. A packet heard straight
+// from a hiker is held for a delay that grows with the relay's distance
+// to the basecamp; it is dropped if a relay at least as close is overheard
+// sending it first. The hold per hop is one full-size frame's airtime
+// plus ROUTE_LOOP_LATENCY, so the closer relay's frame has been received
+// and read before the next relay out would send.
+//
+// Beacon: {"rb":"R1","r":[["BASECAMP_01",seq,hops,quality,"nextHop"],...]}
+
+#define ROUTE_MAX_ENTRIES         4      // Basecamps tracked
+#define ROUTE_BEACON_INTERVAL     30000  // ms, plus up to ROUTE_BEACON_JITTER
+#define ROUTE_BEACON_JITTER       5000
+#define ROUTE_TRIGGER_HOLDOFF     5000   // Min spacing of beacons sent on a route change
+#define ROUTE_TIMEOUT             105000 // 3.5 beacon intervals without a refresh
+#define ROUTE_MAX_HOPS            8      // Frames are dropped beyond this (TTL)
+#define ROUTE_MIN_LINK_QUALITY    20     // ~-6 dB SNR at SF7; weaker links are not used
+#define ROUTE_QUALITY_HYSTERESIS  10     // Same-hop paths must be this much cleaner to win
+#define ROUTE_LOOP_LATENCY        200    // ms; loop() sleeps 100 ms and can be busy as long again
+#define ROUTE_SUPPRESS_JITTER     100
+#define ROUTE_PENDING_SLOTS       4      // Packets held for suppression
+
+// How a received frame was handled
+enum RoutingResult {
+  ROUTING_NONE,        // Not a routing frame, process as a normal packet
+  ROUTING_CONSUMED,    // Beacon or frame for another relay, nothing to forward
+  ROUTING_DELIVER      // Frame addressed to us; `inner` describes its payload
+};
+
+struct RouteEntry {
+  char destination[MAX_NODE_ID_LENGTH];
+  char nextHop[MAX_NODE_ID_LENGTH];
+  uint32_t sequence;
+  uint8_t hops;
+  uint8_t quality;        // Worst link on the path, 0-100
+  unsigned long updatedAt;
+  bool valid;
+};
+
+struct RoutingStats {
+  size_t routes;
+  uint32_t beaconsSent;
+  uint32_t beaconsHeard;
+  uint32_t framesSent;
+  uint32_t framesOverheard;   // Addressed to another relay, ignored
+  uint32_t beaconsRejected;   // Re-sent by a non-relay, see handleBeacon()
+  uint32_t framesRejected;
+  uint32_t suppressed;        // Held packets dropped because a closer relay sent them
+  uint32_t noRoute;
+  uint32_t expired;
+  uint32_t airtimeMs;         // Everything this relay transmitted
+  uint32_t suppressSlotMs;    // Hold per hop to the basecamp
+};
+
+// === ROUTING FUNCTIONS ===
+void initializeRouting();
+RoutingResult handleRoutingFrame(const char* data, size_t length, int rssi, float snr, RelayPacket& inner);
+bool routePacket(const RelayPacket& packet, const ForwardTarget& target);
+void serviceRouting();
+uint32_t loraAirtimeMs(size_t length);
+RoutingStats getRoutingStats();
+void printRoutingTable();
+
+#endif // ROUTING_H
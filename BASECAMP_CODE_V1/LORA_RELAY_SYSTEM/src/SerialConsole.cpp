@@ -0,0 +1,140 @@
+#include "SerialConsole.h"
+#include "Forwarder.h"
+#include "ForwardRules.h"
+
+static char line[CONSOLE_LINE_LENGTH + 1];
+static size_t lineLength = 0;
+static bool lineTooLong = false;
+
+// Splits on spaces; returns the number of words found
+static size_t splitWords(const String& text, String* words) {
+  size_t count = 0;
+  int start = 0;
+  while (start < (int)text.length() && count < CONSOLE_MAX_WORDS) {
+    int space = text.indexOf(' ', start);
+    if (space < 0) space = text.length();
+    if (space > start) {
+      words[count++] = text.substring(start, space);
+    }
+    start = space + 1;
+  }
+  return count;
+}
+
+static void printUsage() {
+  Serial.println("Commands:");
+  Serial.println("  targets");
+  Serial.println("  target add <name> <type> <address> [port] [path]");
+  Serial.println("  target remove <name>");
+  Serial.println("  target enable|disable <name>");
+  Serial.println("  rules");
+  Serial.println("  rule add <targets> [node=<prefix>] [kind=<kind,...>] [sos=only|never] [rssi=<dBm>]");
+  Serial.println("  rule clear");
+}
+
+static void runTargetCommand(const String* words, size_t count) {
+  if (count >= 4 && words[1] == "add") {
+    ForwardType type = parseForwardType(words[3]);
+    if (type == FORWARD_UNKNOWN) {
+      Serial.print("Unknown target type: ");
+      Serial.println(words[3]);
+      return;
+    }
+    String address = count > 4 ? words[4] : String("");
+    int port = count > 5 ? words[5].toInt() : 0;
+    String path = count > 6 ? words[6] : String("/post");
+    addForwardTarget(words[2], type, address, port, path);
+    return;
+  }
+  if (count == 3 && words[1] == "remove") {
+    if (!removeForwardTarget(words[2])) {
+      Serial.print("No forward target named ");
+      Serial.println(words[2]);
+    }
+    return;
+  }
+  if (count == 3 && (words[1] == "enable" || words[1] == "disable")) {
+    enableForwardTarget(words[2], words[1] == "enable");
+    return;
+  }
+  printUsage();
+}
+
+static void runRuleCommand(const String* words, size_t count) {
+  if (count == 2 && words[1] == "clear") {
+    clearForwardRules();
+    Serial.println("Forward rules cleared");
+    return;
+  }
+  if (count < 3 || words[1] != "add") {
+    printUsage();
+    return;
+  }
+  
+  ForwardRule rule = {"", 0, RULE_SOS_ANY, RULE_RSSI_ANY, words[2]};
+  for (size_t i = 3; i < count; i++) {
+    int equals = words[i].indexOf('=');
+    String key = equals > 0 ? words[i].substring(0, equals) : words[i];
+    String value = equals > 0 ? words[i].substring(equals + 1, words[i].length()) : String("");
+    
+    if (key == "node") {
+      rule.nodePrefix = value;
+    } else if (key == "kind" && parseRuleKinds(value) != 0) {
+      rule.kinds = parseRuleKinds(value);
+    } else if (key == "sos" && (value == "only" || value == "never")) {
+      rule.sos = value == "only" ? RULE_SOS_ONLY : RULE_SOS_NEVER;
+    } else if (key == "rssi" && value.length() > 0) {
+      rule.minRssi = value.toInt();
+    } else {
+      Serial.print("Bad rule option: ");
+      Serial.println(words[i]);
+      return;
+    }
+  }
+  
+  if (addForwardRule(rule)) {
+    printForwardRules();
+  }
+}
+
+void runConsoleCommand(const String& text) {
+  String words[CONSOLE_MAX_WORDS];
+  size_t count = splitWords(text, words);
+  if (count == 0) return;
+  
+  if (words[0] == "targets") {
+    printForwardTargets();
+  } else if (words[0] == "target") {
+    runTargetCommand(words, count);
+  } else if (words[0] == "rules") {
+    printForwardRules();
+  } else if (words[0] == "rule") {
+    runRuleCommand(words, count);
+  } else {
+    printUsage();
+  }
+}
+
+// Called every loop(): never blocks, a command runs once its line ends
+void handleSerialConsole() {
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (lineLength < CONSOLE_LINE_LENGTH) {
+        line[lineLength++] = c;
+      } else {
+        lineTooLong = true;
+      }
+      continue;
+    }
+    
+    line[lineLength] = '\0';
+    if (lineTooLong) {
+      Serial.println("Console line too long, ignored");
+    } else if (lineLength > 0) {
+      runConsoleCommand(String(line));
+    }
+    lineLength = 0;
+    lineTooLong = false;
+  }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include "Common.h"
+
+// === SERIAL CONSOLE ===
+// Line commands on the USB serial port for what the portal does not cover:
+// forward targets and forward rules. Commands run from loop(), so they
+// change the target list and rule table on the same task that forwards.
+//
+//   targets
+//   target add <name> <type> <address> [port] [path]
+//   target remove <name>
+//   target enable <name> | target disable <name>
+//   rules
+//   rule add <targets> [node=<prefix>] [kind=<kind,...>] [sos=only|never] [rssi=<dBm>]
+//   rule clear
+//   help
+
+#define CONSOLE_LINE_LENGTH  160    // Longer lines are dropped whole
+#define CONSOLE_MAX_WORDS    8
+
+// === CONSOLE FUNCTIONS ===
+void handleSerialConsole();
+void runConsoleCommand(const String& line);
+
+#endif // SERIAL_CONSOLE_H
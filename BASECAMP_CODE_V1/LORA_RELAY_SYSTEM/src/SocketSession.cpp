@@ -0,0 +1,241 @@
+#include "SocketSession.h"
+#include "Forwarder.h"
+#include <WiFiUdp.h>
+
+struct SocketSession {
+  bool used;
+  bool udp;
+  char target[MAX_TARGET_NAME_LENGTH];
+  WiFiClient client;         // TCP only
+  bool everConnected;
+  unsigned long nextConnectAt;
+  uint8_t failStreak;
+  uint8_t buffer[SOCKET_BUFFER_SIZE];
+  size_t bufferedBytes;
+  uint16_t bufferedPackets;
+  uint64_t hashes[SOCKET_BUFFER_PACKETS];   // Packets in the buffer, for markTargetDelivered()
+  unsigned long firstQueuedAt;
+  SocketSessionStats stats;
+};
+
+static SocketSession sessions[SOCKET_MAX_SESSIONS];
+static WiFiUDP udpSocket;
+static bool udpBound = false;
+
+static bool sameTarget(const SocketSession& session, const String& name) {
+  return strncmp(session.target, name.c_str(), MAX_TARGET_NAME_LENGTH - 1) == 0;
+}
+
+static SocketSession* findSession(const ForwardTarget& target, bool create) {
+  SocketSession* freeSession = NULL;
+  for (size_t i = 0; i < SOCKET_MAX_SESSIONS; i++) {
+    SocketSession& session = sessions[i];
+    if (!session.used) {
+      if (freeSession == NULL) freeSession = &session;
+      continue;
+    }
+    if (sameTarget(session, target.name)) {
+      return &session;
+    }
+  }
+  if (!create || freeSession == NULL) return NULL;
+  
+  SocketSession& session = *freeSession;
+  session.used = true;
+  session.udp = target.protocol == FORWARD_UDP;
+  strncpy(session.target, target.name.c_str(), MAX_TARGET_NAME_LENGTH - 1);
+  session.target[MAX_TARGET_NAME_LENGTH - 1] = '\0';
+  session.everConnected = false;
+  session.nextConnectAt = 0;
+  session.failStreak = 0;
+  session.bufferedBytes = 0;
+  session.bufferedPackets = 0;
+  memset(&session.stats, 0, sizeof(session.stats));
+  return &session;
+}
+
+static void noteFailure(SocketSession& session, const ForwardTarget& target) {
+  markTargetFailure(target.name);
+  session.stats.failures++;
+  session.failStreak = min(session.failStreak + 1, 16);
+  unsigned long backoff = min((unsigned long)FORWARD_RETRY_DELAY << (session.failStreak - 1),
+                              (unsigned long)FORWARD_RETRY_MAX_DELAY);
+  session.nextConnectAt = millis() + backoff;
+}
+
+// The UDP socket is bound once; binding per send used to recreate it every packet
+bool initializeSocketSessions() {
+  if (!udpBound) {
+    udpBound = udpSocket.begin(UDP_LOCAL_PORT);
+  }
+  return udpBound;
+}
+
+// Connects when needed, but not again until the backoff has passed
+static bool ensureConnected(SocketSession& session, const ForwardTarget& target) {
+  if (session.client.connected()) return true;
+  if (session.failStreak > 0 && (long)(millis() - session.nextConnectAt) < 0) return false;
+  
+  session.client.stop();
+  if (!session.client.connect(target.address.c_str(), target.port, TCP_CONNECT_TIMEOUT)) {
+    noteFailure(session, target);
+    Serial.print("TCP connect to ");
+    Serial.print(target.address);
+    Serial.print(":");
+    Serial.print(target.port);
+    Serial.println(" failed");
+    return false;
+  }
+  // Coalescing happens here, Nagle would only add delay on top
+  session.client.setNoDelay(true);
+  if (session.everConnected) {
+    session.stats.reconnects++;
+  }
+  session.everConnected = true;
+  session.failStreak = 0;
+  return true;
+}
+
+// The packets go back to the retry queue, which persists them and backs off
+static void giveUpBuffer(SocketSession& session, const ForwardTarget& target) {
+  markTargetUndelivered(target.name, session.hashes, session.bufferedPackets);
+  session.bufferedBytes = 0;
+  session.bufferedPackets = 0;
+}
+
+static bool flushSession(SocketSession& session, const ForwardTarget& target) {
+  if (session.bufferedBytes == 0) return true;
+  if (WiFi.status() != WL_CONNECTED || (session.udp && !initializeSocketSessions()) ||
+      (!session.udp && !ensureConnected(session, target))) {
+    giveUpBuffer(session, target);
+    return false;
+  }
+  
+  bool success;
+  if (session.udp) {
+    success = udpSocket.beginPacket(target.address.c_str(), target.port) &&
+              udpSocket.write(session.buffer, session.bufferedBytes) == session.bufferedBytes &&
+              udpSocket.endPacket();
+  } else {
+    success = session.client.write(session.buffer, session.bufferedBytes) == session.bufferedBytes;
+    if (!success) {
+      // Part of the buffer may have gone out; the packets are resent whole
+      // from the retry queue on a fresh connection, never as a torn frame
+      session.client.stop();
+    }
+  }
+  
+  if (!success) {
+    giveUpBuffer(session, target);
+    noteFailure(session, target);
+    return false;
+  }
+  
+  session.stats.packets += session.bufferedPackets;
+  session.stats.bytes += session.bufferedBytes;
+  session.stats.writes++;
+  uint16_t sent = session.bufferedPackets;
+  session.bufferedBytes = 0;
+  session.bufferedPackets = 0;
+  markTargetDelivered(target.name, session.hashes, sent);
+  return true;
+}
+
+// Returns false when the packet could not be taken, so it goes to the retry queue
+bool socketSessionAppend(const RelayPacket& packet, const ForwardTarget& target) {
+  if (WiFi.status() != WL_CONNECTED) {
+    return false;
+  }
+  
+  SocketSession* session = findSession(target, true);
+  if (session == NULL) {
+    Serial.println("No free socket session slot");
+    return false;
+  }
+  
+  // A TCP target that cannot be reached should fail here, not after buffering
+  if (!session->udp && !ensureConnected(*session, target)) {
+    return false;
+  }
+  
+  size_t frameLength = SOCKET_FRAME_HEADER + packet.length;
+  if (session->bufferedBytes + frameLength > SOCKET_BUFFER_SIZE ||
+      session->bufferedPackets >= SOCKET_BUFFER_PACKETS) {
+    if (!flushSession(*session, target)) {
+      return false;
+    }
+  }
+  
+  if (session->bufferedPackets == 0) {
+    session->firstQueuedAt = millis();
+  }
+  uint8_t* frame = session->buffer + session->bufferedBytes;
+  frame[0] = packet.length >> 8;
+  frame[1] = packet.length & 0xFF;
+  memcpy(frame + SOCKET_FRAME_HEADER, packet.data, packet.length);
+  session->bufferedBytes += frameLength;
+  session->hashes[session->bufferedPackets++] = packet.hash;
+  return true;
+}
+
+// Called every loop(): sends buffers whose first frame has waited long
+// enough and throws away anything a TCP peer sends back
+void serviceSocketSessions() {
+  unsigned long now = millis();
+  
+  for (size_t i = 0; i < SOCKET_MAX_SESSIONS; i++) {
+    SocketSession& session = sessions[i];
+    if (!session.used) continue;
+    
+    if (!session.udp) {
+      while (session.client.available() > 0) {
+        uint8_t discard[64];
+        session.client.read(discard, sizeof(discard));
+      }
+    }
+    
+    if (session.bufferedPackets == 0) continue;
+    if (now - session.firstQueuedAt < SOCKET_COALESCE_DELAY) continue;
+    
+    for (auto& target : forwardTargets) {
+      if (!sameTarget(session, target.name)) continue;
+      if (target.enabled && isTargetAvailable(target)) {
+        flushSession(session, target);
+      } else {
+        // Disabled or breaker open meanwhile: wait in the retry queue instead
+        giveUpBuffer(session, target);
+      }
+      break;
+    }
+  }
+}
+
+void closeSocketSession(const ForwardTarget& target) {
+  SocketSession* session = findSession(target, false);
+  if (session == NULL) return;
+  
+  session->client.stop();
+  session->used = false;
+}
+
+bool getSocketSessionStats(const ForwardTarget& target, SocketSessionStats& stats) {
+  SocketSession* session = findSession(target, false);
+  if (session == NULL) return false;
+  
+  stats = session->stats;
+  stats.pendingPackets = session->bufferedPackets;
+  return true;
+}
+
+void printSocketSessionStats() {
+  for (const auto& target : forwardTargets) {
+    SocketSessionStats stats;
+    if (!getSocketSessionStats(target, stats)) continue;
+    
+    Serial.printf("%s %s: %u packets, %u bytes in %u %s, %u reconnects, %u failures, %u pending\n",
+                  target.protocol == FORWARD_UDP ? "UDP" : "TCP", target.name.c_str(),
+                  stats.packets, stats.bytes, stats.writes,
+                  target.protocol == FORWARD_UDP ? "datagrams" : "writes",
+                  stats.reconnects, stats.failures, stats.pendingPackets);
+  }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#ifndef SOCKET_SESSION_H
+#define SOCKET_SESSION_H
+
+#include "Common.h"
+
+// === SOCKET SESSIONS ===
+// TCP targets keep one connection open and reconnect with backoff when it
+// drops. UDP targets share one socket bound at start-up. Both send every
+// packet as a frame: a 2-byte big-endian length followed by the payload.
+// Frames are coalesced per target into one write (TCP) or one datagram
+// (UDP) and sent when the buffer is full or its first frame has waited
+// SOCKET_COALESCE_DELAY. Buffered packets are held apart from the retry
+// queue and count as delivered once the write or datagram goes out; if it
+// fails they move into the retry queue and the buffer starts empty.
+
+#define SOCKET_MAX_SESSIONS     4
+#define SOCKET_BUFFER_SIZE      1400   // Stays under a 1500-byte MTU for UDP
+#define SOCKET_BUFFER_PACKETS   8      // Half of RETRY_HELD_SIZE, so two buffers fit at once
+#define SOCKET_COALESCE_DELAY   50     // ms the first frame may wait
+#define SOCKET_FRAME_HEADER     2
+#define TCP_CONNECT_TIMEOUT     2000   // ms
+#define UDP_LOCAL_PORT          8080
+
+struct SocketSessionStats {
+  uint32_t packets;
+  uint32_t bytes;            // Frame bytes written, headers included
+  uint32_t writes;           // TCP writes or UDP datagrams
+  uint32_t reconnects;       // TCP connections opened after the first
+  uint32_t failures;         // Failed connects or writes
+  size_t pendingPackets;
+};
+
+// === SESSION FUNCTIONS ===
+bool initializeSocketSessions();
+bool socketSessionAppend(const RelayPacket& packet, const ForwardTarget& target);
+void serviceSocketSessions();
+void closeSocketSession(const ForwardTarget& target);
+bool getSocketSessionStats(const ForwardTarget& target, SocketSessionStats& stats);
+void printSocketSessionStats();
+
+#endif // SOCKET_SESSION_H
@@ -0,0 +1,194 @@
+#include "StatusEvents.h"
+#include "StatusPage.h"
+#include "LoRa_Relay.h"
+#include "PacketHistory.h"
+#include "RetryQueue.h"
+#include "WiFi_Config.h"
+#include <atomic>
+
+#define STATUS_PACKETS_SHOWN 10   // Rows kept by the page
+
+struct StatusSnapshot {
+  uint32_t received;
+  uint32_t forwarded;
+  uint32_t duplicates;
+  uint32_t queued;
+  uint32_t uptime;         // s
+  uint32_t heap;
+  char lora[24];
+  char wifi[40];
+  char lastFrom[MAX_NODE_ID_LENGTH];
+};
+
+static AsyncEventSource statusEvents(STATUS_EVENTS_PATH);
+static std::atomic<bool> fullSnapshotDue(false);
+static StatusSnapshot lastPushed;
+static uint64_t lastPacketHash = 0;
+static uint32_t lastPacketTime = 0;
+static uint32_t eventId = 0;
+
+// Fixed-buffer JSON writer; output past the end is cut, never overflowed
+struct EventWriter {
+  char data[STATUS_EVENT_SIZE];
+  size_t length;
+  bool first;
+  
+  EventWriter() : length(1), first(true) { data[0] = '{'; data[1] = '\0'; }
+  
+  void raw(const char* format, ...) {
+    if (length >= sizeof(data) - 1) return;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(data + length, sizeof(data) - length, format, args);
+    va_end(args);
+    if (written > 0) length = min(length + written, sizeof(data) - 1);
+  }
+  
+  void key(const char* name) {
+    raw(first ? "\"%s\":" : ",\"%s\":", name);
+    first = false;
+  }
+  
+  void number(const char* name, uint32_t value) {
+    key(name);
+    raw("%u", value);
+  }
+  
+  // Status strings and node IDs; quotes, backslashes and control bytes are dropped
+  void text(const char* name, const char* value) {
+    key(name);
+    raw("\"");
+    for (const char* c = value; *c != '\0' && length < sizeof(data) - 2; c++) {
+      if (*c == '"' || *c == '\\' || (uint8_t)*c < 0x20) continue;
+      data[length++] = *c;
+    }
+    data[length] = '\0';
+    raw("\"");
+  }
+  
+  const char* finish() {
+    raw("}");
+    return data;
+  }
+};
+
+static void copyText(char* out, size_t size, const String& value) {
+  strncpy(out, value.c_str(), size - 1);
+  out[size - 1] = '\0';
+}
+
+static void takeSnapshot(StatusSnapshot& snapshot) {
+  snapshot.received = getTotalReceivedPackets();
+  snapshot.forwarded = getTotalForwardedPackets();
+  snapshot.duplicates = getTotalDuplicatePackets();
+  snapshot.queued = getRetryStats().queued;
+  snapshot.uptime = millis() / 1000;
+  snapshot.heap = ESP.getFreeHeap();
+  copyText(snapshot.lora, sizeof(snapshot.lora), getLoRaRelayStatus());
+  copyText(snapshot.wifi, sizeof(snapshot.wifi), getWiFiStatus());
+  copyText(snapshot.lastFrom, sizeof(snapshot.lastFrom), lastReceivedFrom);
+}
+
+static void sendEvent(const char* payload, const char* event) {
+  statusEvents.send(payload, event, ++eventId);
+}
+
+// Uptime and heap move every second, so they ride along only when
+// something else changed, or on a full snapshot
+static void pushStats(bool full) {
+  StatusSnapshot now;
+  takeSnapshot(now);
+  
+  EventWriter event;
+  bool changed = false;
+  if (full) {
+    event.number("full", 1);
+    event.text("relay_id", relayId.c_str());
+  }
+  
+#define STATUS_NUMBER(field, name) \
+  if (full || now.field != lastPushed.field) { event.number(name, now.field); changed = true; }
+#define STATUS_TEXT(field, name) \
+  if (full || strcmp(now.field, lastPushed.field) != 0) { event.text(name, now.field); changed = true; }
+  
+  STATUS_NUMBER(received, "received");
+  STATUS_NUMBER(forwarded, "forwarded");
+  STATUS_NUMBER(duplicates, "duplicates");
+  STATUS_NUMBER(queued, "queued");
+  STATUS_TEXT(lora, "lora");
+  STATUS_TEXT(wifi, "wifi");
+  STATUS_TEXT(lastFrom, "last_from");
+  
+#undef STATUS_NUMBER
+#undef STATUS_TEXT
+  
+  if (!full && !changed) return;
+  event.number("uptime", now.uptime);
+  event.number("heap", now.heap);
+  sendEvent(event.finish(), "stats");
+  lastPushed = now;
+}
+
+static void pushPacket(const HistoryRecord& record, unsigned long now) {
+  EventWriter event;
+  event.text("node", historyNodeId(record));
+  event.number("age_ms", now - record.timestamp);
+  event.key("rssi");
+  event.raw("%d", record.rssi);
+  event.key("snr");
+  event.raw("%.2f", record.snrQuarterDb / 4.0);
+  event.number("bytes", record.length);
+  event.raw(",\"forwarded\":%s", record.forwarded ? "true" : "false");
+  sendEvent(event.finish(), "packet");
+}
+
+// New records are the ones newer than the last pushed; sent oldest first
+static void pushPackets(bool full) {
+  unsigned long now = millis();
+  
+  lockHistory();
+  size_t available = min(historySize(), (size_t)STATUS_PACKETS_SHOWN);
+  size_t fresh = 0;
+  while (fresh < available) {
+    const HistoryRecord& record = historyNewest(fresh);
+    if (!full && record.hash == lastPacketHash && record.timestamp == lastPacketTime) break;
+    fresh++;
+  }
+  for (size_t i = fresh; i > 0; i--) {
+    pushPacket(historyNewest(i - 1), now);
+  }
+  if (available > 0) {
+    lastPacketHash = historyNewest(0).hash;
+    lastPacketTime = historyNewest(0).timestamp;
+  }
+  unlockHistory();
+}
+
+void registerStatusEvents() {
+  // Runs on the web server task; the loop sends the snapshot
+  statusEvents.onConnect([](AsyncEventSourceClient* client) {
+    fullSnapshotDue = true;
+  });
+  server.addHandler(&statusEvents);
+}
+
+// Called every loop(); does nothing while no browser is connected
+void updateStatusEvents() {
+  static unsigned long lastPush = 0;
+  if (statusEvents.count() == 0) return;
+  if (millis() - lastPush < STATUS_PUSH_INTERVAL) return;
+  lastPush = millis();
+  
+  bool full = fullSnapshotDue.exchange(false);
+  pushStats(full);
+  pushPackets(full);
+}
+
+// Served straight from flash; the browser caches it and only the event stream stays open
+void handleStatusPage(AsyncWebServerRequest *request) {
+  AsyncWebServerResponse* response =
+    request->beginResponse(200, "text/html", STATUS_PAGE_GZ, STATUS_PAGE_GZ_LENGTH);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("Cache-Control", "max-age=3600");
+  request->send(response);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#ifndef STATUS_EVENTS_H
+#define STATUS_EVENTS_H
+
+#include "Common.h"
+
+// === STATUS EVENTS ===
+// Server-Sent Events behind the static /relay page. Once a second, and
+// only while someone is watching, the relay diffs its counters against the
+// last push and sends the changed fields as one "stats" event, plus one
+// "packet" event per new history record. A browser that connects gets a
+// full snapshot on the next push.
+
+#define STATUS_EVENTS_PATH     "/events"
+#define STATUS_PUSH_INTERVAL   1000   // ms
+#define STATUS_EVENT_SIZE      384    // Largest event payload
+
+// === STATUS EVENT FUNCTIONS ===
+void registerStatusEvents();
+void updateStatusEvents();
+void handleStatusPage(AsyncWebServerRequest *request);
+
+#endif // STATUS_EVENTS_H
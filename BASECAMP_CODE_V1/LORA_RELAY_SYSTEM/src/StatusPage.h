@@ -0,0 +1,124 @@
+#pragma once
+#ifndef STATUS_PAGE_H
+#define STATUS_PAGE_H
+
+#include <Arduino.h>
+
+// === STATUS PAGE ===
+// web/relay_status.html, gzip-compressed and kept in flash. Regenerate after
+// editing the page with:
+//   gzip -9 -n -c web/relay_status.html | xxd -i
+
+const uint8_t STATUS_PAGE_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x56,
+  0x7b, 0x6f, 0xdb, 0x36, 0x10, 0xff, 0x3f, 0x40, 0xbe, 0xc3, 0x4d, 0x01,
+  0x06, 0x19, 0xb5, 0xa5, 0x64, 0xed, 0x00, 0x43, 0xb6, 0x35, 0xb4, 0x4d,
+  0x82, 0x65, 0x68, 0xda, 0x2e, 0xee, 0xd0, 0x0d, 0x45, 0x11, 0x30, 0xd2,
+  0xc9, 0x22, 0x4a, 0x93, 0x1a, 0x49, 0xd9, 0xf5, 0xbc, 0x7c, 0xf7, 0x1d,
+  0xa9, 0x47, 0xec, 0x24, 0x0d, 0xba, 0x18, 0x81, 0x4e, 0xf7, 0xf8, 0xf1,
+  0xde, 0xd4, 0xf4, 0x87, 0xd3, 0x77, 0xaf, 0x3f, 0xfc, 0xf5, 0xfe, 0x0c,
+  0x4a, 0xbb, 0x14, 0xe9, 0xe1, 0xc1, 0xb4, 0x7f, 0x22, 0xcb, 0xdd, 0x73,
+  0x89, 0x96, 0x41, 0x56, 0x32, 0x6d, 0xd0, 0xce, 0x82, 0xda, 0x16, 0xa3,
+  0x71, 0xd0, 0xf3, 0x25, 0x5b, 0xe2, 0x2c, 0x58, 0x71, 0x5c, 0x57, 0x4a,
+  0xdb, 0x00, 0x32, 0x25, 0x2d, 0x4a, 0xd2, 0x5b, 0xf3, 0xdc, 0x96, 0xb3,
+  0x1c, 0x57, 0x3c, 0xc3, 0x91, 0x7f, 0x19, 0x72, 0xc9, 0x2d, 0x67, 0x62,
+  0x64, 0x32, 0x26, 0x70, 0x76, 0xe2, 0x41, 0x2c, 0xb7, 0x02, 0xd3, 0x37,
+  0xea, 0x8a, 0xc1, 0x15, 0x0a, 0xb6, 0x81, 0xb9, 0x65, 0xb6, 0x36, 0xd3,
+  0xb8, 0x11, 0x90, 0x86, 0xb1, 0x1b, 0x4f, 0xdc, 0xa8, 0x7c, 0xb3, 0x2d,
+  0x08, 0x7e, 0x54, 0xb0, 0x25, 0x17, 0x9b, 0xe4, 0xa5, 0x26, 0xb0, 0xc9,
+  0x92, 0xe9, 0x05, 0x97, 0xc9, 0x4f, 0xc7, 0xd5, 0xd7, 0xc9, 0x0d, 0xcb,
+  0xbe, 0x2c, 0xb4, 0xaa, 0x65, 0x9e, 0x1c, 0x15, 0xc7, 0xee, 0x77, 0x7b,
+  0x78, 0x10, 0x39, 0x97, 0x18, 0x97, 0xa8, 0xb7, 0x3b, 0xf2, 0x75, 0xc9,
+  0x2d, 0x4e, 0x2a, 0x96, 0xe7, 0x5c, 0x2e, 0x5a, 0x6b, 0xa5, 0x73, 0xd4,
+  0x23, 0xcd, 0x72, 0x5e, 0x9b, 0xe4, 0x84, 0x58, 0xce, 0xda, 0x78, 0x7f,
+  0x76, 0x4d, 0x8f, 0x70, 0x5c, 0xbc, 0x28, 0xc6, 0xbd, 0xf1, 0xc9, 0x43,
+  0xe3, 0x9f, 0x89, 0xd3, 0x3a, 0xe6, 0xa4, 0x70, 0xdc, 0x21, 0x6d, 0x73,
+  0x6e, 0x2a, 0x0a, 0x33, 0xe1, 0x52, 0x90, 0x4b, 0xa3, 0x1b, 0xa1, 0xb2,
+  0x2f, 0xbb, 0xaa, 0xf7, 0x50, 0x77, 0x03, 0x1a, 0xbb, 0xdf, 0xc3, 0x83,
+  0x08, 0xda, 0xb2, 0x1b, 0x81, 0xdb, 0x56, 0x92, 0x29, 0x21, 0x58, 0x65,
+  0x30, 0xe9, 0x08, 0xa7, 0x50, 0x0e, 0x6d, 0xbe, 0xed, 0xa0, 0x5f, 0x90,
+  0x47, 0x1e, 0xde, 0xe2, 0x57, 0x3b, 0x62, 0x82, 0x2f, 0x64, 0x22, 0xb0,
+  0xb0, 0xa4, 0x78, 0x24, 0xf8, 0x0a, 0xb7, 0x85, 0x50, 0xcc, 0x26, 0x9a,
+  0x2f, 0x4a, 0x3b, 0xf1, 0x19, 0x37, 0xfc, 0x1f, 0x4c, 0xcc, 0x92, 0x09,
+  0x31, 0x21, 0x54, 0xa5, 0x93, 0xa3, 0xf1, 0x78, 0x4c, 0xea, 0xd3, 0xb8,
+  0xab, 0xce, 0x34, 0xee, 0xda, 0xc5, 0xd5, 0xc9, 0x3d, 0x73, 0xbe, 0x82,
+  0x4c, 0x30, 0x63, 0x66, 0x41, 0x5f, 0x01, 0x5f, 0x72, 0x53, 0x31, 0x09,
+  0x3c, 0x9f, 0x05, 0xee, 0xac, 0x20, 0x25, 0xa1, 0xc4, 0xcc, 0x92, 0x63,
+  0x51, 0x14, 0x11, 0x20, 0x49, 0x7d, 0xf7, 0x9d, 0x3c, 0xd6, 0x15, 0xc4,
+  0xdd, 0x87, 0x6e, 0xca, 0xe3, 0x71, 0xcb, 0xe7, 0xe9, 0x7c, 0x63, 0x2c,
+  0x2e, 0xef, 0xb4, 0x9f, 0x3b, 0x7e, 0x95, 0x52, 0x0f, 0x69, 0x25, 0x17,
+  0x69, 0x83, 0x75, 0x71, 0x9a, 0x38, 0xbf, 0x3d, 0x07, 0xee, 0xbc, 0xd1,
+  0x4e, 0x78, 0xcd, 0xf3, 0x20, 0x1d, 0xb5, 0x5e, 0x4c, 0xe3, 0x6a, 0xdf,
+  0xde, 0x3b, 0xd4, 0x80, 0x3f, 0x0a, 0x41, 0x99, 0x61, 0x4f, 0x98, 0x7f,
+  0xe4, 0xe7, 0xfc, 0x29, 0xf3, 0x35, 0x2f, 0xf8, 0x53, 0xa7, 0x33, 0x63,
+  0x29, 0x1d, 0x19, 0x52, 0xda, 0x72, 0x38, 0xd7, 0x6a, 0xf9, 0xb8, 0x13,
+  0xa4, 0x76, 0x5d, 0x90, 0xf4, 0x09, 0xa8, 0x3f, 0x2a, 0xcb, 0x97, 0xf8,
+  0xa8, 0x79, 0xed, 0x45, 0x77, 0xb6, 0x60, 0x5a, 0xeb, 0x98, 0xb2, 0xde,
+  0xa5, 0x99, 0x62, 0xe0, 0xc6, 0xf2, 0xac, 0xcf, 0xf1, 0xbd, 0x8a, 0x04,
+  0x69, 0xe7, 0x67, 0xb2, 0x97, 0xe1, 0x86, 0x17, 0xa4, 0xc7, 0xbd, 0x63,
+  0x2d, 0xe8, 0x03, 0xfb, 0x73, 0xa5, 0xd7, 0x8c, 0xfa, 0x79, 0x0f, 0xa0,
+  0xe8, 0x98, 0xdf, 0x83, 0x70, 0x5a, 0x57, 0x82, 0x67, 0xcc, 0xa2, 0xd9,
+  0x85, 0xc8, 0x7b, 0xee, 0xf7, 0x60, 0xfc, 0x5e, 0x63, 0xbd, 0xef, 0xc2,
+  0xdf, 0x9e, 0xf3, 0x5d, 0x11, 0x68, 0x44, 0xa0, 0xa1, 0xa8, 0x76, 0xcd,
+  0xdd, 0xfb, 0x23, 0xc6, 0x94, 0x44, 0x97, 0x30, 0x69, 0xe1, 0x3d, 0x4d,
+  0x3c, 0xda, 0x3e, 0xaf, 0x7e, 0xb2, 0x3d, 0xe1, 0xc7, 0x6b, 0x6a, 0x35,
+  0xfd, 0x97, 0xe9, 0x5b, 0x95, 0x23, 0xad, 0xc8, 0xd2, 0xbf, 0xbc, 0x5c,
+  0x20, 0x84, 0x66, 0xd0, 0xbf, 0x5f, 0xcd, 0xe7, 0x17, 0xfd, 0xcb, 0xfc,
+  0xed, 0x55, 0x4f, 0xbf, 0xda, 0x50, 0xd8, 0xfd, 0x5b, 0x9f, 0xe1, 0x86,
+  0x13, 0x3b, 0xe8, 0xd8, 0x76, 0x53, 0x6c, 0xdd, 0x18, 0x7b, 0x97, 0xab,
+  0xc6, 0xa3, 0xc0, 0x49, 0xbb, 0xd9, 0x8e, 0x7b, 0xbf, 0xa8, 0xa7, 0x18,
+  0x94, 0x1a, 0x8b, 0x59, 0x10, 0x07, 0xe9, 0x2b, 0xd2, 0x05, 0xab, 0xe0,
+  0xb5, 0x92, 0x05, 0x5f, 0xd4, 0x9a, 0xda, 0x44, 0xc9, 0x69, 0xcc, 0x52,
+  0xf8, 0x17, 0xee, 0xf4, 0xe8, 0xe2, 0xd0, 0xd4, 0x3b, 0x41, 0x7a, 0xd9,
+  0x10, 0x4e, 0xe1, 0x5e, 0x93, 0x99, 0x4c, 0xf3, 0xca, 0x12, 0x15, 0xc7,
+  0x04, 0x56, 0xd3, 0x9d, 0xa2, 0x0d, 0x30, 0xad, 0xa9, 0x7d, 0x80, 0x19,
+  0xf0, 0x29, 0x36, 0x01, 0xe0, 0x8a, 0x72, 0x66, 0xa0, 0x54, 0xc2, 0x2d,
+  0x36, 0x50, 0x52, 0x6c, 0x80, 0x42, 0x80, 0x82, 0xa3, 0xc8, 0x0d, 0x91,
+  0xcc, 0xba, 0x9b, 0x4b, 0x2e, 0x30, 0x9f, 0x78, 0x2c, 0x89, 0x6b, 0x68,
+  0x03, 0xea, 0xe0, 0x94, 0x44, 0x68, 0x83, 0x6c, 0x01, 0x01, 0x59, 0x56,
+  0x46, 0x40, 0x79, 0x25, 0x08, 0x4e, 0x11, 0x71, 0xe9, 0x51, 0x6f, 0xb4,
+  0x5a, 0x1b, 0xd4, 0xd1, 0xe1, 0xc1, 0x8a, 0x69, 0xb8, 0x7c, 0xf9, 0xe7,
+  0xf5, 0xd5, 0xbb, 0x8f, 0x73, 0x98, 0xd1, 0x32, 0x1d, 0x82, 0x93, 0x11,
+  0xf9, 0xe9, 0x33, 0x1d, 0x54, 0xd4, 0x32, 0x73, 0x91, 0x03, 0x8a, 0x90,
+  0xe7, 0x03, 0xd8, 0x82, 0x46, 0x5b, 0x6b, 0x09, 0xb9, 0xca, 0xea, 0x25,
+  0x9d, 0x10, 0x2d, 0xd0, 0x9e, 0x09, 0x74, 0xe4, 0xab, 0xcd, 0x45, 0xee,
+  0x94, 0x26, 0x70, 0xbb, 0x63, 0xa8, 0x51, 0xd2, 0x2e, 0x0f, 0xc9, 0xf4,
+  0xf0, 0x00, 0xc0, 0x1d, 0x27, 0xd5, 0x9a, 0xe0, 0x4f, 0xa9, 0x73, 0x23,
+  0x22, 0xc3, 0xc1, 0xd0, 0xdf, 0xd7, 0xc4, 0x0a, 0x82, 0x89, 0xd3, 0x71,
+  0xe7, 0x47, 0x34, 0x20, 0x67, 0xe4, 0x7b, 0xd8, 0xe3, 0x84, 0x55, 0x0b,
+  0x01, 0x8d, 0xfa, 0x33, 0xd2, 0x6f, 0x9a, 0x28, 0x4f, 0x03, 0x78, 0x06,
+  0x15, 0x81, 0xe5, 0x48, 0x44, 0x40, 0x35, 0xcd, 0x7b, 0xf6, 0x25, 0xb3,
+  0x65, 0xe4, 0xef, 0x9d, 0x30, 0x74, 0x07, 0x8f, 0x48, 0x91, 0xd9, 0x01,
+  0xc4, 0x14, 0xea, 0xf1, 0xf1, 0x00, 0x9e, 0x35, 0x90, 0xdd, 0xdf, 0xbe,
+  0x71, 0x15, 0x69, 0x63, 0xf8, 0x03, 0xcc, 0x2a, 0x32, 0x52, 0x47, 0x56,
+  0x9d, 0xf3, 0xaf, 0x98, 0x87, 0x27, 0x83, 0x47, 0x14, 0x6e, 0x5c, 0x83,
+  0x3e, 0x0d, 0x1e, 0x56, 0x51, 0xbf, 0x05, 0xe0, 0x17, 0x08, 0x36, 0x34,
+  0xc8, 0x90, 0x40, 0x20, 0x55, 0xb0, 0x83, 0xe8, 0x9a, 0xb9, 0x49, 0xcb,
+  0xed, 0xc0, 0x3f, 0xa8, 0x10, 0x7d, 0x23, 0x0f, 0x22, 0x4e, 0x37, 0x8e,
+  0xfe, 0xf5, 0xc3, 0xe5, 0x1b, 0x4a, 0x9f, 0x4b, 0x0b, 0xa9, 0xdc, 0x36,
+  0x45, 0x35, 0xaa, 0xd6, 0x19, 0x12, 0xdb, 0x35, 0xca, 0x99, 0x6b, 0x86,
+  0xb9, 0xe7, 0x84, 0x41, 0xdc, 0xf4, 0x5a, 0xe0, 0xf0, 0x1a, 0xad, 0x48,
+  0x49, 0x55, 0xa1, 0x24, 0xe5, 0xbb, 0x74, 0xbb, 0x5a, 0xbb, 0xb3, 0xfc,
+  0xd5, 0x36, 0x88, 0xdc, 0x05, 0xfb, 0xba, 0xf9, 0x22, 0x72, 0x95, 0xf2,
+  0x5c, 0x2a, 0xf4, 0x2e, 0x04, 0x6a, 0xad, 0xf4, 0xff, 0xc0, 0xa0, 0x25,
+  0xba, 0x7b, 0x61, 0xee, 0xc3, 0xd1, 0x05, 0xef, 0x9d, 0x7e, 0x43, 0xdb,
+  0x19, 0x09, 0x3a, 0x6c, 0x07, 0x65, 0xb8, 0x03, 0x8f, 0x3b, 0x4d, 0xe5,
+  0xa5, 0x84, 0xfa, 0xdb, 0xfc, 0xdd, 0xdb, 0xa8, 0x72, 0x5f, 0x78, 0x21,
+  0x46, 0x39, 0xb3, 0xac, 0xc9, 0x1a, 0x2f, 0x68, 0xb1, 0x38, 0x95, 0xa8,
+  0xa8, 0x85, 0x18, 0xec, 0xf5, 0x38, 0x00, 0xd5, 0x01, 0x42, 0x87, 0xf2,
+  0x05, 0x37, 0x6e, 0x44, 0xbc, 0x66, 0xdf, 0x6e, 0xce, 0x96, 0xa2, 0x20,
+  0xd9, 0x60, 0x00, 0x2d, 0x71, 0x2f, 0x16, 0x6f, 0xf0, 0x89, 0x04, 0x0d,
+  0xde, 0xad, 0x6f, 0xe3, 0xb6, 0xf1, 0x5d, 0x49, 0x06, 0x4f, 0x05, 0xd6,
+  0x4e, 0xec, 0xb7, 0x22, 0xab, 0xbe, 0x1d, 0x55, 0xdb, 0xf3, 0xb3, 0x96,
+  0x88, 0x34, 0xd2, 0x17, 0x19, 0x95, 0x38, 0xfe, 0x34, 0x4d, 0x7f, 0xfc,
+  0x1c, 0x2f, 0x86, 0x34, 0x52, 0x9d, 0x26, 0xb3, 0x7b, 0x43, 0xd7, 0x0c,
+  0xc2, 0x02, 0xaf, 0x97, 0xe6, 0x6e, 0xe8, 0x6a, 0x69, 0x4a, 0x5e, 0x58,
+  0x1a, 0xb5, 0x3e, 0x69, 0x9e, 0x2f, 0x50, 0x2e, 0x6c, 0x09, 0x69, 0xbf,
+  0x29, 0x9a, 0x04, 0x46, 0x95, 0xaa, 0xc2, 0x46, 0xf5, 0x41, 0xb0, 0x68,
+  0x2f, 0xdc, 0xaa, 0x5b, 0x31, 0x11, 0x36, 0xb2, 0x61, 0x33, 0x70, 0x13,
+  0xff, 0xa9, 0xd5, 0xed, 0xc4, 0x69, 0xdc, 0xef, 0xe1, 0xf6, 0x5b, 0xfd,
+  0x3f, 0x4b, 0xbb, 0xe1, 0xb4, 0xc5, 0x0b, 0x00, 0x00
+};
+const size_t STATUS_PAGE_GZ_LENGTH = sizeof(STATUS_PAGE_GZ);
+
+#endif // STATUS_PAGE_H
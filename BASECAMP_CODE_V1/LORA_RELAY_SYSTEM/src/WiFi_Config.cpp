@@ -1,4 +1,9 @@
 #include "WiFi_Config.h"
+#include "LoRa_Relay.h"
+#include "Metrics.h"
+#include "StatusEvents.h"
+
+#define RECENT_PACKETS_SHOWN 10
 
 // External references
 extern String ssid;
@@ -11,6 +16,10 @@ bool wifiConnected = false;
 unsigned long lastWiFiCheck = 0;
 const unsigned long WIFI_CHECK_INTERVAL = 30000; // 30 seconds
 
+// Routes are registered once; the server itself is started and stopped
+bool routesRegistered = false;
+bool serverRunning = false;
+
 bool initializeWiFi() {
   Serial.println("=== Initializing WiFi ===");
   
@@ -23,6 +32,7 @@ bool initializeWiFi() {
     if (connectToWiFi(ssid, password)) {
       Serial.println("WiFi connected successfully");
       wifiConnected = true;
+      startStatusServer();
       return true;
     } else {
       Serial.println("Failed to connect to saved WiFi");
@@ -90,21 +100,46 @@ bool startConfigPortal() {
   Serial.print("Config portal started at: ");
   Serial.println(WiFi.softAPIP());
   
-  // Setup web server routes
-  server.on("/", HTTP_GET, handleRoot);
-  server.on("/config", HTTP_GET, handleConfig);
-  server.on("/save", HTTP_POST, handleSave);
-  server.on("/relay", HTTP_GET, handleRelay);
-  server.on("/api/status", HTTP_GET, handleAPI);
-  
-  server.begin();
+  startWebServer();
   configMode = true;
   
   return true;
 }
 
+// Configuration pages only answer clients on the portal's access point;
+// status, API and metrics are also served on the station network
+void registerWebRoutes() {
+  if (routesRegistered) return;
+  routesRegistered = true;
+  
+  server.on("/", HTTP_GET, handleRoot).setFilter(ON_AP_FILTER);
+  server.on("/config", HTTP_GET, handleConfig).setFilter(ON_AP_FILTER);
+  server.on("/save", HTTP_POST, handleSave).setFilter(ON_AP_FILTER);
+  server.on("/relay", HTTP_GET, handleStatusPage);
+  server.on("/api/status", HTTP_GET, handleAPI);
+  server.on("/metrics", HTTP_GET, handleMetrics);
+  registerStatusEvents();
+}
+
+void startWebServer() {
+  registerWebRoutes();
+  if (serverRunning) return;
+  
+  server.begin();
+  serverRunning = true;
+}
+
+// Lets a local Prometheus scrape /metrics once the relay is on the network
+void startStatusServer() {
+  startWebServer();
+  Serial.print("Status server at http://");
+  Serial.print(WiFi.localIP());
+  Serial.println("/relay (metrics on /metrics)");
+}
+
 void stopConfigPortal() {
   server.end();
+  serverRunning = false;
   WiFi.softAPdisconnect(true);
   configMode = false;
   Serial.println("Configuration portal stopped");
@@ -137,7 +172,7 @@ void handleRoot(AsyncWebServerRequest *request) {
   html += "<input type='password' name='password' placeholder='WiFi Password'>";
   html += "<button type='submit'>Save & Connect</button>";
   html += "</form>";
-  html += "<p><a href='/relay'>View Relay Status</a> | <a href='/api/status'>API Status</a></p>";
+  html += "<p><a href='/relay'>View Relay Status</a> | <a href='/api/status'>API Status</a> | <a href='/metrics'>Metrics</a></p>";
   html += "</div></body></html>";
   
   request->send(200, "text/html", html);
@@ -181,6 +216,7 @@ void handleSave(AsyncWebServerRequest *request) {
   if (connectToWiFi(ssid, password)) {
     wifiConnected = true;
     Serial.println("WiFi connected after configuration");
+    startStatusServer();
   } else {
     Serial.println("Failed to connect, restarting config portal");
     delay(2000);
@@ -188,34 +224,6 @@ void handleSave(AsyncWebServerRequest *request) {
   }
 }
 
-void handleRelay(AsyncWebServerRequest *request) {
-  String html = "<!DOCTYPE html><html><head>";
-  html += "<title>LoRa Relay Status</title>";
-  html += "<meta http-equiv='refresh' content='10'>";
-  html += "<style>body{font-family:Arial;margin:20px;background:#f0f0f0}";
-  html += ".container{background:white;padding:20px;border-radius:10px}";
-  html += ".status{background:#e8f4f8;padding:10px;border-radius:5px;margin:10px 0}";
-  html += ".stat{display:inline-block;margin:10px;padding:10px;background:#f8f8f8;border-radius:5px}";
-  html += "</style></head><body>";
-  html += "<div class='container'>";
-  html += "<h1>LoRa Relay Status</h1>";
-  html += "<div class='status'>";
-  html += "<h3>System Status</h3>";
-  html += "<p><strong>Relay ID:</strong> " + relayId + "</p>";
-  html += "<p><strong>LoRa Status:</strong> " + getLoRaRelayStatus() + "</p>";
-  html += "<p><strong>WiFi Status:</strong> " + getWiFiStatus() + "</p>";
-  html += "<p><strong>Last Received From:</strong> " + lastReceivedFrom + "</p>";
-  html += "</div>";
-  html += "<h3>Statistics</h3>";
-  html += "<div class='stat'>Received: " + String(getTotalReceivedPackets()) + "</div>";
-  html += "<div class='stat'>Forwarded: " + String(getTotalForwardedPackets()) + "</div>";
-  html += "<div class='stat'>Duplicates: " + String(getTotalDuplicatePackets()) + "</div>";
-  html += "<p><a href='/'>Back to Configuration</a></p>";
-  html += "</div></body></html>";
-  
-  request->send(200, "text/html", html);
-}
-
 void handleAPI(AsyncWebServerRequest *request) {
   JsonDocument doc;
   doc["relay_id"] = relayId;
@@ -227,6 +235,26 @@ void handleAPI(AsyncWebServerRequest *request) {
   doc["stats"]["duplicates"] = getTotalDuplicatePackets();
   doc["uptime"] = millis();
   
+  HistoryStats history = getHistoryStats();
+  doc["history"]["records"] = history.records;
+  doc["history"]["nodes"] = history.nodes;
+  doc["history"]["payload_bytes"] = history.slabUsed;
+  
+  JsonArray recent = doc["recent"].to<JsonArray>();
+  unsigned long now = millis();
+  lockHistory();
+  size_t shown = min(historySize(), (size_t)RECENT_PACKETS_SHOWN);
+  for (size_t i = 0; i < shown; i++) {
+    const HistoryRecord& record = historyNewest(i);
+    JsonObject entry = recent.add<JsonObject>();
+    entry["node_id"] = historyNodeId(record);
+    entry["age_ms"] = now - record.timestamp;
+    entry["rssi"] = record.rssi;
+    entry["snr"] = record.snrQuarterDb / 4.0;
+    entry["forwarded"] = (bool)record.forwarded;
+  }
+  unlockHistory();
+  
   String jsonString;
   serializeJson(doc, jsonString);
   
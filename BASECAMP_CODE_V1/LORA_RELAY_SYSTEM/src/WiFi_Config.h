@@ -10,6 +10,9 @@ void loadWiFiConfig();
 void saveWiFiConfig();
 bool startConfigPortal();
 void stopConfigPortal();
+void registerWebRoutes();
+void startWebServer();
+void startStatusServer();
 void handleWiFiConfig();
 bool connectToWiFi(const String& ssid, const String& password);
 
@@ -17,7 +20,6 @@ bool connectToWiFi(const String& ssid, const String& password);
 void handleRoot(AsyncWebServerRequest *request);
 void handleConfig(AsyncWebServerRequest *request);
 void handleSave(AsyncWebServerRequest *request);
-void handleRelay(AsyncWebServerRequest *request);
 void handleAPI(AsyncWebServerRequest *request);
 
 // === WIFI STATUS ===
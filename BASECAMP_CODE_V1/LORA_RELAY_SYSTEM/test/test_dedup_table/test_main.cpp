@@ -0,0 +1,178 @@
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "DedupTable.h"
+
+// === SETTINGS ===
+#define WINDOW       60000   // ms, PACKET_DUPLICATE_WINDOW
+#define BENCH_ROUNDS 20      // Per size, fresh containers each round
+
+// [env:native] builds with 32768 slots rather than the device's 1024, so
+// 10k entries sit at ~30% load, inside the under-50% the table is sized for
+static DedupTable table(WINDOW);
+
+void setUp() {
+  table.clear();
+}
+
+void tearDown() {}
+
+// Hashes that all share a home slot, so they land in one probe chain
+static uint64_t sameHome(uint64_t i) {
+  return (i * DEDUP_TABLE_SIZE) | 5;
+}
+
+// === TESTS ===
+void test_repeat_within_window_is_duplicate() {
+  TEST_ASSERT_FALSE(table.checkAndInsert(42, 59990));
+  // Crosses a minute boundary but not the window
+  TEST_ASSERT_TRUE(table.checkAndInsert(42, 60010));
+  TEST_ASSERT_EQUAL(1, table.size());
+  TEST_ASSERT_EQUAL(1, table.getStats().duplicates);
+}
+
+void test_repeat_after_window_is_new() {
+  TEST_ASSERT_FALSE(table.checkAndInsert(42, 1000));
+  TEST_ASSERT_FALSE(table.checkAndInsert(42, 1000 + WINDOW));
+  // The late sighting restarts the window
+  TEST_ASSERT_TRUE(table.checkAndInsert(42, 1000 + WINDOW + 1));
+}
+
+void test_zero_hash_is_still_tracked() {
+  TEST_ASSERT_FALSE(table.checkAndInsert(0, 100));
+  TEST_ASSERT_TRUE(table.checkAndInsert(0, 200));
+}
+
+void test_aging_empties_the_table() {
+  for (uint64_t i = 1; i <= 500; i++) {
+    table.checkAndInsert(i * 0x9E3779B97F4A7C15ULL, 0);
+  }
+  TEST_ASSERT_EQUAL(500, table.size());
+
+  // One full pass of the cursor; each removal spends a step in place
+  for (size_t i = 0; i <= (DEDUP_TABLE_SIZE + 500) / DEDUP_AGING_STEP; i++) {
+    table.age(WINDOW, DEDUP_AGING_STEP);
+  }
+  TEST_ASSERT_EQUAL(0, table.size());
+}
+
+void test_removal_keeps_colliding_chain_reachable() {
+  // Older half first in the chain, so aging punches holes ahead of the rest
+  for (uint64_t i = 1; i <= 50; i++) {
+    table.checkAndInsert(sameHome(i), i < 25 ? 0 : 30000);
+  }
+  TEST_ASSERT_EQUAL(49, table.getStats().maxProbe);
+
+  for (size_t i = 0; i <= DEDUP_TABLE_SIZE / DEDUP_AGING_STEP; i++) {
+    table.age(WINDOW + 1000, DEDUP_AGING_STEP);
+  }
+  TEST_ASSERT_EQUAL(26, table.size());
+  for (uint64_t i = 25; i <= 50; i++) {
+    TEST_ASSERT_TRUE(table.checkAndInsert(sameHome(i), WINDOW + 1001));
+  }
+}
+
+void test_full_table_evicts_oldest() {
+  // No time passes, so nothing ages out and every slot stays live
+  for (uint64_t i = 1; i <= DEDUP_TABLE_SIZE; i++) {
+    table.checkAndInsert(i, i == 7 ? 0 : 1000);
+  }
+  TEST_ASSERT_EQUAL(DEDUP_TABLE_SIZE, table.size());
+
+  TEST_ASSERT_FALSE(table.checkAndInsert(DEDUP_TABLE_SIZE + 1, 1000));
+  TEST_ASSERT_EQUAL(1, table.getStats().evictions);
+  TEST_ASSERT_TRUE(table.checkAndInsert(DEDUP_TABLE_SIZE + 1, 1000));
+  // Hash 7 was the oldest and made room
+  TEST_ASSERT_FALSE(table.checkAndInsert(7, 1000));
+}
+
+// === BENCHMARK ===
+// Against what the table replaced: std::map<String, unsigned long> keyed
+// by the hash as a hex string, looked up, then assigned. std::string
+// stands in for Arduino's String off the device, and the hex key is built
+// inside the timed loop as generatePacketHash() did. Random hashes, every
+// entry live; "insert" is a first sighting and "lookup" the duplicate that
+// follows it.
+static std::string hexKey(uint64_t hash) {
+  char buffer[17];
+  snprintf(buffer, sizeof(buffer), "%llx", (unsigned long long)hash);
+  return std::string(buffer);
+}
+
+static double nanosPer(std::chrono::steady_clock::time_point start, size_t count) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+static void benchmark(size_t entries) {
+  std::mt19937_64 rng(entries);
+  std::vector<uint64_t> hashes(entries);
+  for (auto& hash : hashes) hash = rng() | 1;
+
+  double mapInsert = 0, mapLookup = 0, tableInsert = 0, tableLookup = 0;
+  size_t mapDuplicates = 0, tableDuplicates = 0;
+
+  for (int round = 0; round < BENCH_ROUNDS; round++) {
+    std::map<std::string, unsigned long> packetHashes;
+    for (int pass = 0; pass < 2; pass++) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint64_t hash : hashes) {
+        std::string key = hexKey(hash);
+        auto it = packetHashes.find(key);
+        if (it != packetHashes.end() && 1000UL + pass - it->second < WINDOW) {
+          mapDuplicates++;
+          continue;
+        }
+        packetHashes[key] = 1000UL + pass;
+      }
+      (pass == 0 ? mapInsert : mapLookup) += nanosPer(start, entries);
+    }
+
+    table.clear();
+    for (int pass = 0; pass < 2; pass++) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint64_t hash : hashes) {
+        tableDuplicates += table.checkAndInsert(hash, 1000 + pass);
+      }
+      (pass == 0 ? tableInsert : tableLookup) += nanosPer(start, entries);
+    }
+  }
+
+  TEST_ASSERT_EQUAL(entries * BENCH_ROUNDS, mapDuplicates);
+  TEST_ASSERT_EQUAL(entries * BENCH_ROUNDS, tableDuplicates);
+  TEST_ASSERT_EQUAL(0, table.getStats().evictions);
+
+  char message[200];
+  snprintf(message, sizeof(message),
+           "%u entries: String map insert %.0f ns, lookup %.0f ns | DedupTable insert %.0f ns, lookup %.0f ns, max probe %u",
+           (unsigned)entries, mapInsert / BENCH_ROUNDS, mapLookup / BENCH_ROUNDS,
+           tableInsert / BENCH_ROUNDS, tableLookup / BENCH_ROUNDS, (unsigned)table.getStats().maxProbe);
+  TEST_MESSAGE(message);
+
+  TEST_ASSERT_LESS_THAN_DOUBLE(mapInsert, tableInsert);
+  TEST_ASSERT_LESS_THAN_DOUBLE(mapLookup, tableLookup);
+}
+
+void test_benchmark_1k_entries() {
+  benchmark(1000);
+}
+
+void test_benchmark_10k_entries() {
+  benchmark(10000);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_repeat_within_window_is_duplicate);
+  RUN_TEST(test_repeat_after_window_is_new);
+  RUN_TEST(test_zero_hash_is_still_tracked);
+  RUN_TEST(test_aging_empties_the_table);
+  RUN_TEST(test_removal_keeps_colliding_chain_reachable);
+  RUN_TEST(test_full_table_evicts_oldest);
+  RUN_TEST(test_benchmark_1k_entries);
+  RUN_TEST(test_benchmark_10k_entries);
+  return UNITY_END();
+}
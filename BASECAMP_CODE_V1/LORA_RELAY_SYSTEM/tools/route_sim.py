@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Valley simulation of LoRa relay forwarding: airtime per delivered packet.
+
+Compares the old blind rebroadcast (every relay re-sends every frame it
+hears, wrapped in {"relay","data"}) with distance-vector routing plus
+suppression (Routing.cpp) at a given hold per hop.
+
+Model:
+- Basecamp at x=0; relays scattered along a 6-unit valley; every node hears
+  every other node within RANGE units.
+- Airtime uses the same Semtech formula as loraAirtimeMs() (SF7/BW125/CR4/5).
+- A frame is received only if no other frame audible at the receiver
+  overlaps it and the receiver is not transmitting (no capture effect).
+- A relay reads a received frame up to LOOP_LATENCY ms after it ends,
+  since loop() polls the radio with delay(100) between passes.
+- Each hiker packet is simulated on its own; packets do not interfere.
+- Beacon airtime (basecamp and relays, one per 32.5 s on average) is added
+  for routing; 10 hikers report every 30 s.
+
+Usage: python3 tools/route_sim.py [--seeds 20] [--packets 2000]
+"""
+
+import argparse
+import heapq
+import math
+import random
+
+SF, BW, CR, PREAMBLE = 7, 125000, 1, 8
+RANGE = 1.6
+LOOP_LATENCY = 200          # ms, ROUTE_LOOP_LATENCY
+SUPPRESS_JITTER = 100       # ms, ROUTE_SUPPRESS_JITTER
+MAX_PACKET = 255
+HIKER_BYTES = 110
+FRAME_HEADER = len('{"to":"RELAY_01","fr":"RELAY_02","dst":"BASECAMP_01","h":1,"c":2,"data":}')
+WRAP_HEADER = len('{"relay":"RELAY_01","data":}')
+BEACON_BYTES = len('{"rb":"RELAY_01","r":[["BASECAMP_01",65540,2,80,"RELAY_02"]]}')
+BEACON_PERIOD = 32.5        # s, ROUTE_BEACON_INTERVAL plus mean jitter
+HIKERS, REPORT_PERIOD = 10, 30.0
+
+
+def airtime(length):
+    symbol = (2 ** SF) / BW * 1000
+    payload = 8 + max(math.ceil((8 * length - 4 * SF + 28 + 16) / (4 * SF)), 0) * (CR + 4)
+    return (PREAMBLE + 4.25) * symbol + payload * symbol
+
+
+def topology(seed, relays=6):
+    rng = random.Random(seed)
+    nodes = {"BC": (0.0, 0.0)}
+    for i in range(relays):
+        nodes["R%d" % i] = (rng.uniform(0.6, 6.0), rng.uniform(-0.4, 0.4))
+    neighbours = {a: [b for b in nodes if b != a and math.dist(nodes[a], nodes[b]) <= RANGE]
+                  for a in nodes}
+    hops = {"BC": 0}
+    queue = ["BC"]
+    while queue:
+        a = queue.pop(0)
+        for b in neighbours[a]:
+            if b not in hops:
+                hops[b] = hops[a] + 1
+                queue.append(b)
+    return nodes, neighbours, hops
+
+
+class Air:
+    """Transmissions so far, for collision checks at each receiver."""
+
+    def __init__(self, positions):
+        self.positions = positions
+        self.log = []           # (start, end, sender)
+        self.total = 0.0
+
+    def send(self, sender, start, length):
+        end = start + airtime(length)
+        self.log.append((start, end, sender))
+        self.total += end - start
+        return end
+
+    def received(self, receiver, sender, start, end):
+        for other_start, other_end, other in self.log:
+            if other == sender and other_start == start:
+                continue
+            if other_start < end and start < other_end:
+                if other == receiver or self.audible(receiver, other):
+                    return False
+        return True
+
+    def audible(self, a, b):
+        return b in self.positions and math.dist(self.positions[a], self.positions[b]) <= RANGE
+
+
+def hears(positions, point, node):
+    return math.dist(point, positions[node]) <= RANGE
+
+
+def simulate_blind(rng, positions, neighbours, hiker):
+    """Each relay re-sends every distinct frame it reads, one wrapper deeper."""
+    air = Air(positions)
+    events = []   # (time, seq, kind, node, frame_id, length, sender, start, end)
+    seq = 0
+    hiker_end = airtime(HIKER_BYTES)
+    delivered = False
+    for node in positions:
+        if hears(positions, hiker, node):
+            heapq.heappush(events, (hiker_end, seq, "rx", node, ("H",), HIKER_BYTES, "H", 0.0, hiker_end))
+            seq += 1
+    seen = set()
+    while events:
+        time, _, kind, node, frame, length, sender, start, end = heapq.heappop(events)
+        if kind == "rx":
+            if sender != "H" and not air.received(node, sender, start, end):
+                continue
+            if node == "BC":
+                delivered = True
+                continue
+            if (node, frame) in seen:
+                continue
+            seen.add((node, frame))
+            heapq.heappush(events, (time + rng.uniform(0, LOOP_LATENCY), seq, "tx", node, frame, length, node, 0, 0))
+            seq += 1
+        else:
+            out = length + WRAP_HEADER
+            if out > MAX_PACKET:
+                continue
+            tx_start = time
+            tx_end = air.send(node, tx_start, out)
+            wrapped = frame + (node,)
+            for other in neighbours[node]:
+                heapq.heappush(events, (tx_end, seq, "rx", other, wrapped, out, node, tx_start, tx_end))
+                seq += 1
+    return air.total, delivered
+
+
+def simulate_routed(rng, positions, neighbours, hops, hiker, slot):
+    """Hold by hops * slot, drop on overhearing a closer relay, unicast toward BC."""
+    air = Air(positions)
+    events = []   # (time, seq, kind, node, hops_so_far, sender, start, end, target)
+    seq = 0
+    hiker_end = airtime(HIKER_BYTES)
+    delivered = False
+    held = {}
+    heard = set()   # Relays that already have the packet; dedup drops later copies
+    suppressed = 0
+    frame_length = HIKER_BYTES + FRAME_HEADER
+
+    def next_hop(node):
+        return min((n for n in neighbours[node] if n in hops), key=lambda n: hops[n])
+
+    def transmit(node, time, hop_count):
+        nonlocal seq
+        start = time
+        end = air.send(node, start, frame_length)
+        target = next_hop(node)
+        for other in neighbours[node]:
+            heapq.heappush(events, (end, seq, "rx", other, hop_count + 1, node, start, end, target))
+            seq += 1
+
+    for node in positions:
+        if hears(positions, hiker, node):
+            if node == "BC":
+                delivered = True
+            elif node in hops:
+                heard.add(node)
+                read = hiker_end + rng.uniform(0, LOOP_LATENCY)
+                held[node] = read + hops[node] * slot + rng.uniform(0, SUPPRESS_JITTER)
+                heapq.heappush(events, (held[node], seq, "fire", node, 0, None, 0, 0, None))
+                seq += 1
+
+    while events:
+        time, _, kind, node, hop_count, sender, start, end, target = heapq.heappop(events)
+        if kind == "fire":
+            if node in held:
+                del held[node]
+                transmit(node, time, 0)
+            continue
+        if kind == "read":
+            transmit(node, time, hop_count)
+            continue
+        if not air.received(node, sender, start, end):
+            continue
+        read = time + rng.uniform(0, LOOP_LATENCY)
+        if node == "BC":
+            if target == "BC":
+                delivered = True
+            continue
+        if target != node:
+            # Overheard: drop our held copy if the sender is at least as close
+            if node in held and hops[sender] <= hops[node] and read < held[node]:
+                del held[node]
+                suppressed += 1
+            continue
+        if hop_count < 8 and node not in heard:
+            heard.add(node)
+            heapq.heappush(events, (read, seq, "read", node, hop_count, None, 0, 0, None))
+            seq += 1
+    return air.total, delivered, suppressed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--seeds", type=int, default=20)
+    parser.add_argument("--packets", type=int, default=2000)
+    args = parser.parse_args()
+
+    slots = {"routed, 150 ms hold/hop": 150.0,
+             "routed, airtime+latency hold/hop": airtime(MAX_PACKET) + LOOP_LATENCY}
+    totals = {"blind rebroadcast": [0.0, 0, 0]}
+    totals.update({name: [0.0, 0, 0] for name in slots})
+    beacon_air = 0.0
+    reachable = 0
+
+    for seed in range(args.seeds):
+        positions, neighbours, hops = topology(seed)
+        rng = random.Random(seed * 7919)
+        routed_nodes = sum(1 for n in positions if n in hops)
+        duration = args.packets * REPORT_PERIOD / HIKERS
+        beacon_air += routed_nodes * duration / BEACON_PERIOD * airtime(BEACON_BYTES)
+        for _ in range(args.packets):
+            hiker = (rng.uniform(0, 6.5), rng.uniform(-0.5, 0.5))
+            reachable += any(n in hops and hears(positions, hiker, n) for n in positions)
+            air, ok = simulate_blind(random.Random(rng.random()), positions, neighbours, hiker)
+            totals["blind rebroadcast"][0] += air
+            totals["blind rebroadcast"][1] += ok
+            for name, slot in slots.items():
+                air, ok, suppressed = simulate_routed(random.Random(rng.random()), positions,
+                                                      neighbours, hops, hiker, slot)
+                totals[name][0] += air
+                totals[name][1] += ok
+                totals[name][2] += suppressed
+
+    sent = args.seeds * args.packets
+    print("%d seeds x %d packets, hold per hop with airtime+latency = %.0f ms"
+          % (args.seeds, args.packets, airtime(MAX_PACKET) + LOOP_LATENCY))
+    print("%.1f%% of packets were heard by a node with a path to the basecamp" % (100.0 * reachable / sent))
+    for name, (air, delivered, suppressed) in totals.items():
+        if name != "blind rebroadcast":
+            air += beacon_air
+        print("%-34s %7.0f ms airtime per delivered packet, delivered %5.1f%%, suppressed %d"
+              % (name, air / max(delivered, 1), 100.0 * delivered / sent, suppressed))
+
+
+if __name__ == "__main__":
+    main()
@@ -6,8 +6,10 @@
 #include "Display_Module.h"
 #include "LoRa_Module.h"
 #include "Firebase_Module.h"
+#include "Uplink_Module.h"
 #include "WiFi_Config.h"
 #include "Telemetry.h"
+#include "LocalAPI_Module.h"
 
 void setup() {
   Serial.begin(115200);
@@ -59,6 +61,7 @@ void setup() {
   display.display();
   
   bool loraSuccess = initializeLoRa(storedSync);
+  initializeRouteBeacons();
   
   display.clearDisplay();
   display.setCursor(0,0);
@@ -82,14 +85,47 @@ void setup() {
   // Initialize WiFi and Firebase
   initializeWiFi();
   
+  // From here on only the UI task draws the main screen
+  publishDisplaySnapshot();
+  startDisplayTask();
+  
   // Initial telemetry update
   updateTelemetry();
-  if (signupOK) {
-    sendTelemetryToFirebase();
+  publishTelemetryEvent();
+  sendTelemetryToCloud();
+}
+
+// === LOOP TIMING ===
+static unsigned long loopCount = 0;
+static unsigned long loopTotalMicros = 0;
+static unsigned long loopMaxMicros = 0;
+
+static void recordLoopTime(unsigned long elapsed) {
+  loopCount++;
+  loopTotalMicros += elapsed;
+  if (elapsed > loopMaxMicros) {
+    loopMaxMicros = elapsed;
+  }
+
+  static unsigned long lastReport = 0;
+  if (millis() - lastReport > 60000) {
+    DisplayStats ui = getDisplayStats();
+    Serial.printf("Loop: avg %lu us, max %lu us over %lu iterations\n",
+                  loopTotalMicros / loopCount, loopMaxMicros, loopCount);
+    Serial.printf("UI: %lu frames, %lu skipped, avg render %lu us, max %lu us\n",
+                  ui.framesRendered, ui.framesSkipped,
+                  ui.framesRendered > 0 ? ui.totalRenderMicros / ui.framesRendered : 0,
+                  ui.maxRenderMicros);
+    loopCount = 0;
+    loopTotalMicros = 0;
+    loopMaxMicros = 0;
+    lastReport = millis();
   }
 }
 
 void loop() {
+  unsigned long loopStart = micros();
+  
   // Check for config mode activation
   checkConfigButton();
   
@@ -101,9 +137,8 @@ void loop() {
   // Check if it's time to update telemetry
   if (millis() - lastTelemetryUpdate > telemetryInterval) {
     updateTelemetry();
-    if (signupOK) {
-      sendTelemetryToFirebase();
-    }
+    publishTelemetryEvent();
+    sendTelemetryToCloud();
     lastTelemetryUpdate = millis();
   }
 
@@ -126,8 +161,8 @@ void loop() {
     }
   }
 
-  // Update display
-  updateDisplay();
+  // Hand the current state to the UI task, rendering happens there
+  publishDisplaySnapshot();
   
   // Check SOS button
   if (digitalRead(SOSBUTTON) == LOW) {
@@ -137,15 +172,10 @@ void loop() {
     sos_status = false;
   }
   
-  // Check token status periodically
-  if (millis() - lastTokenCheck > tokenCheckInterval) {
-    lastTokenCheck = millis();
-    
-    // Check if token needs refresh
-    if (tokenNeedsRefresh) {
-      refreshFirebaseToken();
-    }
-  }
+  // Service the uplink backend (token refresh, MQTT session, offline queue)
+  handleUplink();
 
+  // Work time only, the delay below is idle
+  recordLoopTime(micros() - loopStart);
   delay(100);
 } 
\ No newline at end of file
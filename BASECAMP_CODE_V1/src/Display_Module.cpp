@@ -33,6 +33,14 @@ const unsigned char gps_icon_bitmap[] PROGMEM = {
 String loraStatus = "Waiting...";
 int packetCount = 0;
 
+// === UI TASK STATE ===
+static TaskHandle_t displayTaskHandle = NULL;
+static SemaphoreHandle_t displayMutex = NULL;      // Owns the panel and the I2C bus
+static portMUX_TYPE snapshotLock = portMUX_INITIALIZER_UNLOCKED;
+static DisplaySnapshot latestSnapshot;             // Written by loop(), read by the UI task
+static bool snapshotPublished = false;
+static DisplayStats displayStats = {0, 0, 0, 0};
+
 void initializeDisplay() {
   if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
     Serial.println("OLED failed");
@@ -66,12 +74,53 @@ void showSplash() {
   delay(2000);
 }
 
-void updateDisplay() {
-  // Don't update display if in config mode
-  if (configModeActive) {
-    return;
+// === UI TASK ===
+// loop() only copies its state into a snapshot; the UI task renders it at
+// most once per DISPLAY_FRAME_INTERVAL and skips frames that did not change.
+
+void lockDisplay() {
+  if (displayMutex != NULL) {
+    xSemaphoreTake(displayMutex, portMAX_DELAY);
   }
-  
+}
+
+void unlockDisplay() {
+  if (displayMutex != NULL) {
+    xSemaphoreGive(displayMutex);
+  }
+}
+
+static void copyField(char* dest, size_t size, const String& value) {
+  strncpy(dest, value.c_str(), size - 1);
+  dest[size - 1] = '\0';
+}
+
+void publishDisplaySnapshot() {
+  DisplaySnapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));  // Padding too, frames are compared with memcmp
+
+  // Node ID (truncated to avoid GPS icon overlap)
+  copyField(snapshot.nodeId, sizeof(snapshot.nodeId), nodeId);
+  snapshot.gpsEnabled = gpsEnabled;
+  snapshot.gpsValid = isGPSValid();
+  if (snapshot.gpsValid) {
+    snapshot.latitude = getCurrentLatitude();
+    snapshot.longitude = getCurrentLongitude();
+  }
+  copyField(snapshot.loraStatus, sizeof(snapshot.loraStatus), loraStatus);
+  snapshot.packetCount = packetCount;
+  snapshot.wifiRSSI = wifiRSSI;
+  snapshot.batteryVoltage = batteryVoltage;
+  snapshot.sosStatus = sos_status;
+  copyField(snapshot.uptime, sizeof(snapshot.uptime), getUptimeString());
+
+  portENTER_CRITICAL(&snapshotLock);
+  latestSnapshot = snapshot;
+  snapshotPublished = true;
+  portEXIT_CRITICAL(&snapshotLock);
+}
+
+static void renderDisplay(const DisplaySnapshot& snapshot) {
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(WHITE);
@@ -84,34 +133,19 @@ void updateDisplay() {
   const int line4 = 40;  // Additional info
   const int line5 = 50;  // SOS/Uptime (bottom line)
   
-  // Node ID (truncated to avoid GPS icon overlap)
   display.setCursor(0, line0);
-  String truncatedNodeId = nodeId;
-  if (truncatedNodeId.length() > 10) {
-    truncatedNodeId = truncatedNodeId.substring(0, 10);
-  }
-  display.println(truncatedNodeId);
+  display.println(snapshot.nodeId);
   
-  if (gpsEnabled) {
-    if (isGPSValid()) {
+  if (snapshot.gpsEnabled) {
+    if (snapshot.gpsValid) {
       // GPS coordinates - shortened format
       display.setCursor(0, line1);
       display.print("Lat:");
-      display.println(getCurrentLatitude(), 4);
+      display.println(snapshot.latitude, 4);
       
       display.setCursor(0, line2);
       display.print("Lng:");
-      display.println(getCurrentLongitude(), 4);
-      
-      // LoRa status - shortened
-      display.setCursor(0, line3);
-      display.print("LoRa:");
-      display.println(loraStatus);
-      
-      // Packet count
-      display.setCursor(0, line4);
-      display.print("Pkts:");
-      display.println(packetCount);
+      display.println(snapshot.longitude, 4);
     } else {
       // GPS waiting
       display.setCursor(0, line1);
@@ -120,53 +154,41 @@ void updateDisplay() {
       // WiFi RSSI - shortened
       display.setCursor(0, line2);
       display.print("WiFi:");
-      display.print(wifiRSSI);
+      display.print(snapshot.wifiRSSI);
       display.println("dBm");
-      
-      // LoRa status
-      display.setCursor(0, line3);
-      display.print("LoRa:");
-      display.println(loraStatus);
-      
-      // Packet count
-      display.setCursor(0, line4);
-      display.print("Pkts:");
-      display.println(packetCount);
     }
   } else {
     // No GPS mode - more space for other info
     display.setCursor(0, line1);
     display.print("WiFi:");
-    display.print(wifiRSSI);
+    display.print(snapshot.wifiRSSI);
     display.println("dBm");
     
     display.setCursor(0, line2);
     display.print("Batt:");
-    display.print(batteryVoltage, 2);
+    display.print(snapshot.batteryVoltage, 2);
     display.println("V");
-    
-    display.setCursor(0, line3);
-    display.print("LoRa:");
-    display.println(loraStatus);
-    
-    display.setCursor(0, line4);
-    display.print("Pkts:");
-    display.println(packetCount);
   }
   
+  // LoRa status - shortened
+  display.setCursor(0, line3);
+  display.print("LoRa:");
+  display.println(snapshot.loraStatus);
+  
+  // Packet count
+  display.setCursor(0, line4);
+  display.print("Pkts:");
+  display.println(snapshot.packetCount);
+  
   // SOS indicator or uptime (bottom line - no overlap)
   display.setCursor(0, line5);
-  if (sos_status) {
+  if (snapshot.sosStatus) {
     display.setTextColor(BLACK, WHITE); // Inverted for visibility
     display.print("SOS ACTIVE");
     display.setTextColor(WHITE); // Reset to normal
   } else {
     display.print("Up:");
-    String uptime = getUptimeString();
-    if (uptime.length() > 12) {
-      uptime = uptime.substring(0, 12); // Truncate if too long
-    }
-    display.print(uptime);
+    display.print(snapshot.uptime);
   }
   
   // GPS icon in top right (only if space available)
@@ -174,4 +196,55 @@ void updateDisplay() {
                      GPS_ICON_WIDTH, GPS_ICON_HEIGHT, WHITE);
                      
   display.display();
-} 
\ No newline at end of file
+}
+
+static void displayTask(void* parameter) {
+  DisplaySnapshot rendered;
+  bool haveRendered = false;
+  TickType_t lastWake = xTaskGetTickCount();
+
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(DISPLAY_FRAME_INTERVAL));
+
+    // The config portal owns the screen while it is active
+    if (configModeActive || !snapshotPublished) {
+      haveRendered = false;
+      continue;
+    }
+
+    DisplaySnapshot snapshot;
+    portENTER_CRITICAL(&snapshotLock);
+    snapshot = latestSnapshot;
+    portEXIT_CRITICAL(&snapshotLock);
+
+    if (haveRendered && memcmp(&snapshot, &rendered, sizeof(snapshot)) == 0) {
+      displayStats.framesSkipped++;
+      continue;
+    }
+
+    unsigned long start = micros();
+    lockDisplay();
+    renderDisplay(snapshot);
+    unlockDisplay();
+    unsigned long elapsed = micros() - start;
+
+    displayStats.framesRendered++;
+    displayStats.totalRenderMicros += elapsed;
+    if (elapsed > displayStats.maxRenderMicros) {
+      displayStats.maxRenderMicros = elapsed;
+    }
+    rendered = snapshot;
+    haveRendered = true;
+  }
+}
+
+void startDisplayTask() {
+  displayMutex = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(displayTask, "ui", DISPLAY_TASK_STACK_SIZE, NULL,
+                          DISPLAY_TASK_PRIORITY, &displayTaskHandle, DISPLAY_TASK_CORE);
+  Serial.println("UI task started");
+}
+
+DisplayStats getDisplayStats() {
+  return displayStats;
+}
\ No newline at end of file
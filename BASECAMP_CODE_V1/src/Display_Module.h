@@ -15,13 +15,45 @@
 #define GPS_ICON_HEIGHT 16
 extern const unsigned char gps_icon_bitmap[] PROGMEM;
 
+// === UI TASK SETTINGS ===
+#define DISPLAY_FRAME_INTERVAL 250     // ms, caps the UI at 4 frames per second
+#define DISPLAY_TASK_STACK_SIZE 4096
+#define DISPLAY_TASK_PRIORITY 1        // Below WiFi/LoRa work
+#define DISPLAY_TASK_CORE 0            // Keeps I2C off the loop() core
+
 // === DISPLAY VARIABLES ===
 extern String loraStatus;
 extern int packetCount;
 
+// Everything the main screen shows, copied out of the loop's globals
+struct DisplaySnapshot {
+  char nodeId[11];
+  bool gpsEnabled;
+  bool gpsValid;
+  float latitude;
+  float longitude;
+  char loraStatus[20];
+  int packetCount;
+  int wifiRSSI;
+  float batteryVoltage;
+  bool sosStatus;
+  char uptime[13];
+};
+
+struct DisplayStats {
+  unsigned long framesRendered;
+  unsigned long framesSkipped;
+  unsigned long totalRenderMicros;
+  unsigned long maxRenderMicros;
+};
+
 // === DISPLAY FUNCTIONS ===
 void initializeDisplay();
 void showSplash();
-void updateDisplay();
+void startDisplayTask();
+void publishDisplaySnapshot();
+void lockDisplay();
+void unlockDisplay();
+DisplayStats getDisplayStats();
 
 #endif 
\ No newline at end of file
@@ -12,6 +12,60 @@ unsigned long tokenCheckInterval = 60000;
 unsigned long lastTokenCheck = 0;
 bool tokenNeedsRefresh = false;
 
+// === CACHED CREDENTIALS ===
+// The anonymous user is created once and its refresh token is kept in
+// Preferences, so reboots and token refreshes never create a new user.
+String cachedRefreshToken = "";
+String cachedUid = "";
+
+// === AUTH METRICS ===
+int authRoundTrips = 0;
+unsigned long firstUploadTime = 0;
+
+void loadFirebaseCredentials() {
+  prefs.begin("fb_auth", true);
+  String storedApiKey = prefs.getString("api_key", "");
+  cachedRefreshToken = prefs.getString("refresh_token", "");
+  cachedUid = prefs.getString("uid", "");
+  prefs.end();
+
+  // Credentials belong to the project they were issued for
+  if (storedApiKey != firebaseAPIKey) {
+    cachedRefreshToken = "";
+    cachedUid = "";
+  }
+}
+
+void saveFirebaseCredentials(const String& refreshToken, const String& uid) {
+  if (refreshToken.length() == 0) return;
+  if (refreshToken == cachedRefreshToken && uid == cachedUid) return;
+
+  prefs.begin("fb_auth", false);
+  prefs.putString("api_key", firebaseAPIKey);
+  prefs.putString("refresh_token", refreshToken);
+  prefs.putString("uid", uid);
+  prefs.end();
+
+  cachedRefreshToken = refreshToken;
+  cachedUid = uid;
+  Serial.print("Firebase credentials cached for uid: ");
+  Serial.println(uid);
+}
+
+void clearFirebaseCredentials() {
+  prefs.begin("fb_auth", false);
+  prefs.clear();
+  prefs.end();
+
+  cachedRefreshToken = "";
+  cachedUid = "";
+  Serial.println("Cached Firebase credentials cleared");
+}
+
+bool hasFirebaseCredentials() {
+  return cachedRefreshToken.length() > 0;
+}
+
 void AutoStatusCallback(TokenInfo tokenInfo) {
   Serial.println("Token Info: ");
   Serial.print("Type: ");
@@ -21,15 +75,23 @@ void AutoStatusCallback(TokenInfo tokenInfo) {
   switch (tokenInfo.status) {
     case token_status_error:
       Serial.println("Error");
+      Serial.println(tokenInfo.error.message.c_str());
       tokenNeedsRefresh = true;
       break;
     case token_status_ready:
       Serial.println("Ready");
       tokenNeedsRefresh = false;
+      signupOK = true;
+      // Keep the latest refresh token so the next boot can skip sign-up
+      saveFirebaseCredentials(Firebase.getRefreshToken(), cachedUid);
       break;
     case token_status_on_signing:
       Serial.println("Signing");
       break;
+    case token_status_on_refresh:
+      Serial.println("Refreshing");
+      authRoundTrips++;
+      break;
     default:
       Serial.println("Unknown");
   }
@@ -39,6 +101,21 @@ void setupTokenCallback() {
   config.token_status_callback = AutoStatusCallback;
 }
 
+bool signUpAnonymous() {
+  authRoundTrips++;
+
+  if (Firebase.signUp(&config, &auth, "", "")) {
+    Serial.println("Firebase signUp successful");
+    cachedUid = auth.token.uid.c_str();
+    saveFirebaseCredentials(Firebase.getRefreshToken(), cachedUid);
+    return true;
+  }
+
+  Serial.print("SignUp failed: ");
+  Serial.println(config.signer.signupError.message.c_str());
+  return false;
+}
+
 void initializeFirebase() {
   // Use configurable Firebase settings
   config.api_key = firebaseAPIKey.c_str();
@@ -50,13 +127,17 @@ void initializeFirebase() {
   Serial.print("Database URL: ");
   Serial.println(firebaseDatabaseURL);
 
-  if (Firebase.signUp(&config, &auth, "", "")) {
-    Serial.println("Firebase signUp successful");
+  loadFirebaseCredentials();
+
+  if (hasFirebaseCredentials()) {
+    // Reuse the existing anonymous user: an expired ID token with a valid
+    // refresh token makes the library exchange it on the first ready() call
+    Serial.print("Using cached Firebase credentials for uid: ");
+    Serial.println(cachedUid);
+    Firebase.setIdToken(&config, "", 0, cachedRefreshToken.c_str());
     signupOK = true;
   } else {
-    Serial.print("SignUp failed: ");
-    Serial.println(config.signer.signupError.message.c_str());
-    signupOK = false;
+    signupOK = signUpAnonymous();
   }
 
   Firebase.begin(&config, &auth);
@@ -71,156 +152,124 @@ bool refreshFirebaseToken() {
   config.database_url = firebaseDatabaseURL.c_str();
   setupTokenCallback();
 
-  if (Firebase.signUp(&config, &auth, "", "")) {
-    Serial.println("Firebase token refresh successful");
+  if (Firebase.ready()) {
+    Serial.println("Firebase token still valid");
     signupOK = true;
     tokenNeedsRefresh = false;
     return true;
-  } else {
-    Serial.print("Token refresh failed: ");
-    Serial.println(config.signer.signupError.message.c_str());
-    signupOK = false;
-    tokenNeedsRefresh = true;
-    return false;
   }
-}
 
-void manualTokenRefresh() {
-  tokenNeedsRefresh = true;
-}
-
-void forwardPacketToFirebase(String packet) {
-  if (!signupOK) return;
+  // Exchange the refresh token for a new ID token on the same user
+  if (hasFirebaseCredentials()) {
+    Firebase.refreshToken(&config);
+    if (Firebase.ready()) {
+      Serial.println("Firebase token refresh successful");
+      signupOK = true;
+      tokenNeedsRefresh = false;
+      return true;
+    }
 
-  // === STEP 1: Basic packet validation ===
-  if (packet.length() == 0) {
-    Serial.println("⚠️ Rejected: Empty packet");
-    return;
+    Serial.print("Token refresh failed: ");
+    Serial.println(config.signer.tokens.error.message.c_str());
+    // A rejected refresh token will never recover, start over with a new user
+    clearFirebaseCredentials();
   }
 
-  if (packet.length() > 2048) {
-    Serial.println("⚠️ Rejected: Packet too large (>2048 bytes)");
-    return;
+  if (signUpAnonymous()) {
+    signupOK = true;
+    tokenNeedsRefresh = false;
+    return true;
   }
 
-  if (!isValidString(packet, 2048)) {
-    Serial.println("⚠️ Rejected: Packet contains invalid characters");
-    return;
-  }
+  signupOK = false;
+  tokenNeedsRefresh = true;
+  return false;
+}
 
-  // === STEP 2: JSON validation ===
-  if (!isValidJSON(packet)) {
-    Serial.println("⚠️ Rejected: Invalid JSON format");
-    Serial.print("Packet content: ");
-    Serial.println(packet);
-    return;
-  }
+void recordFirebaseUpload() {
+  if (firstUploadTime != 0) return;
 
-  FirebaseJson json;
-  if (!json.setJsonData(packet)) {
-    Serial.println("⚠️ Rejected: Failed to parse JSON");
-    return;
-  }
+  firstUploadTime = millis();
+  Serial.print("⏱️ Boot-to-first-upload: ");
+  Serial.print(firstUploadTime);
+  Serial.print(" ms (auth round-trips: ");
+  Serial.print(authRoundTrips);
+  Serial.println(")");
+}
 
-  // === STEP 3: Node ID validation ===
-  FirebaseJsonData nodeIdResult;
-  json.get(nodeIdResult, "node_id");
+int getAuthRoundTrips() {
+  return authRoundTrips;
+}
 
-  if (!nodeIdResult.success) {
-    Serial.println("⚠️ Rejected: No node_id found in packet");
-    return;
-  }
+unsigned long getFirstUploadTime() {
+  return firstUploadTime;
+}
 
-  String receivedNodeId = nodeIdResult.stringValue;
-  if (!isValidNodeId(receivedNodeId)) {
-    Serial.println("⚠️ Rejected: Invalid node_id format");
-    Serial.print("Invalid node_id: ");
-    Serial.println(receivedNodeId);
-    return;
-  }
+void manualTokenRefresh() {
+  tokenNeedsRefresh = true;
+}
 
-  // === STEP 4: Validate numeric fields if present ===
-  FirebaseJsonData tempResult;
-
-  // Check latitude if present
-  if (json.get(tempResult, "latitude") && tempResult.success) {
-    float lat = tempResult.floatValue;
-    if (!isValidLatitude(lat)) {
-      Serial.println("⚠️ Rejected: Invalid latitude value");
-      Serial.print("Latitude: ");
-      Serial.println(lat);
-      return;
+// === UPLINK BACKEND ===
+void firebaseLoop() {
+  // Check token status periodically
+  if (millis() - lastTokenCheck > tokenCheckInterval) {
+    lastTokenCheck = millis();
+    
+    // Check if token needs refresh
+    if (tokenNeedsRefresh) {
+      refreshFirebaseToken();
     }
   }
+}
 
-  // Check longitude if present
-  if (json.get(tempResult, "longitude") && tempResult.success) {
-    float lon = tempResult.floatValue;
-    if (!isValidLongitude(lon)) {
-      Serial.println("⚠️ Rejected: Invalid longitude value");
-      Serial.print("Longitude: ");
-      Serial.println(lon);
-      return;
-    }
-  }
+bool firebaseIsReady() {
+  return signupOK;
+}
 
-  // Check heart rate if present (typical range 30-220 bpm)
-  if (json.get(tempResult, "heart_rate") && tempResult.success) {
-    int hr = tempResult.intValue;
-    if (!isValidInt(hr, 30, 220)) {
-      Serial.println("⚠️ Rejected: Invalid heart_rate value");
-      Serial.print("Heart rate: ");
-      Serial.println(hr);
-      return;
-    }
+bool firebasePublishPacket(const String& nodeId, const String& packet) {
+  FirebaseJson json;
+  if (!json.setJsonData(packet)) {
+    Serial.println("⚠️ Rejected: Failed to parse JSON");
+    return false;
   }
 
-  // Check temperature if present (range -40 to 85°C for ESP32)
-  if (json.get(tempResult, "temperature") && tempResult.success) {
-    float temp = tempResult.floatValue;
-    if (!isValidFloat(temp, -40.0, 85.0)) {
-      Serial.println("⚠️ Rejected: Invalid temperature value");
-      Serial.print("Temperature: ");
-      Serial.println(temp);
-      return;
-    }
-  }
+  String pathlogs = "/runners/";
+  pathlogs += nodeId;
+  pathlogs += "/logs";
 
-  // Check battery voltage if present (typical range 2.5-4.5V)
-  if (json.get(tempResult, "battery") && tempResult.success) {
-    float battery = tempResult.floatValue;
-    if (!isValidFloat(battery, 0.0, 5.0)) {
-      Serial.println("⚠️ Rejected: Invalid battery voltage");
-      Serial.print("Battery: ");
-      Serial.println(battery);
-      return;
-    }
+  if (Firebase.RTDB.pushJSON(&fbdo, pathlogs.c_str(), &json)) {
+    recordFirebaseUpload();
+    return true;
   }
 
-  // Check WiFi RSSI if present (typical range -120 to 0 dBm)
-  if (json.get(tempResult, "wifi_rssi") && tempResult.success) {
-    int rssi = tempResult.intValue;
-    if (!isValidInt(rssi, -120, 0)) {
-      Serial.println("⚠️ Rejected: Invalid WiFi RSSI");
-      Serial.print("RSSI: ");
-      Serial.println(rssi);
-      return;
-    }
-  }
+  Serial.print("❌ Log push error: ");
+  Serial.println(fbdo.errorReason());
+  return false;
+}
 
-  // === STEP 5: All validation passed, send to Firebase ===
-  String pathlogs = "/runners/";
-  pathlogs += receivedNodeId;
-  pathlogs += "/logs";
+bool firebasePublishTelemetry(const String& telemetry) {
+  FirebaseJson json;
+  if (!json.setJsonData(telemetry)) {
+    return false;
+  }
 
-  if (Firebase.RTDB.pushJSON(&fbdo, pathlogs.c_str(), &json)) {
-    String message = "📥 ✓ Validated log pushed to Firebase for node: ";
-    message += receivedNodeId;
-    Serial.println(message);
-  } else {
-    Serial.print("❌ Log push error: ");
-    Serial.println(fbdo.errorReason());
+  if (Firebase.RTDB.pushJSON(&fbdo, "/basecamp/telemetry", &json)) {
+    recordFirebaseUpload();
+    return true;
   }
+
+  Serial.print("❌ Telemetry error: ");
+  Serial.println(fbdo.errorReason());
+  return false;
 }
 
- 
\ No newline at end of file
+const UplinkBackend firebaseBackend = {
+  "firebase",
+  initializeFirebase,
+  firebaseLoop,
+  firebaseIsReady,
+  firebasePublishPacket,
+  firebasePublishTelemetry,
+  false,
+  NULL
+};
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <Firebase_ESP_Client.h>
 #include "Common.h"
+#include "Uplink_Module.h"
 
 // === GLOBAL VARIABLES ===
 extern bool signupOK;
@@ -13,9 +14,25 @@ extern bool tokenNeedsRefresh;
 // === FIREBASE FUNCTIONS ===
 void initializeFirebase();
 bool refreshFirebaseToken();
-void forwardPacketToFirebase(String packet);
 
 // === TOKEN MANAGEMENT ===
 void setupTokenCallback();
 
+// === CREDENTIAL CACHE ===
+void loadFirebaseCredentials();
+void saveFirebaseCredentials(const String& refreshToken, const String& uid);
+void clearFirebaseCredentials();
+bool hasFirebaseCredentials();
+
+// === UPLINK BACKEND ===
+void firebaseLoop();
+bool firebaseIsReady();
+bool firebasePublishPacket(const String& nodeId, const String& packet);
+bool firebasePublishTelemetry(const String& telemetry);
+
+// === AUTH METRICS ===
+void recordFirebaseUpload();
+int getAuthRoundTrips();
+unsigned long getFirstUploadTime();
+
 #endif 
\ No newline at end of file
@@ -4,15 +4,62 @@
 // === GPS VARIABLES ===
 HardwareSerial gpsSerial(2);
 TinyGPSPlus gps;
+UBXParser ubx;
 bool gpsEnabled = false;
 float currentLat = 0.0;
 float currentLng = 0.0;
 String gpsTimeStr = "N/A";
 bool gpsValid = false;
+bool gpsUsingUBX = false;
+uint32_t gpsParseMicros = 0;
+uint32_t gpsFixCount = 0;
+
+// Send a UBX frame, appending the Fletcher checksum
+void sendGPSUBXCommand(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, uint16_t length) {
+  uint8_t header[6] = {UBX_SYNC_1, UBX_SYNC_2, msgClass, msgId, (uint8_t)(length & 0xFF), (uint8_t)(length >> 8)};
+  uint8_t ckA = 0, ckB = 0;
+  for (int i = 2; i < 6; i++) {
+    ckA += header[i];
+    ckB += ckA;
+  }
+  for (uint16_t i = 0; i < length; i++) {
+    ckA += payload[i];
+    ckB += ckA;
+  }
+  gpsSerial.write(header, sizeof(header));
+  gpsSerial.write(payload, length);
+  gpsSerial.write(ckA);
+  gpsSerial.write(ckB);
+}
+
+// Switch u-blox receivers to NAV-PVT; other modules ignore UBX and keep NMEA
+void configureGPSProtocol() {
+  if (!GPS_USE_UBX) return;
+
+  uint8_t pvt[3] = {UBX_CLASS_NAV, UBX_ID_NAV_PVT, 1};
+  sendGPSUBXCommand(0x06, 0x01, pvt, sizeof(pvt));
+  delay(20);
+
+  // Silence the default NMEA sentences (GGA, GLL, GSA, GSV, RMC, VTG)
+  for (uint8_t id = 0x00; id <= 0x05; id++) {
+    uint8_t nmea[3] = {0xF0, id, 0};
+    sendGPSUBXCommand(0x06, 0x01, nmea, sizeof(nmea));
+    delay(20);
+  }
+  Serial.println("GPS UBX-NAV-PVT requested");
+}
+
+void setGPSTime(uint8_t hour, uint8_t minute, uint8_t second) {
+  char buffer[9];
+  formatGPSTime(buffer, (hour + 8) % 24, minute, second);
+  gpsTimeStr = String(buffer);
+}
 
 void initializeGPS() {
   if (gpsEnabled) {
     gpsSerial.begin(GPS_BAUD, SERIAL_8N1, RXD2, TXD2);
+    ubxInit(ubx);
+    configureGPSProtocol();
     Serial.println("GPS module initialized");
   }
 }
@@ -20,20 +67,52 @@ void initializeGPS() {
 void updateGPS() {
   if (!gpsEnabled) return;
   
+  bool ubxUpdated = false;
+  bool nmeaUpdated = false;
+  uint32_t start = micros();
   while (gpsSerial.available()) {
-    gps.encode(gpsSerial.read());
+    uint8_t c = gpsSerial.read();
+    bool wasInFrame = ubxInFrame(ubx);
+    if (ubxEncode(ubx, c)) {
+      ubxUpdated = true;
+    } else if (!wasInFrame && !ubxInFrame(ubx)) {
+      // Not part of a UBX frame, hand it to the NMEA fallback
+      gps.encode(c);
+      nmeaUpdated = nmeaUpdated || gps.location.isUpdated();
+    }
+  }
+  gpsParseMicros += micros() - start;
+  
+  if (ubxUpdated) {
+    const UBXNavPVT& pvt = ubx.pvt;
+    if (!gpsUsingUBX) {
+      Serial.println("GPS receiver answers in UBX-NAV-PVT");
+    }
+    gpsUsingUBX = true;
+    gpsFixCount++;
+    gpsValid = pvt.gnssFixOK && pvt.fixType >= 2;
+    if (gpsValid) {
+      currentLat = pvt.latitude;
+      currentLng = pvt.longitude;
+    }
+    if (pvt.timeValid) {
+      setGPSTime(pvt.hour, pvt.minute, pvt.second);
+    }
+    return;
   }
   
+  // NMEA fallback for receivers that do not speak UBX
+  if (gpsUsingUBX) return;
+  
   if (gps.location.isValid()) {
+    if (nmeaUpdated) gpsFixCount++;
     currentLat = gps.location.lat();
     currentLng = gps.location.lng();
     gpsValid = true;
     
     // Format time string
     if (gps.time.isValid()) {
-      char buffer[10];
-      sprintf(buffer, "%02d:%02d:%02d", gps.time.hour()+8, gps.time.minute(), gps.time.second());
-      gpsTimeStr = String(buffer);
+      setGPSTime(gps.time.hour(), gps.time.minute(), gps.time.second());
     }
   } else {
     gpsValid = false;
@@ -54,4 +133,12 @@ float getCurrentLongitude() {
 
 String getGPSTimeString() {
   return gpsTimeStr;
-} 
\ No newline at end of file
+} 
+
+bool isGPSUsingUBX() {
+  return gpsUsingUBX;
+}
+
+uint32_t getGPSParseMicrosPerFix() {
+  return gpsFixCount > 0 ? gpsParseMicros / gpsFixCount : 0;
+}
\ No newline at end of file
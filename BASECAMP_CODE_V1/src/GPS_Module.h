@@ -3,15 +3,18 @@
 
 #include <WiFi.h>
 #include <TinyGPS++.h>
+#include <ubx_parser.h>
 
 // === PIN DEFINITIONS ===
 #define RXD2 16
 #define TXD2 17
 #define GPS_BAUD 9600
+#define GPS_USE_UBX true  // Prefer UBX-NAV-PVT on u-blox receivers, NMEA otherwise
 
 // === GPS VARIABLES ===
 extern HardwareSerial gpsSerial;
 extern TinyGPSPlus gps;
+extern UBXParser ubx;
 extern bool gpsEnabled;
 extern float currentLat;
 extern float currentLng;
@@ -25,5 +28,7 @@ bool isGPSValid();
 float getCurrentLatitude();
 float getCurrentLongitude();
 String getGPSTimeString();
+bool isGPSUsingUBX();
+uint32_t getGPSParseMicrosPerFix();
 
 #endif 
\ No newline at end of file
@@ -1,15 +1,22 @@
 #include "LoRa_Module.h"
+#include "Common.h"
 
 // External references
 extern String loraStatus;
 extern int packetCount;
 
-// Forward declaration
-void forwardPacketToFirebase(String packet);
+// Forward declarations
+void forwardPacketToUplink(String packet);
+void publishPacketEvent(const String& packet, int rssi, float snr);
 
 // Global LoRa status
 static bool loraInitialized = false;
 
+// Route beacon state
+static uint32_t routeEpoch = 0;
+static uint16_t routeBeaconCount = 0;
+static unsigned long nextRouteBeaconAt = 0;
+
 // Hardware reset function
 void resetLoRaHardware() {
   pinMode(LORA_RST, OUTPUT);
@@ -174,12 +181,107 @@ void handleLoRaPackets() {
     message += packet;
     Serial.println(message);
     
+    // Beacons and frames for other relays are not hiker data
+    if (!acceptRoutedPacket(packet)) {
+      return;
+    }
+    
     loraStatus = "Received!";
     packetCount++;
     
-    // Forward packet to Firebase
-    forwardPacketToFirebase(packet);
+    // Push to local API clients first, they do not wait on the cloud
+    publishPacketEvent(packet, LoRa.packetRssi(), LoRa.packetSnr());
+    
+    // Forward packet to the cloud uplink
+    forwardPacketToUplink(packet);
+  }
+  
+  updateRouteBeacons();
+}
+
+// The epoch is the high half of every beacon sequence, so relays still
+// accept our beacons after a reboot or once the low half wraps
+static void advanceRouteEpoch() {
+  prefs.begin("routing", false);
+  routeEpoch = (prefs.getUShort("epoch", 0) + 1) & 0xFFFF;
+  prefs.putUShort("epoch", routeEpoch);
+  prefs.end();
+  routeBeaconCount = 0;
+}
+
+void initializeRouteBeacons() {
+  advanceRouteEpoch();
+  
+  nextRouteBeaconAt = millis() + random(ROUTE_BEACON_JITTER);
+  Serial.print("Route beacons enabled, epoch ");
+  Serial.println(routeEpoch);
+}
+
+void updateRouteBeacons() {
+  if ((long)(millis() - nextRouteBeaconAt) < 0) {
+    return;
+  }
+  nextRouteBeaconAt = millis() + ROUTE_BEACON_INTERVAL + random(ROUTE_BEACON_JITTER);
+  
+  // 65536 beacons is about 23 days; wrapping within the epoch would look
+  // older than every beacon before it
+  if (routeBeaconCount == 0xFFFF) {
+    advanceRouteEpoch();
+    Serial.print("Route beacon count wrapped, epoch ");
+    Serial.println(routeEpoch);
   }
+  uint32_t sequence = (routeEpoch << 16) | routeBeaconCount++;
+  char beacon[96];
+  snprintf(beacon, sizeof(beacon), "{\"rb\":\"%s\",\"r\":[[\"%s\",%lu,0,100,\"\"]]}",
+           nodeId.c_str(), nodeId.c_str(), (unsigned long)sequence);
+  
+  LoRa.beginPacket();
+  LoRa.print(beacon);
+  LoRa.endPacket();
+}
+
+// Length of the JSON object at `data`, or 0 if it does not close within `length`
+static size_t jsonObjectLength(const char* data, size_t length) {
+  int depth = 0;
+  bool inString = false;
+  for (size_t i = 0; i < length; i++) {
+    char c = data[i];
+    if (inString) {
+      if (c == '\\') i++;
+      else if (c == '"') inString = false;
+    } else if (c == '"') {
+      inString = true;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if ((c == '}' || c == ']') && --depth == 0) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+// False when the packet should be ignored; a frame for us is replaced by its payload
+bool acceptRoutedPacket(String& packet) {
+  if (packet.startsWith("{\"rb\":")) {
+    return false;
+  }
+  if (!packet.startsWith("{\"to\":")) {
+    return true;
+  }
+  
+  String to = "{\"to\":\"" + nodeId + "\",";
+  int dataStart = packet.indexOf(",\"data\":");
+  if (!packet.startsWith(to) || dataStart < 0 || !packet.endsWith("}")) {
+    return false;
+  }
+  
+  packet = packet.substring(dataStart + 8, packet.length() - 1);
+  // Keys after "data" mean a hiker re-sent the frame with its relay fields;
+  // the relay's own copy carries the same packet
+  if (packet.startsWith("{") && jsonObjectLength(packet.c_str(), packet.length()) != packet.length()) {
+    return false;
+  }
+  return true;
 }
 
 void setLoRaStatus(String status) {
@@ -19,4 +19,17 @@ int getPacketCount();
 bool isLoRaInitialized();
 bool attemptLoRaRecovery(int syncWord);
 
+// === ROUTE BEACONS ===
+// The basecamp is where relay routes end. Its beacon advertises itself at
+// 0 hops with a sequence of (boot count << 16 | beacon count), so routes
+// learned before a reboot are always older than the new ones. Relays send
+// unicast frames {"to":..,"fr":..,"dst":..,"h":..,"c":..,"data":<packet>};
+// only frames addressed to this basecamp are accepted, and unwrapped.
+#define ROUTE_BEACON_INTERVAL 30000   // ms, plus up to ROUTE_BEACON_JITTER
+#define ROUTE_BEACON_JITTER   5000
+
+void initializeRouteBeacons();
+void updateRouteBeacons();
+bool acceptRoutedPacket(String& packet);
+
 #endif 
\ No newline at end of file
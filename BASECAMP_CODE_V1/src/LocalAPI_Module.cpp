@@ -0,0 +1,195 @@
+#include "LocalAPI_Module.h"
+#include "GPS_Module.h"
+#include "Telemetry.h"
+
+// External references
+extern AsyncWebServer server;
+extern String nodeId;
+extern bool sos_status;
+
+// === LOCAL API STATE ===
+// Server-Sent Events stream; every client gets its own bounded queue inside
+// AsyncEventSource (SSE_MAX_QUEUED_MESSAGES). Once a slow reader's queue is
+// full, new events for that reader are dropped until it catches up, so it
+// never blocks the LoRa loop; /api/nodes gives it the current state back.
+AsyncEventSource events(LOCAL_API_EVENTS_PATH);
+
+static NodeState nodeStates[MAX_TRACKED_NODES];
+static String lastTelemetryJson = "{}";
+static SemaphoreHandle_t stateMutex = NULL;
+static bool localApiActive = false;
+static uint32_t eventId = 0;
+
+// Find the slot for a node, or claim an empty/oldest one. Caller holds stateMutex.
+static NodeState* findNodeSlot(const String& id) {
+  NodeState* oldest = &nodeStates[0];
+
+  for (int i = 0; i < MAX_TRACKED_NODES; i++) {
+    if (nodeStates[i].nodeId == id) {
+      return &nodeStates[i];
+    }
+    if (nodeStates[i].nodeId.length() == 0) {
+      return &nodeStates[i];
+    }
+    if (nodeStates[i].lastSeen < oldest->lastSeen) {
+      oldest = &nodeStates[i];
+    }
+  }
+
+  // Table full, recycle the node that has been silent the longest
+  oldest->nodeId = "";
+  oldest->packetCount = 0;
+  return oldest;
+}
+
+static void handleNodesSnapshot(AsyncWebServerRequest *request) {
+  JsonDocument doc;
+  doc["basecamp"] = nodeId;
+  doc["uptime_ms"] = millis();
+  JsonArray nodes = doc["nodes"].to<JsonArray>();
+
+  unsigned long now = millis();
+  xSemaphoreTake(stateMutex, portMAX_DELAY);
+  for (int i = 0; i < MAX_TRACKED_NODES; i++) {
+    NodeState& state = nodeStates[i];
+    if (state.nodeId.length() == 0 || now - state.lastSeen > NODE_STALE_TIMEOUT) {
+      continue;
+    }
+
+    JsonObject node = nodes.add<JsonObject>();
+    node["node_id"] = state.nodeId;
+    node["rssi"] = state.rssi;
+    node["snr"] = state.snr;
+    node["age_ms"] = now - state.lastSeen;
+    node["packets"] = state.packetCount;
+    node["packet"] = serialized(state.lastPacket);
+  }
+  xSemaphoreGive(stateMutex);
+
+  String response;
+  serializeJson(doc, response);
+  request->send(200, "application/json", response);
+}
+
+static void handleTelemetrySnapshot(AsyncWebServerRequest *request) {
+  xSemaphoreTake(stateMutex, portMAX_DELAY);
+  String response = lastTelemetryJson;
+  xSemaphoreGive(stateMutex);
+
+  request->send(200, "application/json", response);
+}
+
+void initializeLocalAPI() {
+  if (localApiActive) return;
+
+  stateMutex = xSemaphoreCreateMutex();
+
+  events.onConnect([](AsyncEventSourceClient *client) {
+    Serial.print("Local API: SSE client connected, total: ");
+    Serial.println(getLocalAPIClientCount());
+    // Prime the new client with the current state
+    xSemaphoreTake(stateMutex, portMAX_DELAY);
+    String telemetry = lastTelemetryJson;
+    xSemaphoreGive(stateMutex);
+    client->send(telemetry.c_str(), "telemetry", eventId, 5000);
+  });
+
+  server.on("/api/nodes", HTTP_GET, handleNodesSnapshot);
+  server.on("/api/telemetry", HTTP_GET, handleTelemetrySnapshot);
+  server.addHandler(&events);
+
+  // Allow dashboards served from a laptop to read the API directly
+  DefaultHeaders::Instance().addHeader("Access-Control-Allow-Origin", "*");
+
+  server.begin();
+  localApiActive = true;
+
+  Serial.print("Local API started: http://");
+  Serial.print(WiFi.localIP());
+  Serial.println(LOCAL_API_EVENTS_PATH);
+}
+
+bool isLocalAPIActive() {
+  return localApiActive;
+}
+
+void publishPacketEvent(const String& packet, int rssi, float snr) {
+  if (!localApiActive) return;
+
+  // Only the node id is needed here, the packet itself is passed through
+  JsonDocument filter;
+  filter["node_id"] = true;
+  JsonDocument parsed;
+  if (deserializeJson(parsed, packet, DeserializationOption::Filter(filter))) {
+    return;
+  }
+
+  String receivedNodeId = parsed["node_id"] | "";
+  if (!isValidNodeId(receivedNodeId)) {
+    return;
+  }
+
+  xSemaphoreTake(stateMutex, portMAX_DELAY);
+  NodeState* state = findNodeSlot(receivedNodeId);
+  state->nodeId = receivedNodeId;
+  state->lastPacket = packet;
+  state->rssi = rssi;
+  state->snr = snr;
+  state->lastSeen = millis();
+  state->packetCount++;
+  xSemaphoreGive(stateMutex);
+
+  if (events.count() == 0) return;
+
+  JsonDocument doc;
+  doc["node_id"] = receivedNodeId;
+  doc["rssi"] = rssi;
+  doc["snr"] = snr;
+  doc["received_ms"] = millis();
+  doc["packet"] = serialized(packet);
+
+  String message;
+  serializeJson(doc, message);
+  events.send(message.c_str(), "packet", ++eventId);
+}
+
+void publishTelemetryEvent() {
+  if (!localApiActive) return;
+
+  JsonDocument doc;
+  doc["node_id"] = nodeId;
+  doc["type"] = "telemetry";
+  doc["battery"] = batteryVoltage;
+  doc["wifi_rssi"] = wifiRSSI;
+  doc["cpu_temp"] = cpuTemp;
+  doc["uptime_ms"] = uptime;
+  doc["free_heap"] = ESP.getFreeHeap();
+  doc["sos_status"] = sos_status;
+  doc["cooling_active"] = coolingActive;
+
+  if (gpsEnabled && isGPSValid()) {
+    doc["latitude"] = getCurrentLatitude();
+    doc["longitude"] = getCurrentLongitude();
+    doc["gps_time"] = getGPSTimeString();
+  }
+  if (gpsEnabled) {
+    // Which decoder the receiver ended up on, and what it costs per fix
+    doc["gps_protocol"] = isGPSUsingUBX() ? "ubx" : "nmea";
+    doc["gps_parse_us_per_fix"] = getGPSParseMicrosPerFix();
+  }
+
+  String message;
+  serializeJson(doc, message);
+
+  xSemaphoreTake(stateMutex, portMAX_DELAY);
+  lastTelemetryJson = message;
+  xSemaphoreGive(stateMutex);
+
+  if (events.count() > 0) {
+    events.send(message.c_str(), "telemetry", ++eventId);
+  }
+}
+
+int getLocalAPIClientCount() {
+  return localApiActive ? events.count() : 0;
+}
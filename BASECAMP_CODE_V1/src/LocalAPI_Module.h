@@ -0,0 +1,29 @@
+#ifndef LOCALAPI_MODULE_H
+#define LOCALAPI_MODULE_H
+
+#include <ESPAsyncWebServer.h>
+#include "Common.h"
+
+// === LOCAL API SETTINGS ===
+#define LOCAL_API_EVENTS_PATH "/events"
+#define MAX_TRACKED_NODES 16
+#define NODE_STALE_TIMEOUT 600000  // Drop nodes silent for 10 minutes from the snapshot
+
+// === NODE STATE ===
+struct NodeState {
+  String nodeId;
+  String lastPacket;
+  int rssi;
+  float snr;
+  unsigned long lastSeen;
+  unsigned long packetCount;
+};
+
+// === LOCAL API FUNCTIONS ===
+void initializeLocalAPI();
+bool isLocalAPIActive();
+void publishPacketEvent(const String& packet, int rssi, float snr);
+void publishTelemetryEvent();
+int getLocalAPIClientCount();
+
+#endif
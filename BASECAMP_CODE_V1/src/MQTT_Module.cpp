@@ -0,0 +1,308 @@
+#include "MQTT_Module.h"
+
+// External references
+extern String nodeId;
+
+// === MQTT CLIENT ===
+// One persistent session driven from the main loop, so callbacks never race
+// with the LoRa path.
+static espMqttClient mqttClient(espMqttClientTypes::UseInternalTask::NO);
+
+// espMqttClient keeps pointers to these, they must outlive the client
+static String mqttHost = "";
+static String mqttUser = "";
+static String mqttPassword = "";
+static String mqttClientId = "";
+static String mqttTopicPrefix = "";
+static uint16_t mqttPort = DEFAULT_MQTT_PORT;
+
+static unsigned long lastConnectAttempt = 0;
+
+// === IN-FLIGHT PUBLISHES ===
+// A record only counts as published once the broker's PUBACK arrives, so
+// each QoS 1 publish keeps its packet ID until then
+struct InFlightPublish {
+  uint16_t packetId;              // 0 when the slot is free
+  unsigned long acceptedAt;       // When the uplink handed the record over
+  unsigned long sentAt;
+};
+
+static InFlightPublish inFlight[MQTT_MAX_INFLIGHT];
+static int inFlightCount = 0;
+
+// === OFFLINE QUEUE ===
+struct MqttRecord {
+  String topic;
+  String payload;
+  unsigned long acceptedAt;
+};
+
+static MqttRecord offlineQueue[MQTT_OFFLINE_QUEUE_SIZE];
+static int queueHead = 0;
+static int queueCount = 0;
+
+static void enqueueRecord(const String& topic, const String& payload, unsigned long acceptedAt) {
+  if (queueCount == MQTT_OFFLINE_QUEUE_SIZE) {
+    // Full, drop the oldest record to keep the newest positions
+    queueHead = (queueHead + 1) % MQTT_OFFLINE_QUEUE_SIZE;
+    queueCount--;
+    uplinkPublishDropped();
+    Serial.println("⚠️ MQTT offline queue full, oldest record dropped");
+  }
+
+  int tail = (queueHead + queueCount) % MQTT_OFFLINE_QUEUE_SIZE;
+  offlineQueue[tail].topic = topic;
+  offlineQueue[tail].payload = payload;
+  offlineQueue[tail].acceptedAt = acceptedAt;
+  queueCount++;
+}
+
+static bool publishNow(const String& topic, const String& payload, unsigned long acceptedAt) {
+  if (!mqttClient.connected() || inFlightCount >= MQTT_MAX_INFLIGHT) {
+    return false;
+  }
+
+  uint16_t packetId = mqttClient.publish(topic.c_str(), 1, false, payload.c_str());
+  if (packetId == 0) {
+    return false;
+  }
+
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    if (inFlight[i].packetId == 0) {
+      inFlight[i].packetId = packetId;
+      inFlight[i].acceptedAt = acceptedAt;
+      inFlight[i].sentAt = millis();
+      inFlightCount++;
+      break;
+    }
+  }
+  return true;
+}
+
+static void flushOfflineQueue() {
+  while (queueCount > 0) {
+    MqttRecord& record = offlineQueue[queueHead];
+    if (!publishNow(record.topic, record.payload, record.acceptedAt)) {
+      return;
+    }
+
+    record.topic = "";
+    record.payload = "";
+    queueHead = (queueHead + 1) % MQTT_OFFLINE_QUEUE_SIZE;
+    queueCount--;
+  }
+}
+
+// True once the record is in flight or queued; the uplink counts it as
+// published when the PUBACK comes back. False when there is no broker to
+// send it to, so nothing would ever drain the queue
+static bool publishOrQueue(const String& topic, const String& payload) {
+  if (mqttHost.length() == 0) {
+    return false;
+  }
+  unsigned long acceptedAt = millis();
+
+  // Keep ordering: nothing jumps ahead of records already waiting
+  if (queueCount == 0 && publishNow(topic, payload, acceptedAt)) {
+    return true;
+  }
+
+  enqueueRecord(topic, payload, acceptedAt);
+  return true;
+}
+
+// === COMPACT RECORDS ===
+// The node ID is already in the topic, so it is left out, and the usual
+// fields get short keys. Anything else passes through under its own name
+struct CompactKey {
+  const char* field;
+  const char* key;
+};
+
+static const CompactKey compactKeys[] = {
+  {"latitude", "lat"},
+  {"longitude", "lon"},
+  {"accuracy", "acc"},
+  {"time", "t"},
+  {"battery", "bat"},
+  {"sos_status", "sos"},
+  {"heart_rate", "hr"},
+  {"temperature", "tmp"},
+  {"relay_count", "rc"},
+  {"relayed_by", "rb"},
+  {"relayed_at", "ra"}
+};
+
+static const char* compactKey(const char* field) {
+  for (size_t i = 0; i < sizeof(compactKeys) / sizeof(compactKeys[0]); i++) {
+    if (strcmp(compactKeys[i].field, field) == 0) {
+      return compactKeys[i].key;
+    }
+  }
+  return field;
+}
+
+// Empty when the packet is not a JSON object
+static String buildCompactRecord(const String& packet) {
+  JsonDocument doc;
+  if (deserializeJson(doc, packet) || !doc.is<JsonObject>()) {
+    return "";
+  }
+
+  JsonDocument record;
+  for (JsonPair field : doc.as<JsonObject>()) {
+    const char* name = field.key().c_str();
+    if (strcmp(name, "node_id") == 0) continue;
+
+    JsonVariant value = field.value();
+    if (value.is<bool>()) {
+      record[compactKey(name)] = value.as<bool>() ? 1 : 0;
+    } else if (strcmp(name, "latitude") == 0 || strcmp(name, "longitude") == 0) {
+      // Six decimals is ~0.1 m, finer than any hiker fix
+      record[compactKey(name)] = serialized(String(value.as<double>(), 6));
+    } else {
+      record[compactKey(name)] = value;
+    }
+  }
+
+  String output;
+  serializeJson(record, output);
+  return output;
+}
+
+// The client resends unacknowledged publishes itself after a reconnect, so
+// only give up on one after it has been waiting that long while connected
+static void expireInFlight() {
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    if (inFlight[i].packetId != 0 && millis() - inFlight[i].sentAt > MQTT_ACK_TIMEOUT) {
+      Serial.print("⚠️ MQTT publish ");
+      Serial.print(inFlight[i].packetId);
+      Serial.println(" never acknowledged, counted as failed");
+      inFlight[i].packetId = 0;
+      inFlightCount--;
+      uplinkPublishDropped();
+    }
+  }
+}
+
+static void onMqttConnect(bool sessionPresent) {
+  Serial.print("MQTT connected to ");
+  Serial.print(mqttHost);
+  Serial.print(" (session present: ");
+  Serial.print(sessionPresent ? "yes" : "no");
+  Serial.println(")");
+
+  // Unacknowledged publishes go out again with this connection
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    inFlight[i].sentAt = millis();
+  }
+  flushOfflineQueue();
+}
+
+static void onMqttDisconnect(espMqttClientTypes::DisconnectReason reason) {
+  Serial.print("MQTT disconnected, reason: ");
+  Serial.println(static_cast<int>(reason));
+}
+
+static void onMqttPublish(uint16_t packetId) {
+  for (int i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+    if (inFlight[i].packetId == packetId) {
+      inFlight[i].packetId = 0;
+      inFlightCount--;
+      uplinkPublishAcked(millis() - inFlight[i].acceptedAt);
+      return;
+    }
+  }
+}
+
+void initializeMQTT() {
+  prefs.begin("config", true);
+  mqttHost = prefs.getString("mqtt_host", "");
+  mqttPort = prefs.getUInt("mqtt_port", DEFAULT_MQTT_PORT);
+  mqttUser = prefs.getString("mqtt_user", "");
+  mqttPassword = prefs.getString("mqtt_password", "");
+  prefs.end();
+
+  if (mqttHost.length() == 0) {
+    Serial.println("MQTT broker not configured, uplink disabled");
+    return;
+  }
+
+  mqttClientId = nodeId;
+  mqttTopicPrefix = MQTT_TOPIC_ROOT;
+  mqttTopicPrefix += "/";
+  mqttTopicPrefix += nodeId;
+
+  mqttClient.onConnect(onMqttConnect);
+  mqttClient.onDisconnect(onMqttDisconnect);
+  mqttClient.onPublish(onMqttPublish);
+  mqttClient.setServer(mqttHost.c_str(), mqttPort);
+  mqttClient.setClientId(mqttClientId.c_str());
+  mqttClient.setKeepAlive(MQTT_KEEP_ALIVE);
+  // Persistent session so unacknowledged QoS 1 messages survive a reconnect
+  mqttClient.setCleanSession(false);
+  if (mqttUser.length() > 0) {
+    mqttClient.setCredentials(mqttUser.c_str(), mqttPassword.c_str());
+  }
+
+  Serial.print("Connecting to MQTT broker ");
+  Serial.print(mqttHost);
+  Serial.print(":");
+  Serial.println(mqttPort);
+
+  mqttClient.connect();
+  lastConnectAttempt = millis();
+}
+
+void mqttLoop() {
+  if (mqttHost.length() == 0) return;
+
+  mqttClient.loop();
+
+  if (mqttClient.connected()) {
+    expireInFlight();
+    flushOfflineQueue();
+  } else if (WiFi.status() == WL_CONNECTED &&
+             millis() - lastConnectAttempt > MQTT_RECONNECT_INTERVAL) {
+    lastConnectAttempt = millis();
+    mqttClient.connect();
+  }
+}
+
+bool mqttIsReady() {
+  // Records are buffered while offline, so a configured broker is enough
+  return mqttHost.length() > 0;
+}
+
+bool mqttPublishPacket(const String& nodeId, const String& packet) {
+  String topic = mqttTopicPrefix;
+  topic += "/nodes/";
+  topic += nodeId;
+
+  String record = buildCompactRecord(packet);
+  if (record.length() == 0) {
+    return false;
+  }
+  return publishOrQueue(topic, record);
+}
+
+bool mqttPublishTelemetry(const String& telemetry) {
+  String topic = mqttTopicPrefix;
+  topic += "/telemetry";
+  return publishOrQueue(topic, telemetry);
+}
+
+int getMQTTQueuedCount() {
+  return queueCount;
+}
+
+const UplinkBackend mqttBackend = {
+  "mqtt",
+  initializeMQTT,
+  mqttLoop,
+  mqttIsReady,
+  mqttPublishPacket,
+  mqttPublishTelemetry,
+  true,
+  getMQTTQueuedCount
+};
@@ -0,0 +1,25 @@
+#ifndef MQTT_MODULE_H
+#define MQTT_MODULE_H
+
+#include <espMqttClient.h>
+#include "Common.h"
+#include "Uplink_Module.h"
+
+// === MQTT SETTINGS ===
+#define DEFAULT_MQTT_PORT 1883
+#define MQTT_TOPIC_ROOT "trailbeacon"  // <root>/<basecamp>/nodes/<node> carries compact records
+#define MQTT_KEEP_ALIVE 30             // Seconds
+#define MQTT_RECONNECT_INTERVAL 5000
+#define MQTT_MAX_INFLIGHT 8            // Unacknowledged QoS 1 publishes
+#define MQTT_OFFLINE_QUEUE_SIZE 64     // Records held while the broker is unreachable
+#define MQTT_ACK_TIMEOUT 60000         // Connected time before an unacknowledged publish counts as lost
+
+// === MQTT FUNCTIONS ===
+void initializeMQTT();
+void mqttLoop();
+bool mqttIsReady();
+bool mqttPublishPacket(const String& nodeId, const String& packet);
+bool mqttPublishTelemetry(const String& telemetry);
+int getMQTTQueuedCount();
+
+#endif
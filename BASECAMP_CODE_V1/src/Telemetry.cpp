@@ -1,5 +1,7 @@
 #include "Telemetry.h"
 #include "GPS_Module.h"
+#include "Firebase_Module.h"
+#include "Uplink_Module.h"
 #include "Common.h"
 
 // External references
@@ -28,8 +30,8 @@ void updateTelemetry() {
   updateCoolingSystem();
 }
 
-void sendTelemetryToFirebase() {
-  if (!signupOK) return;
+void sendTelemetryToCloud() {
+  if (!isUplinkReady()) return;
 
   // === VALIDATION: Check all telemetry data before sending ===
   bool validationFailed = false;
@@ -101,40 +103,46 @@ void sendTelemetryToFirebase() {
     }
   }
 
-  // If any validation failed, do not send to Firebase
+  // If any validation failed, do not send to the uplink
   if (validationFailed) {
-    Serial.println("❌ Telemetry NOT sent to Firebase due to validation errors");
+    Serial.println("❌ Telemetry NOT sent due to validation errors");
     return;
   }
 
   // === All validation passed, build and send JSON ===
-  FirebaseJson telemetryJson;
-
-  telemetryJson.set("node_id", nodeId);
-  telemetryJson.set("type", "telemetry");
-  telemetryJson.set("battery", batteryVoltage);
-  telemetryJson.set("wifi_rssi", wifiRSSI);
-  telemetryJson.set("cpu_temp", cpuTemp);
-  telemetryJson.set("uptime_ms", uptime);
-  telemetryJson.set("free_heap", freeHeap);
-  telemetryJson.set("sos_status", sos_status);
-  telemetryJson.set("cooling_active", coolingActive);
-  telemetryJson.set("temp_threshold", tempThreshold);
-  telemetryJson.set("timestamp", millis());
+  JsonDocument telemetryJson;
+
+  telemetryJson["node_id"] = nodeId;
+  telemetryJson["type"] = "telemetry";
+  telemetryJson["battery"] = batteryVoltage;
+  telemetryJson["wifi_rssi"] = wifiRSSI;
+  telemetryJson["cpu_temp"] = cpuTemp;
+  telemetryJson["uptime_ms"] = uptime;
+  telemetryJson["free_heap"] = freeHeap;
+  telemetryJson["sos_status"] = sos_status;
+  telemetryJson["cooling_active"] = coolingActive;
+  telemetryJson["temp_threshold"] = tempThreshold;
+  telemetryJson["timestamp"] = millis();
+  telemetryJson["uplink"] = getUplinkBackendName();
+  telemetryJson["uplink_published"] = getUplinkStats().published;
+  telemetryJson["uplink_failed"] = getUplinkStats().failed;
+  telemetryJson["uplink_pending"] = getUplinkStats().pending;
+  telemetryJson["uplink_queued"] = getUplinkQueuedCount();
+  telemetryJson["auth_round_trips"] = getAuthRoundTrips();
+  if (getFirstUploadTime() > 0) {
+    telemetryJson["first_upload_ms"] = getFirstUploadTime();
+  }
 
   // Add GPS data if enabled and valid (already validated above)
   if (gpsEnabled && isGPSValid()) {
-    telemetryJson.set("latitude", getCurrentLatitude());
-    telemetryJson.set("longitude", getCurrentLongitude());
-    telemetryJson.set("gps_time", getGPSTimeString());
+    telemetryJson["latitude"] = getCurrentLatitude();
+    telemetryJson["longitude"] = getCurrentLongitude();
+    telemetryJson["gps_time"] = getGPSTimeString();
   }
 
-  if (Firebase.RTDB.pushJSON(&fbdo, "/basecamp/telemetry", &telemetryJson)) {
-    Serial.println("📊 ✓ Validated telemetry pushed to Firebase");
-  } else {
-    Serial.print("❌ Telemetry error: ");
-    Serial.println(fbdo.errorReason());
-  }
+  String telemetry;
+  serializeJson(telemetryJson, telemetry);
+  sendTelemetryToUplink(telemetry);
 }
 
 float readBatteryVoltage() {
@@ -17,7 +17,7 @@ extern float tempThreshold;
 
 // === TELEMETRY FUNCTIONS ===
 void updateTelemetry();
-void sendTelemetryToFirebase();
+void sendTelemetryToCloud();
 float readBatteryVoltage();
 float readCPUTemperature();
 String getUptimeString();
@@ -0,0 +1,253 @@
+#include "Uplink_Module.h"
+
+// === ACTIVE BACKEND ===
+static const UplinkBackend* activeBackend = &firebaseBackend;
+static UplinkStats uplinkStats = {0, 0, 0, 0, 0, 0};
+
+static void recordLatency(unsigned long latency) {
+  uplinkStats.published++;
+  uplinkStats.totalLatencyMs += latency;
+  if (latency > uplinkStats.maxLatencyMs) {
+    uplinkStats.maxLatencyMs = latency;
+  }
+}
+
+static void recordPublish(bool success, unsigned long startTime) {
+  if (!success) {
+    uplinkStats.failed++;
+  } else if (activeBackend->acknowledgesLater) {
+    // Counted once the backend reports the server's answer
+    uplinkStats.pending++;
+  } else {
+    recordLatency(millis() - startTime);
+  }
+}
+
+void uplinkPublishAcked(unsigned long latencyMs) {
+  if (uplinkStats.pending > 0) uplinkStats.pending--;
+  recordLatency(latencyMs);
+}
+
+void uplinkPublishDropped() {
+  if (uplinkStats.pending > 0) uplinkStats.pending--;
+  uplinkStats.failed++;
+}
+
+void initializeUplink() {
+  prefs.begin("config", true);
+  String backendName = prefs.getString("uplink_backend", DEFAULT_UPLINK_BACKEND);
+  prefs.end();
+
+  if (backendName == mqttBackend.name) {
+    activeBackend = &mqttBackend;
+  } else {
+    activeBackend = &firebaseBackend;
+  }
+
+  Serial.print("Uplink backend: ");
+  Serial.println(activeBackend->name);
+
+  activeBackend->begin();
+}
+
+void handleUplink() {
+  activeBackend->loop();
+
+  static unsigned long lastStatsReport = 0;
+  if (millis() - lastStatsReport > UPLINK_STATS_INTERVAL) {
+    printUplinkStatistics();
+    lastStatsReport = millis();
+  }
+}
+
+bool isUplinkReady() {
+  return activeBackend->isReady();
+}
+
+void forwardPacketToUplink(String packet) {
+  if (!isUplinkReady()) return;
+
+  // === STEP 1: Basic packet validation ===
+  if (packet.length() == 0) {
+    Serial.println("⚠️ Rejected: Empty packet");
+    uplinkStats.rejected++;
+    return;
+  }
+
+  if (packet.length() > 2048) {
+    Serial.println("⚠️ Rejected: Packet too large (>2048 bytes)");
+    uplinkStats.rejected++;
+    return;
+  }
+
+  if (!isValidString(packet, 2048)) {
+    Serial.println("⚠️ Rejected: Packet contains invalid characters");
+    uplinkStats.rejected++;
+    return;
+  }
+
+  // === STEP 2: JSON validation ===
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, packet);
+  if (error || !doc.is<JsonObject>()) {
+    Serial.println("⚠️ Rejected: Invalid JSON format");
+    Serial.print("Packet content: ");
+    Serial.println(packet);
+    uplinkStats.rejected++;
+    return;
+  }
+
+  // === STEP 3: Node ID validation ===
+  if (!doc["node_id"].is<const char*>()) {
+    Serial.println("⚠️ Rejected: No node_id found in packet");
+    uplinkStats.rejected++;
+    return;
+  }
+
+  String receivedNodeId = doc["node_id"].as<String>();
+  if (!isValidNodeId(receivedNodeId)) {
+    Serial.println("⚠️ Rejected: Invalid node_id format");
+    Serial.print("Invalid node_id: ");
+    Serial.println(receivedNodeId);
+    uplinkStats.rejected++;
+    return;
+  }
+
+  // === STEP 4: Validate numeric fields if present ===
+  // Check latitude if present
+  if (!doc["latitude"].isNull()) {
+    float lat = doc["latitude"].as<float>();
+    if (!isValidLatitude(lat)) {
+      Serial.println("⚠️ Rejected: Invalid latitude value");
+      Serial.print("Latitude: ");
+      Serial.println(lat);
+      uplinkStats.rejected++;
+      return;
+    }
+  }
+
+  // Check longitude if present
+  if (!doc["longitude"].isNull()) {
+    float lon = doc["longitude"].as<float>();
+    if (!isValidLongitude(lon)) {
+      Serial.println("⚠️ Rejected: Invalid longitude value");
+      Serial.print("Longitude: ");
+      Serial.println(lon);
+      uplinkStats.rejected++;
+      return;
+    }
+  }
+
+  // Check heart rate if present (typical range 30-220 bpm)
+  if (!doc["heart_rate"].isNull()) {
+    int hr = doc["heart_rate"].as<int>();
+    if (!isValidInt(hr, 30, 220)) {
+      Serial.println("⚠️ Rejected: Invalid heart_rate value");
+      Serial.print("Heart rate: ");
+      Serial.println(hr);
+      uplinkStats.rejected++;
+      return;
+    }
+  }
+
+  // Check temperature if present (range -40 to 85°C for ESP32)
+  if (!doc["temperature"].isNull()) {
+    float temp = doc["temperature"].as<float>();
+    if (!isValidFloat(temp, -40.0, 85.0)) {
+      Serial.println("⚠️ Rejected: Invalid temperature value");
+      Serial.print("Temperature: ");
+      Serial.println(temp);
+      uplinkStats.rejected++;
+      return;
+    }
+  }
+
+  // Check battery voltage if present (typical range 2.5-4.5V)
+  if (!doc["battery"].isNull()) {
+    float battery = doc["battery"].as<float>();
+    if (!isValidFloat(battery, 0.0, 5.0)) {
+      Serial.println("⚠️ Rejected: Invalid battery voltage");
+      Serial.print("Battery: ");
+      Serial.println(battery);
+      uplinkStats.rejected++;
+      return;
+    }
+  }
+
+  // Check WiFi RSSI if present (typical range -120 to 0 dBm)
+  if (!doc["wifi_rssi"].isNull()) {
+    int rssi = doc["wifi_rssi"].as<int>();
+    if (!isValidInt(rssi, -120, 0)) {
+      Serial.println("⚠️ Rejected: Invalid WiFi RSSI");
+      Serial.print("RSSI: ");
+      Serial.println(rssi);
+      uplinkStats.rejected++;
+      return;
+    }
+  }
+
+  // === STEP 5: All validation passed, hand over to the backend ===
+  unsigned long startTime = millis();
+  bool success = activeBackend->publishPacket(receivedNodeId, packet);
+  recordPublish(success, startTime);
+
+  if (success) {
+    String message = "📥 ✓ Validated log ";
+    message += activeBackend->acknowledgesLater ? "queued for " : "sent via ";
+    message += activeBackend->name;
+    message += " for node: ";
+    message += receivedNodeId;
+    Serial.println(message);
+  }
+}
+
+void sendTelemetryToUplink(const String& telemetry) {
+  if (!isUplinkReady()) return;
+
+  unsigned long startTime = millis();
+  bool success = activeBackend->publishTelemetry(telemetry);
+  recordPublish(success, startTime);
+
+  if (success) {
+    Serial.print(activeBackend->acknowledgesLater ? "📊 ✓ Validated telemetry queued for "
+                                                  : "📊 ✓ Validated telemetry sent via ");
+    Serial.println(activeBackend->name);
+  }
+}
+
+String getUplinkBackendName() {
+  return activeBackend->name;
+}
+
+const UplinkStats& getUplinkStats() {
+  return uplinkStats;
+}
+
+int getUplinkQueuedCount() {
+  return activeBackend->queuedCount ? activeBackend->queuedCount() : 0;
+}
+
+void printUplinkStatistics() {
+  Serial.println("=== Uplink Statistics ===");
+  Serial.print("Backend: ");
+  Serial.println(activeBackend->name);
+  Serial.print("Published: ");
+  Serial.println(uplinkStats.published);
+  Serial.print("Failed: ");
+  Serial.println(uplinkStats.failed);
+  Serial.print("Rejected: ");
+  Serial.println(uplinkStats.rejected);
+  if (activeBackend->acknowledgesLater) {
+    Serial.print("Awaiting Ack: ");
+    Serial.println(uplinkStats.pending);
+    Serial.print("Queued Offline: ");
+    Serial.println(getUplinkQueuedCount());
+  }
+  Serial.print("Avg Publish Time: ");
+  Serial.print(uplinkStats.published > 0 ? uplinkStats.totalLatencyMs / uplinkStats.published : 0);
+  Serial.println(" ms");
+  Serial.print("Max Publish Time: ");
+  Serial.print(uplinkStats.maxLatencyMs);
+  Serial.println(" ms");
+  Serial.println("=========================");
+}
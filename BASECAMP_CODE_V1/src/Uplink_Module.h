@@ -0,0 +1,56 @@
+#ifndef UPLINK_MODULE_H
+#define UPLINK_MODULE_H
+
+#include <Arduino.h>
+#include "Common.h"
+
+// === UPLINK SETTINGS ===
+#define DEFAULT_UPLINK_BACKEND "firebase"
+#define UPLINK_STATS_INTERVAL 60000
+
+// === UPLINK BACKEND INTERFACE ===
+// Each cloud backend fills in one of these; the rest of the basecamp only
+// talks to the active backend through the forward/send functions below.
+//
+// A backend that sets acknowledgesLater only takes the record from its
+// publish functions; it then reports the outcome through
+// uplinkPublishAcked() or uplinkPublishDropped() once the server has
+// answered, and only then is the record counted as published.
+struct UplinkBackend {
+  const char* name;
+  void (*begin)();
+  void (*loop)();
+  bool (*isReady)();
+  bool (*publishPacket)(const String& nodeId, const String& packet);
+  bool (*publishTelemetry)(const String& telemetry);
+  bool acknowledgesLater;
+  int (*queuedCount)();           // Records not yet sent, NULL without a queue
+};
+
+struct UplinkStats {
+  unsigned long published;        // Confirmed by the server
+  unsigned long failed;
+  unsigned long rejected;
+  unsigned long pending;          // Taken by the backend, outcome not known yet
+  unsigned long totalLatencyMs;   // From hand-over to confirmation
+  unsigned long maxLatencyMs;
+};
+
+// === AVAILABLE BACKENDS ===
+extern const UplinkBackend firebaseBackend;
+extern const UplinkBackend mqttBackend;
+
+// === UPLINK FUNCTIONS ===
+void initializeUplink();
+void handleUplink();
+bool isUplinkReady();
+void forwardPacketToUplink(String packet);
+void sendTelemetryToUplink(const String& telemetry);
+String getUplinkBackendName();
+const UplinkStats& getUplinkStats();
+int getUplinkQueuedCount();
+void uplinkPublishAcked(unsigned long latencyMs);
+void uplinkPublishDropped();
+void printUplinkStatistics();
+
+#endif
@@ -1,6 +1,8 @@
 #include "WiFi_Config.h"
 #include <Adafruit_SSD1306.h>
 #include "Common.h"
+#include "Display_Module.h"
+#include "MQTT_Module.h"
 
 // External references
 extern Adafruit_SSD1306 display;
@@ -12,7 +14,8 @@ extern bool signupOK;
 extern bool configModeActive;
 
 // Forward declarations
-void initializeFirebase();
+void initializeLocalAPI();
+bool isLocalAPIActive();
 
 // === CONFIG BUTTON HANDLING ===
 void checkConfigButton() {
@@ -31,6 +34,7 @@ void checkConfigButton() {
       configMode = true;
       configModeActive = true; // Set global flag
       
+      lockDisplay();
       display.clearDisplay();
       display.setCursor(0,0);
       display.setTextSize(1);
@@ -38,6 +42,7 @@ void checkConfigButton() {
       display.setCursor(0,10);
       display.println("Starting Portal...");
       display.display();
+      unlockDisplay();
       delay(1000);
       
       startConfigPortal();
@@ -105,17 +110,19 @@ void initializeWiFi() {
     display.print("IP: ");
     display.println(WiFi.localIP());
     display.setCursor(0,20);
-    display.println("Initializing Firebase...");
+    display.println("Initializing Uplink...");
     display.display();
     Serial.println("\nWiFi connected");
     
-    initializeFirebase();
+    initializeUplink();
+    initializeLocalAPI();
     
     display.clearDisplay();
     display.setCursor(0,0);
     display.println("WiFi: Connected");
     display.setCursor(0,10);
-    display.println("Firebase: Ready");
+    display.print("Uplink: ");
+    display.println(getUplinkBackendName());
     display.setCursor(0,20);
     display.print("IP: ");
     display.println(WiFi.localIP());
@@ -134,6 +141,7 @@ void initializeWiFi() {
 
 void showConfigPortalDisplay(IPAddress apIP) {
   // Persistent config portal display
+  lockDisplay();
   display.clearDisplay();
   display.setCursor(0,0);
   display.setTextSize(1);
@@ -151,6 +159,7 @@ void showConfigPortalDisplay(IPAddress apIP) {
   display.setCursor(0,50);
   display.println("Press RESET to exit");
   display.display();
+  unlockDisplay();
 }
 
 void startConfigPortal() {
@@ -176,6 +185,11 @@ void startConfigPortal() {
   String currentWifiPassword = prefs.getString("wifi_password", WIFI_PASSWORD);
   String currentFirebaseUrl = prefs.getString("firebase_url", DEFAULT_DATABASE_URL);
   String currentFirebaseApiKey = prefs.getString("firebase_api_key", DEFAULT_API_KEY);
+  String currentUplink = prefs.getString("uplink_backend", DEFAULT_UPLINK_BACKEND);
+  String currentMqttHost = prefs.getString("mqtt_host", "");
+  uint32_t currentMqttPort = prefs.getUInt("mqtt_port", DEFAULT_MQTT_PORT);
+  String currentMqttUser = prefs.getString("mqtt_user", "");
+  String currentMqttPassword = prefs.getString("mqtt_password", "");
   prefs.end();
 
   // Convert sync word to hex string
@@ -184,9 +198,11 @@ void startConfigPortal() {
 
   String sync = String(syncBuffer);
   String gpsChecked = currentGpsEnabled ? "checked" : "";
+  String mqttSelected = currentUplink == "mqtt" ? "selected" : "";
+  String mqttPort = String(currentMqttPort);
 
   // Serve web page
-  server.on("/", HTTP_GET, [sync, gpsChecked, currentWifiSSID, currentWifiPassword, currentFirebaseUrl, currentFirebaseApiKey](AsyncWebServerRequest *request){
+  server.on("/", HTTP_GET, [sync, gpsChecked, currentWifiSSID, currentWifiPassword, currentFirebaseUrl, currentFirebaseApiKey, mqttSelected, currentMqttHost, mqttPort, currentMqttUser, currentMqttPassword](AsyncWebServerRequest *request){
     String html = R"rawliteral(
 <!DOCTYPE html>
 <html lang="en">
@@ -231,14 +247,14 @@ void startConfigPortal() {
       margin-bottom: 20px;
       color: #d1d5db;
     }
-    input[type='text'], button {
+    input[type='text'], select, button {
       padding: 12px;
       margin: 10px 0;
       border: none;
       border-radius: 8px;
       font-size: 16px;
     }
-    input[type='text'] {
+    input[type='text'], select {
       background-color: #f3f4f6;
       color: #000;
       width: 100%;
@@ -294,6 +310,26 @@ void startConfigPortal() {
     html += currentFirebaseUrl;
     html += R"rawliteral(' required>
       
+      <h3>Uplink Settings</h3>
+      <select name='uplink_backend'>
+        <option value='firebase'>Firebase (HTTPS)</option>
+        <option value='mqtt' )rawliteral";
+    html += mqttSelected;
+    html += R"rawliteral(>MQTT</option>
+      </select>
+      <input type='text' name='mqtt_host' placeholder='MQTT Broker Host' value=')rawliteral";
+    html += currentMqttHost;
+    html += R"rawliteral('>
+      <input type='text' name='mqtt_port' placeholder='MQTT Port (1883)' value=')rawliteral";
+    html += mqttPort;
+    html += R"rawliteral('>
+      <input type='text' name='mqtt_user' placeholder='MQTT Username (optional)' value=')rawliteral";
+    html += currentMqttUser;
+    html += R"rawliteral('>
+      <input type='password' name='mqtt_password' placeholder='MQTT Password (optional)' value=')rawliteral";
+    html += currentMqttPassword;
+    html += R"rawliteral('>
+      
       <h3>GPS Settings</h3>
       <div class="checkbox-group">
         <input type="checkbox" id="gpsEnable" name="gps_enabled" )rawliteral";
@@ -319,6 +355,11 @@ void startConfigPortal() {
     String firebaseApiKey = request->getParam("firebase_api_key", true)->value();
     String firebaseUrl = request->getParam("firebase_url", true)->value();
     bool gpsEnabled = request->hasParam("gps_enabled", true);
+    String uplinkBackend = request->hasParam("uplink_backend", true) ? request->getParam("uplink_backend", true)->value() : DEFAULT_UPLINK_BACKEND;
+    String mqttHost = request->hasParam("mqtt_host", true) ? request->getParam("mqtt_host", true)->value() : "";
+    String mqttPort = request->hasParam("mqtt_port", true) ? request->getParam("mqtt_port", true)->value() : String(DEFAULT_MQTT_PORT);
+    String mqttUser = request->hasParam("mqtt_user", true) ? request->getParam("mqtt_user", true)->value() : "";
+    String mqttPassword = request->hasParam("mqtt_password", true) ? request->getParam("mqtt_password", true)->value() : "";
     
     // Save all settings
     prefs.begin("config", false);
@@ -328,6 +369,11 @@ void startConfigPortal() {
     prefs.putString("firebase_api_key", firebaseApiKey);
     prefs.putString("firebase_url", firebaseUrl);
     prefs.putBool("gps_enabled", gpsEnabled);
+    prefs.putString("uplink_backend", uplinkBackend);
+    prefs.putString("mqtt_host", mqttHost);
+    prefs.putUInt("mqtt_port", mqttPort.toInt() > 0 ? mqttPort.toInt() : DEFAULT_MQTT_PORT);
+    prefs.putString("mqtt_user", mqttUser);
+    prefs.putString("mqtt_password", mqttPassword);
     prefs.end();
     
     // Reload Firebase configuration
@@ -346,6 +392,14 @@ void startConfigPortal() {
     Serial.println(firebaseUrl);
     Serial.print("GPS Enabled: ");
     Serial.println(gpsEnabled ? "Yes" : "No");
+    Serial.print("Uplink: ");
+    Serial.println(uplinkBackend);
+    Serial.print("MQTT Broker: ");
+    Serial.print(mqttHost);
+    Serial.print(":");
+    Serial.println(mqttPort);
+    Serial.print("MQTT User: ");
+    Serial.println(mqttUser.length() > 0 ? mqttUser : String("(none)"));
     
     request->send(200, "text/html", 
       "<div style='text-align:center; font-family:Arial; padding:50px;'>"
@@ -358,7 +412,10 @@ void startConfigPortal() {
     ESP.restart();
   });
 
-  server.begin();
+  // The local API may already have the server listening
+  if (!isLocalAPIActive()) {
+    server.begin();
+  }
   
   // Keep config portal active with persistent display
   while (configModeActive) {
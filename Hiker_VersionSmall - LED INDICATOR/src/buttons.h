@@ -2,6 +2,7 @@
 #define BUTTONS_H
 
 #include "config.h"
+#include "led_patterns.h"
 
 // Forward declarations
 void startConfigPortal();
@@ -23,12 +24,8 @@ void checkConfigButton() {
     
     // Enter config mode after long press
     if (!configMode && millis() - buttonPressStart >= LONG_PRESS_DURATION) {
-      // Indicate config mode with alternating LED pattern
-      for (int i = 0; i < 6; i++) {
-        digitalWrite(LED_STATUS, i % 2);
-        digitalWrite(LED_TRANSMIT, (i + 1) % 2);
-        delay(200);
-      }
+      // Indicate config mode with alternating LED pattern until restart
+      ledSetPattern(LED_PATTERN_CONFIG, true);
       
       Serial.println("CONFIG MODE ACTIVE");
       Serial.printf("SSID: %s\n", AP_SSID.c_str());
@@ -45,11 +42,25 @@ void checkConfigButton() {
   }
 }
 
+// Toggles once per press; the level has to hold for SOS_DEBOUNCE_TIME
+// before it counts, so contact bounce is ignored without blocking loop()
 void checkSOSButton() {
-  if (digitalRead(SOS_BUTTON) == LOW) {
+  static int lastReading = HIGH;
+  static int stableState = HIGH;
+  static unsigned long lastChange = 0;
+
+  int reading = digitalRead(SOS_BUTTON);
+  if (reading != lastReading) {
+    lastReading = reading;
+    lastChange = millis();
+    return;
+  }
+  if (reading == stableState || millis() - lastChange < SOS_DEBOUNCE_TIME) return;
+
+  stableState = reading;
+  if (stableState == LOW) {
     Serial.println("SOS BUTTON CLICK");
     sos_status = !sos_status;  // Toggle SOS status
-    delay(300);  // Simple debounce
   }
 }
 
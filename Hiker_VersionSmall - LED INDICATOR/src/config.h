@@ -30,6 +30,10 @@
 // LED Indicators - Using GPIO 8 and GPIO 9 as power sources for LEDs
 #define LED_STATUS     8  // GPIO8 - Status LED (system working)
 #define LED_TRANSMIT   9  // GPIO9 - Transmit LED (data transmission)
+#define LED_STATUS_CHANNEL    0     // LEDC channels driving the LEDs
+#define LED_TRANSMIT_CHANNEL  1
+#define LED_PWM_FREQUENCY     5000
+#define LED_BRIGHTNESS        64    // 0-255, dimmed to save power
 
 // Battery - ADC pin for battery voltage monitoring
 #define BATTERY_PIN 3
@@ -40,6 +44,7 @@ const float MIN_BATTERY_VOLTAGE = 3.3;  // considered empty
 const float VOLTAGE_DIVIDER_RATIO = 2.0;  // 100k:100k = divide by 2
 
 const int LONG_PRESS_DURATION = 3000;  // 3 seconds for config mode activation
+const int SOS_DEBOUNCE_TIME = 50;      // ms the SOS button must hold a level
 const String AP_SSID = "CONFIG NODE 01";
 
 // ============= GPS ICON BITMAP =============
@@ -2,44 +2,26 @@
 #define DISPLAY_H
 
 #include "config.h"
+#include "led_patterns.h"
 
 // Forward declaration for LoRa health check
 extern bool isLoRaHealthy();
 
-// LED state variables
-bool greenLedState = false;    // Green LED (SCL) - indicates everything working
-bool redLedState = false;      // Red LED (SDA) - indicates errors/issues
+// Health state shown on the LEDs
 bool isSystemHealthy = false;  // Overall system health status
-unsigned long lastBlinkTime = 0;
 unsigned long lastErrorCheck = 0;
-const unsigned long BLINK_INTERVAL = 1000;     // 1000ms slow blink when healthy
 const unsigned long ERROR_CHECK_INTERVAL = 500; // Check for errors every 500ms
 
 void initDisplay() {
-  // Initialize LED pins as outputs
-  pinMode(LED_STATUS, OUTPUT);  // Red LED (SDA)
-  pinMode(LED_TRANSMIT, OUTPUT); // Green LED (SCL)
-  
-  // Start with both LEDs off
-  digitalWrite(LED_STATUS, LOW);   // Red LED off
-  digitalWrite(LED_TRANSMIT, LOW); // Green LED off
-  
+  // LEDs are driven by the pattern engine from here on
+  initLEDs();
   Serial.println("LED indicators initialized - Red(GPIO8/SDA) Green(GPIO9/SCL)");
 }
 
 void showSplash() {
-  // Startup sequence: Flash both LEDs 3 times
+  // Startup sequence: Flash both LEDs 3 times, plays while setup continues
   Serial.println("System starting up...");
-  for (int i = 0; i < 3; i++) {
-    digitalWrite(LED_STATUS, HIGH);   // Red LED
-    digitalWrite(LED_TRANSMIT, HIGH); // Green LED
-    delay(300);
-    digitalWrite(LED_STATUS, LOW);    // Red LED
-    digitalWrite(LED_TRANSMIT, LOW);  // Green LED
-    delay(300);
-  }
-  delay(1000);  // Additional delay for consistent timing
-  Serial.println("Startup sequence completed");
+  ledShow(LED_PATTERN_STARTUP);
 }
 
 void updateDisplay(float lat, float lng, float elevation, String timeStr, int batteryPercent, String loraStatus, int packetCount, bool sos_status) {
@@ -65,30 +47,11 @@ void updateDisplay(float lat, float lng, float elevation, String timeStr, int ba
                   isSystemHealthy ? "HEALTHY" : "ERROR");
   }
   
-  // LED Control Logic
-  if (isSystemHealthy) {
-    // System is healthy - Green LED blinks, Red LED off
-    unsigned long blinkRate = sos_status ? 200 : BLINK_INTERVAL;  // Fast blink for SOS
-    
-    if (currentTime - lastBlinkTime >= blinkRate) {
-      greenLedState = !greenLedState;
-      digitalWrite(LED_TRANSMIT, greenLedState ? HIGH : LOW);  // Green LED (SCL)
-      digitalWrite(LED_STATUS, LOW);                           // Red LED off (SDA)
-      lastBlinkTime = currentTime;
-      
-      Serial.printf("GREEN LED %s - System Working Perfect\n", greenLedState ? "ON" : "OFF");
-    }
-  } else {
-    // System has errors - Red LED blinks, Green LED off
-    if (currentTime - lastBlinkTime >= 250) {  // Fast blink for errors
-      redLedState = !redLedState;
-      digitalWrite(LED_STATUS, redLedState ? HIGH : LOW);      // Red LED (SDA)
-      digitalWrite(LED_TRANSMIT, LOW);                         // Green LED off (SCL)
-      lastBlinkTime = currentTime;
-      
-      Serial.printf("RED LED %s - System Error Detected\n", redLedState ? "ON" : "OFF");
-    }
-  }
+  // LED patterns - the engine only reacts when the winning pattern changes
+  ledSetPattern(LED_PATTERN_GPS_SEARCH, false);
+  ledSetPattern(LED_PATTERN_HEALTHY, isSystemHealthy);
+  ledSetPattern(LED_PATTERN_ERROR, !isSystemHealthy);
+  ledSetPattern(LED_PATTERN_SOS, sos_status);
   
   // Print detailed status to Serial every 2 seconds
   static unsigned long lastSerialUpdate = 0;
@@ -101,17 +64,12 @@ void updateDisplay(float lat, float lng, float elevation, String timeStr, int ba
 }
 
 void showGPSSearching(String loraStatus, unsigned long lastSendTime) {
-  // When searching for GPS, system is not healthy - Red LED blinks to indicate GPS error
+  // When searching for GPS, system is not healthy - Red LED blips to indicate GPS search
   unsigned long currentTime = millis();
-  
-  if (currentTime - lastBlinkTime >= 300) {  // Fast blink to indicate GPS searching
-    redLedState = !redLedState;
-    digitalWrite(LED_STATUS, redLedState ? HIGH : LOW);    // Red LED blinks (SDA)
-    digitalWrite(LED_TRANSMIT, LOW);                       // Green LED off (SCL)
-    lastBlinkTime = currentTime;
-    
-    Serial.printf("RED LED %s - Searching for GPS signal\n", redLedState ? "ON" : "OFF");
-  }
+  isSystemHealthy = false;
+  ledSetPattern(LED_PATTERN_HEALTHY, false);
+  ledSetPattern(LED_PATTERN_ERROR, false);
+  ledSetPattern(LED_PATTERN_GPS_SEARCH, true);
   
   // Print GPS search status to Serial
   static unsigned long lastGPSMessage = 0;
@@ -125,15 +83,8 @@ void showGPSSearching(String loraStatus, unsigned long lastSendTime) {
 
 void indicateTransmission() {
   // Brief flash of green LED to indicate successful transmission
-  // Only if system is healthy (otherwise the health status takes priority)
-  if (isSystemHealthy) {
-    digitalWrite(LED_TRANSMIT, HIGH);  // Green LED brief flash
-    Serial.println("GREEN LED FLASH - Data transmitted successfully");
-    delay(50);  // Very brief flash
-    // LED will return to normal blinking pattern in updateDisplay
-  } else {
-    Serial.println("Transmission attempted but system not healthy - RED LED continues blinking");
-  }
+  // Only shows if nothing more important is playing (errors take priority)
+  ledShow(LED_PATTERN_TRANSMIT);
 }
 
 #endif // DISPLAY_H
\ No newline at end of file
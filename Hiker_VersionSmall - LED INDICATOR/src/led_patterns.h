@@ -0,0 +1,199 @@
+#ifndef LED_PATTERNS_H
+#define LED_PATTERNS_H
+
+#include <esp_timer.h>
+#include "config.h"
+
+// ============= LED PATTERN ENGINE =============
+// Both LEDs are driven through LEDC so they can be dimmed, and stepped by
+// an esp_timer so blinking never depends on loop() timing. Callers only
+// switch patterns on or off; the highest-priority active pattern plays.
+
+// Patterns in ascending priority
+enum LedPatternId {
+  LED_PATTERN_HEALTHY,     // Short dim green blip, everything working
+  LED_PATTERN_GPS_SEARCH,  // Red blip while waiting for a fix
+  LED_PATTERN_TRANSMIT,    // One green flash per packet sent
+  LED_PATTERN_ERROR,       // Red blink, battery/LoRa/GPS problem
+  LED_PATTERN_SOS,         // Morse SOS on the red LED
+  LED_PATTERN_CONFIG,      // Alternating red/green while the portal is up
+  LED_PATTERN_STARTUP,     // Both LEDs flash three times at boot
+  LED_PATTERN_LORA_FAIL,   // Both LEDs flash fast when LoRa is unavailable
+  LED_PATTERN_COUNT
+};
+
+struct LedStep {
+  uint8_t status;     // LED_STATUS (red) duty
+  uint8_t transmit;   // LED_TRANSMIT (green) duty
+  uint16_t duration;  // ms
+};
+
+struct LedPattern {
+  const LedStep* steps;
+  uint8_t stepCount;
+  bool oneShot;       // Deactivates itself after one pass
+};
+
+#define LED_ON  LED_BRIGHTNESS
+#define LED_OFF 0
+
+const LedStep LED_STEPS_HEALTHY[] = {
+  {LED_OFF, LED_ON, 40}, {LED_OFF, LED_OFF, 1960}
+};
+const LedStep LED_STEPS_GPS_SEARCH[] = {
+  {LED_ON, LED_OFF, 60}, {LED_OFF, LED_OFF, 540}
+};
+const LedStep LED_STEPS_TRANSMIT[] = {
+  {LED_OFF, LED_ON, 80}, {LED_OFF, LED_OFF, 20}
+};
+const LedStep LED_STEPS_ERROR[] = {
+  {LED_ON, LED_OFF, 250}, {LED_OFF, LED_OFF, 250}
+};
+const LedStep LED_STEPS_SOS[] = {
+  {LED_ON, LED_OFF, 150}, {LED_OFF, LED_OFF, 150},
+  {LED_ON, LED_OFF, 150}, {LED_OFF, LED_OFF, 150},
+  {LED_ON, LED_OFF, 150}, {LED_OFF, LED_OFF, 450},
+  {LED_ON, LED_OFF, 450}, {LED_OFF, LED_OFF, 150},
+  {LED_ON, LED_OFF, 450}, {LED_OFF, LED_OFF, 150},
+  {LED_ON, LED_OFF, 450}, {LED_OFF, LED_OFF, 450},
+  {LED_ON, LED_OFF, 150}, {LED_OFF, LED_OFF, 150},
+  {LED_ON, LED_OFF, 150}, {LED_OFF, LED_OFF, 150},
+  {LED_ON, LED_OFF, 150}, {LED_OFF, LED_OFF, 1050}
+};
+const LedStep LED_STEPS_CONFIG[] = {
+  {LED_ON, LED_OFF, 200}, {LED_OFF, LED_ON, 200}
+};
+const LedStep LED_STEPS_STARTUP[] = {
+  {LED_ON, LED_ON, 300}, {LED_OFF, LED_OFF, 300},
+  {LED_ON, LED_ON, 300}, {LED_OFF, LED_OFF, 300},
+  {LED_ON, LED_ON, 300}, {LED_OFF, LED_OFF, 300}
+};
+const LedStep LED_STEPS_LORA_FAIL[] = {
+  {LED_ON, LED_ON, 100}, {LED_OFF, LED_OFF, 100},
+  {LED_ON, LED_ON, 100}, {LED_OFF, LED_OFF, 100},
+  {LED_ON, LED_ON, 100}, {LED_OFF, LED_OFF, 100},
+  {LED_ON, LED_ON, 100}, {LED_OFF, LED_OFF, 100},
+  {LED_ON, LED_ON, 100}, {LED_OFF, LED_OFF, 100}
+};
+
+#define LED_STEPS(steps) steps, sizeof(steps) / sizeof(steps[0])
+
+const LedPattern LED_PATTERNS[LED_PATTERN_COUNT] = {
+  {LED_STEPS(LED_STEPS_HEALTHY), false},
+  {LED_STEPS(LED_STEPS_GPS_SEARCH), false},
+  {LED_STEPS(LED_STEPS_TRANSMIT), true},
+  {LED_STEPS(LED_STEPS_ERROR), false},
+  {LED_STEPS(LED_STEPS_SOS), false},
+  {LED_STEPS(LED_STEPS_CONFIG), false},
+  {LED_STEPS(LED_STEPS_STARTUP), true},
+  {LED_STEPS(LED_STEPS_LORA_FAIL), true}
+};
+
+// Engine state, stepped from the esp_timer task
+esp_timer_handle_t ledTimer = NULL;
+portMUX_TYPE ledLock = portMUX_INITIALIZER_UNLOCKED;
+volatile uint32_t ledActiveMask = 0;   // One bit per active LedPatternId
+int ledCurrentPattern = -1;
+uint8_t ledStepIndex = 0;
+
+// Function declarations
+void initLEDs();
+void ledSetPattern(LedPatternId pattern, bool active);
+void ledShow(LedPatternId pattern);
+
+int ledTopPattern(uint32_t mask) {
+  return mask == 0 ? -1 : 31 - __builtin_clz(mask);
+}
+
+void ledWrite(uint8_t status, uint8_t transmit) {
+  ledcWrite(LED_STATUS_CHANNEL, status);
+  ledcWrite(LED_TRANSMIT_CHANNEL, transmit);
+}
+
+// Play the next step of the winning pattern and arm the timer for its end
+void ledTimerCallback(void* arg) {
+  portENTER_CRITICAL(&ledLock);
+  int top = ledTopPattern(ledActiveMask);
+  if (top != ledCurrentPattern) {
+    ledCurrentPattern = top;
+    ledStepIndex = 0;
+  }
+  if (top >= 0 && ledStepIndex >= LED_PATTERNS[top].stepCount) {
+    ledStepIndex = 0;
+    if (LED_PATTERNS[top].oneShot) {
+      // Finished, fall back to whatever is underneath
+      ledActiveMask &= ~(1UL << top);
+      top = ledTopPattern(ledActiveMask);
+      ledCurrentPattern = top;
+    }
+  }
+  const LedStep* step = top >= 0 ? &LED_PATTERNS[top].steps[ledStepIndex++] : NULL;
+  portEXIT_CRITICAL(&ledLock);
+
+  if (step == NULL) {
+    ledWrite(LED_OFF, LED_OFF);
+    return;  // Nothing active, the timer stays idle
+  }
+  ledWrite(step->status, step->transmit);
+  esp_timer_start_once(ledTimer, (uint64_t)step->duration * 1000ULL);
+}
+
+// Restart stepping right away so a new top pattern shows without delay
+void ledRestart() {
+  esp_timer_stop(ledTimer);
+  esp_timer_start_once(ledTimer, 1);
+}
+
+void initLEDs() {
+  ledcSetup(LED_STATUS_CHANNEL, LED_PWM_FREQUENCY, 8);
+  ledcSetup(LED_TRANSMIT_CHANNEL, LED_PWM_FREQUENCY, 8);
+  ledcAttachPin(LED_STATUS, LED_STATUS_CHANNEL);
+  ledcAttachPin(LED_TRANSMIT, LED_TRANSMIT_CHANNEL);
+  ledWrite(LED_OFF, LED_OFF);
+
+  esp_timer_create_args_t args = {};
+  args.callback = ledTimerCallback;
+  args.name = "led";
+  esp_timer_create(&args, &ledTimer);
+}
+
+// Switch a pattern on or off; only touches the timer if the winner changes
+void ledSetPattern(LedPatternId pattern, bool active) {
+  if (ledTimer == NULL) return;
+
+  portENTER_CRITICAL(&ledLock);
+  uint32_t before = ledActiveMask;
+  if (active) {
+    ledActiveMask |= 1UL << pattern;
+  } else {
+    ledActiveMask &= ~(1UL << pattern);
+  }
+  bool changed = ledTopPattern(before) != ledTopPattern(ledActiveMask);
+  portEXIT_CRITICAL(&ledLock);
+
+  if (changed) {
+    ledRestart();
+  }
+}
+
+// Start a pattern from its first step, e.g. one transmit flash per packet.
+// One-shots that would be hidden by a higher pattern are not queued.
+void ledShow(LedPatternId pattern) {
+  if (ledTimer == NULL) return;
+
+  portENTER_CRITICAL(&ledLock);
+  ledActiveMask |= 1UL << pattern;
+  bool restart = ledTopPattern(ledActiveMask) == pattern;
+  if (restart) {
+    ledCurrentPattern = -1;  // Forces step 0 even if it was already playing
+  } else if (LED_PATTERNS[pattern].oneShot) {
+    ledActiveMask &= ~(1UL << pattern);  // Hidden by a higher pattern, drop it
+  }
+  portEXIT_CRITICAL(&ledLock);
+
+  if (restart) {
+    ledRestart();
+  }
+}
+
+#endif // LED_PATTERNS_H
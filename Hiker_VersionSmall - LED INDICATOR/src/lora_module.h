@@ -6,6 +6,7 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include "config.h"
+#include "led_patterns.h"
 
 // Forward declaration for LED indicators
 void indicateTransmission();
@@ -30,31 +31,18 @@ void initLoRa() {
   while (!LoRa.begin(LORA_BAND)) {
     Serial.printf("LoRa init failed! Retrying... (%d/%d)\n", retries + 1, maxRetries);
     
-    // Flash both LEDs to indicate error
-    digitalWrite(LED_STATUS, HIGH);
-    digitalWrite(LED_TRANSMIT, HIGH);
-    delay(200);
-    digitalWrite(LED_STATUS, LOW);
-    digitalWrite(LED_TRANSMIT, LOW);
-    delay(200);
+    // Blink the error pattern while retrying
+    ledSetPattern(LED_PATTERN_ERROR, true);
 
     retries++;
-    delay(600);  // Additional delay between retries
+    delay(1000);  // 1 second delay between retries
 
     if (retries >= maxRetries) {
       Serial.println("LoRa initialization failed after max retries. Continuing without LoRa.");
       loraInitialized = false;
       loraStatus = "Failed";
-      // Flash LEDs rapidly 5 times to indicate failure
-      for (int i = 0; i < 5; i++) {
-        digitalWrite(LED_STATUS, HIGH);
-        digitalWrite(LED_TRANSMIT, HIGH);
-        delay(100);
-        digitalWrite(LED_STATUS, LOW);
-        digitalWrite(LED_TRANSMIT, LOW);
-        delay(100);
-      }
-      delay(1000);
+      // Flash LEDs rapidly 5 times to indicate failure, then show the error
+      ledShow(LED_PATTERN_LORA_FAIL);
       return; // Continue without LoRa rather than halt
     }
   }
@@ -62,6 +50,7 @@ void initLoRa() {
   LoRa.setSyncWord(storedSync);
   loraInitialized = true;
   loraStatus = "Ready";
+  ledSetPattern(LED_PATTERN_ERROR, false);
   Serial.println("LoRa started successfully");
   Serial.printf("LoRa sync word: 0x%02X\n", storedSync);
 }
@@ -109,6 +98,12 @@ void relayLoRaPacket(String receivedPacket) {
     return;
   }
   
+  // Relay route beacons and routed frames describe the link they were
+  // heard on; repeating them would advertise routes that do not exist
+  if (doc["rb"].is<const char*>() || doc["to"].is<const char*>()) {
+    return;
+  }
+  
   // Get max hops from preferences
   Preferences prefs;
   prefs.begin("config", false);
@@ -1,30 +1,185 @@
 #ifndef BATTERY_H
 #define BATTERY_H
 
+#include <sys/time.h>
 #include "config.h"
 
+// Battery readings as last published by the battery task
+struct BatteryStatus {
+  bool valid;
+  float voltage;          // Smoothed cell voltage
+  float percent;          // From the discharge curve
+  float drainPerHour;     // % per hour over the recent window, 0 if unknown
+  float runtimeHours;     // Remaining runtime at that drain, -1 if unknown
+};
+
+// Li-ion resting voltage vs. state of charge, highest voltage first
+struct DischargePoint {
+  float voltage;
+  float percent;
+};
+
+const DischargePoint DISCHARGE_CURVE[] = {
+  {4.20, 100}, {4.10, 90}, {4.00, 80}, {3.92, 70}, {3.85, 60},
+  {3.80, 50},  {3.75, 40}, {3.71, 30}, {3.67, 20}, {3.61, 10},
+  {3.50, 5},   {3.30, 0}
+};
+const int DISCHARGE_CURVE_POINTS = sizeof(DISCHARGE_CURVE) / sizeof(DISCHARGE_CURVE[0]);
+
+// Battery task state - the task owns the ADC, everyone else reads the snapshot
+TaskHandle_t batteryTaskHandle = NULL;
+SemaphoreHandle_t batteryMutex = NULL;
+BatteryStatus batteryShared = {false, 0, 0, 0, -1};
+
+// Smoothed voltage and the percent history for the drain estimate, one
+// entry per BATTERY_HISTORY_INTERVAL. Survives deep sleep so the estimate
+// does not start over on every wake; cleared on every other kind of reset
+struct BatteryRTCState {
+  uint32_t magic;
+  float smoothed;
+  float history[BATTERY_HISTORY_SIZE];
+  int historyCount;
+  int historyHead;
+  int64_t lastHistoryUs;   // Wall-clock time of the newest entry, 0 if none
+};
+
+#define BATTERY_RTC_MAGIC 0x54424254  // "TBBT"
+
+RTC_DATA_ATTR BatteryRTCState batteryRTC;
+
 // Function declarations
 void initBattery();
 float readBatteryVoltage();
 int getBatteryPercentage(float voltage);
+BatteryStatus getBatteryStatus();
+
+// Interpolate the discharge curve
+float batteryPercentFromVoltage(float voltage) {
+  if (voltage >= DISCHARGE_CURVE[0].voltage) return 100;
+  for (int i = 1; i < DISCHARGE_CURVE_POINTS; i++) {
+    const DischargePoint& upper = DISCHARGE_CURVE[i - 1];
+    const DischargePoint& lower = DISCHARGE_CURVE[i];
+    if (voltage >= lower.voltage) {
+      return lower.percent + (voltage - lower.voltage) * (upper.percent - lower.percent) /
+                             (upper.voltage - lower.voltage);
+    }
+  }
+  return 0;
+}
+
+// Average BATTERY_OVERSAMPLE calibrated readings, in volts at the cell
+float sampleBatteryVoltage() {
+  uint32_t total = 0;
+  for (int i = 0; i < BATTERY_OVERSAMPLE; i++) {
+    // analogReadMilliVolts applies the eFuse ADC calibration
+    total += analogReadMilliVolts(BATTERY_PIN);
+  }
+  return (total / (float)BATTERY_OVERSAMPLE) / 1000.0 * VOLTAGE_DIVIDER_RATIO;
+}
+
+int64_t batteryWallClockUs() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (int64_t)now.tv_sec * 1000000LL + now.tv_usec;
+}
+
+void pushBatteryHistory(float percent) {
+  batteryRTC.history[batteryRTC.historyHead] = percent;
+  batteryRTC.historyHead = (batteryRTC.historyHead + 1) % BATTERY_HISTORY_SIZE;
+  if (batteryRTC.historyCount < BATTERY_HISTORY_SIZE) batteryRTC.historyCount++;
+}
+
+// One entry per elapsed interval. A deep sleep spans several, which are
+// filled in along a straight line so the entries stay evenly spaced
+void updateBatteryHistory(float percent) {
+  int64_t now = batteryWallClockUs();
+  if (batteryRTC.historyCount == 0) {
+    pushBatteryHistory(percent);
+    batteryRTC.lastHistoryUs = now;
+    return;
+  }
+
+  int64_t due = (now - batteryRTC.lastHistoryUs) / (BATTERY_HISTORY_INTERVAL * 1000LL);
+  if (due <= 0) return;
+
+  int newest = (batteryRTC.historyHead - 1 + BATTERY_HISTORY_SIZE) % BATTERY_HISTORY_SIZE;
+  float last = batteryRTC.history[newest];
+  // Older entries would be pushed straight out of the window again
+  int64_t first = due > BATTERY_HISTORY_SIZE ? due - BATTERY_HISTORY_SIZE + 1 : 1;
+  for (int64_t i = first; i <= due; i++) {
+    pushBatteryHistory(last + (percent - last) * i / due);
+  }
+  batteryRTC.lastHistoryUs += due * BATTERY_HISTORY_INTERVAL * 1000LL;
+}
+
+// Drain rate from the oldest and newest entries of the history window
+float batteryDrainPerHour() {
+  if (batteryRTC.historyCount < 2) return 0;
+  int oldest = (batteryRTC.historyHead - batteryRTC.historyCount + BATTERY_HISTORY_SIZE) % BATTERY_HISTORY_SIZE;
+  int newest = (batteryRTC.historyHead - 1 + BATTERY_HISTORY_SIZE) % BATTERY_HISTORY_SIZE;
+  float hours = (batteryRTC.historyCount - 1) * BATTERY_HISTORY_INTERVAL / 3600000.0;
+  return (batteryRTC.history[oldest] - batteryRTC.history[newest]) / hours;
+}
+
+void batteryTask(void* parameter) {
+  for (;;) {
+    batteryRTC.smoothed += BATTERY_SMOOTHING * (sampleBatteryVoltage() - batteryRTC.smoothed);
+    float smoothed = batteryRTC.smoothed;
+    float percent = batteryPercentFromVoltage(smoothed);
+
+    updateBatteryHistory(percent);
+
+    BatteryStatus status;
+    status.valid = true;
+    status.voltage = smoothed;
+    status.percent = percent;
+    status.drainPerHour = batteryDrainPerHour();
+    // Charging or too little history to tell
+    status.runtimeHours = status.drainPerHour >= BATTERY_MIN_DRAIN ? percent / status.drainPerHour : -1;
+
+    xSemaphoreTake(batteryMutex, portMAX_DELAY);
+    batteryShared = status;
+    xSemaphoreGive(batteryMutex);
+
+    vTaskDelay(pdMS_TO_TICKS(BATTERY_SAMPLE_INTERVAL));
+  }
+}
 
 void initBattery() {
   analogReadResolution(12);  // 0-4095
   analogSetAttenuation(ADC_11db);  // allow full 3.3V range
-  Serial.println("Battery monitoring initialized");
+
+  bool restored = esp_reset_reason() == ESP_RST_DEEPSLEEP && batteryRTC.magic == BATTERY_RTC_MAGIC;
+  if (!restored) {
+    memset(&batteryRTC, 0, sizeof(batteryRTC));
+    batteryRTC.magic = BATTERY_RTC_MAGIC;
+    batteryRTC.smoothed = sampleBatteryVoltage();
+  }
+
+  batteryMutex = xSemaphoreCreateMutex();
+  xTaskCreate(batteryTask, "battery", BATTERY_TASK_STACK_SIZE, NULL, 1, &batteryTaskHandle);
+  Serial.printf("Battery monitoring initialized (%d drain history entries kept)\n",
+                batteryRTC.historyCount);
+}
+
+BatteryStatus getBatteryStatus() {
+  BatteryStatus status = {false, 0, 0, 0, -1};
+  if (batteryMutex == NULL) return status;
+
+  xSemaphoreTake(batteryMutex, portMAX_DELAY);
+  status = batteryShared;
+  xSemaphoreGive(batteryMutex);
+  return status;
 }
 
+// Smoothed voltage from the battery task; does not touch the ADC
 float readBatteryVoltage() {
-  int raw = analogRead(BATTERY_PIN);
-  float voltage = (raw / 4095.0) * 3.3 * VOLTAGE_DIVIDER_RATIO;
-  return voltage;
+  return getBatteryStatus().voltage;
 }
 
 int getBatteryPercentage(float voltage) {
-  if (voltage >= MAX_BATTERY_VOLTAGE) return 100;
-  if (voltage <= MIN_BATTERY_VOLTAGE) return 0;
-  return (int)(((voltage - MIN_BATTERY_VOLTAGE) / (MAX_BATTERY_VOLTAGE - MIN_BATTERY_VOLTAGE)) * 100);
+  return (int)(batteryPercentFromVoltage(voltage) + 0.5);
 }
 
 #endif  // BATTERY_H
-// End of battery.h
\ No newline at end of file
+// End of battery.h
@@ -1,65 +1,297 @@
 #ifndef BUTTONS_H
 #define BUTTONS_H
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
 #include "config.h"
 
 // Forward declarations
-extern Adafruit_SSD1306 display;
 void startConfigPortal();
+void stopConfigPortal();
+void displayWake();
 
 // Button state variables
-extern unsigned long buttonPressStart;
 extern bool configMode;
 extern bool sos_status;
 
-void initButtons() {
-  pinMode(CONFIG_BUTTON, INPUT_PULLUP);
-  pinMode(SOS_BUTTON, INPUT_PULLUP);
-  Serial.println("Buttons initialized (Config and SOS only)");
+// ============= BUTTON GESTURES =============
+// Both buttons interrupt on every edge. The ISR only stamps the time and
+// wakes the button task, which waits out the bounce, samples the pin and
+// turns the result into gestures. Gestures are queued for loop(), and the
+// loop task is notified so it does not sit out its idle delay first.
+//
+// SOS: press to raise (sent at once), press again to resend, hold to cancel.
+// CONFIG: hold to open or close the config portal, double click to send a
+// report now.
+
+enum ButtonId {
+  BUTTON_CONFIG,
+  BUTTON_SOS,
+  BUTTON_COUNT
+};
+
+enum ButtonEventType {
+  BUTTON_EVENT_PRESS,         // Debounced press, sent before the gesture is known
+  BUTTON_EVENT_CLICK,
+  BUTTON_EVENT_DOUBLE_CLICK,
+  BUTTON_EVENT_HOLD,          // Held for BUTTON_HOLD_TIME
+  BUTTON_EVENT_LONG_PRESS     // Held for LONG_PRESS_DURATION
+};
+
+struct ButtonEvent {
+  ButtonId button;
+  ButtonEventType type;
+  uint32_t pressMicros;       // Edge time of the press that started the gesture
+};
+
+struct ButtonState {
+  uint8_t pin;
+  volatile bool edgePending;
+  volatile uint32_t edgeMicros;  // First edge seen by the ISR since the last sample
+  bool pressed;
+  bool holdSent;
+  bool longSent;
+  uint8_t clicks;
+  unsigned long pressedAt;
+  unsigned long releasedAt;
+  uint32_t pressMicros;
+};
+
+struct ButtonStats {
+  uint32_t presses;
+  uint32_t droppedEvents;
+  uint32_t immediateReports;
+  uint32_t lastLatencyMs;     // Press edge to end of LoRa transmit
+  uint32_t maxLatencyMs;
+  uint32_t avgLatencyMs;
+};
+
+ButtonState buttons[BUTTON_COUNT] = {
+  {CONFIG_BUTTON},
+  {SOS_BUTTON}
+};
+TaskHandle_t buttonTaskHandle = NULL;
+TaskHandle_t buttonLoopTask = NULL;
+QueueHandle_t buttonEvents = NULL;
+ButtonStats buttonStats = {};
+uint64_t buttonLatencyTotal = 0;
+bool sosActivatingPress = false;      // The current SOS press is the one that raised it
+bool immediateReportPending = false;
+uint32_t immediateReportMicros = 0;
+
+// Function declarations
+void initButtons();
+bool handleButtons();
+void notifyButtonsAfterWake();
+bool buttonEventsPending();
+void recordPressToAir();
+ButtonStats getButtonStats();
+
+void IRAM_ATTR onButtonEdge(void* arg) {
+  ButtonState* button = (ButtonState*)arg;
+  if (!button->edgePending) {
+    button->edgeMicros = micros();
+    button->edgePending = true;
+  }
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(buttonTaskHandle, &woken);
+  portYIELD_FROM_ISR(woken);
 }
 
-void checkConfigButton() {
-  if (digitalRead(CONFIG_BUTTON) == LOW) {
-    if (buttonPressStart == 0) buttonPressStart = millis();
-    
-    // Enter config mode after long press
-    if (!configMode && millis() - buttonPressStart >= LONG_PRESS_DURATION) {
-      display.clearDisplay();
-      display.setTextSize(1);
-      display.setTextColor(WHITE);
-      
-      display.setCursor(0, 0);
-      display.print("CONFIG MODE ACTIVE");
-      
-      display.setCursor(0, 12);
-      display.print("SSID: ");
-      display.println(AP_SSID);
-      
-      display.setCursor(0, 24);
-      display.print("GO TO: 192.168.4.1");
-      display.display();
-      
-      configMode = true;
-      startConfigPortal();
-      // Stay in config mode but yield to watchdog
-      while (configMode) {
-        delay(100);
-        yield(); // Yield to watchdog timer
-        // Handle config portal tasks here if needed
-        // The device can be restarted through the web interface
+void postButtonEvent(ButtonId id, ButtonEventType type) {
+  ButtonEvent event = {id, type, buttons[id].pressMicros};
+  if (xQueueSend(buttonEvents, &event, 0) != pdTRUE) {
+    buttonStats.droppedEvents++;
+    return;
+  }
+  if (buttonLoopTask != NULL) {
+    xTaskNotifyGive(buttonLoopTask);
+  }
+}
+
+// Sample one button and advance its gesture state machine
+void updateButton(ButtonId id, unsigned long now) {
+  ButtonState& button = buttons[id];
+  bool hadEdge = button.edgePending;
+  uint32_t edgeMicros = button.edgeMicros;
+  button.edgePending = false;
+
+  bool pressed = digitalRead(button.pin) == LOW;
+  if (pressed != button.pressed) {
+    button.pressed = pressed;
+    if (pressed) {
+      button.pressedAt = now;
+      button.pressMicros = hadEdge ? edgeMicros : micros();
+      button.holdSent = false;
+      button.longSent = false;
+      buttonStats.presses++;
+      postButtonEvent(id, BUTTON_EVENT_PRESS);
+    } else if (!button.holdSent) {
+      button.releasedAt = now;
+      if (++button.clicks >= 2) {
+        button.clicks = 0;
+        postButtonEvent(id, BUTTON_EVENT_DOUBLE_CLICK);
       }
     }
-  } else {
-    buttonPressStart = 0;
   }
+
+  if (button.pressed) {
+    unsigned long held = now - button.pressedAt;
+    if (!button.holdSent && held >= BUTTON_HOLD_TIME) {
+      button.holdSent = true;
+      button.clicks = 0;  // A hold is never part of a click sequence
+      postButtonEvent(id, BUTTON_EVENT_HOLD);
+    }
+    if (!button.longSent && held >= (unsigned long)LONG_PRESS_DURATION) {
+      button.longSent = true;
+      postButtonEvent(id, BUTTON_EVENT_LONG_PRESS);
+    }
+  } else if (button.clicks == 1 && now - button.releasedAt >= BUTTON_DOUBLE_CLICK_TIME) {
+    button.clicks = 0;
+    postButtonEvent(id, BUTTON_EVENT_CLICK);
+  }
+}
+
+bool buttonGestureOpen() {
+  for (int i = 0; i < BUTTON_COUNT; i++) {
+    if (buttons[i].pressed || buttons[i].clicks > 0) return true;
+  }
+  return false;
 }
 
-void checkSOSButton() {
-  if (digitalRead(SOS_BUTTON) == LOW) {
-    Serial.println("SOS BUTTON CLICK");
-    sos_status = !sos_status;  // Toggle SOS status
-    delay(300);  // Simple debounce
+// Sleeps until an edge arrives; polls only while a press or click is in progress
+void buttonTask(void* parameter) {
+  for (;;) {
+    TickType_t wait = buttonGestureOpen() ? pdMS_TO_TICKS(BUTTON_POLL_INTERVAL) : portMAX_DELAY;
+    if (ulTaskNotifyTake(pdTRUE, wait) > 0) {
+      // Let the contacts settle, edges during the wait are absorbed by the take above
+      vTaskDelay(pdMS_TO_TICKS(BUTTON_DEBOUNCE_TIME));
+      ulTaskNotifyTake(pdTRUE, 0);
+    }
+
+    unsigned long now = millis();
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+      updateButton((ButtonId)i, now);
+    }
   }
 }
 
-#endif
\ No newline at end of file
+void initButtons() {
+  buttonEvents = xQueueCreate(BUTTON_EVENT_QUEUE_SIZE, sizeof(ButtonEvent));
+  buttonLoopTask = xTaskGetCurrentTaskHandle();  // setup() and loop() share a task
+  xTaskCreate(buttonTask, "buttons", BUTTON_TASK_STACK_SIZE, NULL, BUTTON_TASK_PRIORITY, &buttonTaskHandle);
+
+  for (int i = 0; i < BUTTON_COUNT; i++) {
+    pinMode(buttons[i].pin, INPUT_PULLUP);
+    // A button held through boot is not a press
+    buttons[i].pressed = digitalRead(buttons[i].pin) == LOW;
+    buttons[i].holdSent = buttons[i].pressed;
+    buttons[i].longSent = buttons[i].pressed;
+    attachInterruptArg(digitalPinToInterrupt(buttons[i].pin), onButtonEdge, &buttons[i], CHANGE);
+  }
+  Serial.println("Buttons initialized (Config and SOS, interrupt driven)");
+}
+
+// Light sleep swallows the edge that woke us, so have the task take a look
+void notifyButtonsAfterWake() {
+  if (buttonTaskHandle != NULL) {
+    xTaskNotifyGive(buttonTaskHandle);
+  }
+}
+
+bool buttonEventsPending() {
+  return buttonGestureOpen() || (buttonEvents != NULL && uxQueueMessagesWaiting(buttonEvents) > 0);
+}
+
+void requestImmediateReport(uint32_t pressMicros) {
+  // Keep the oldest press so latency covers the whole wait
+  if (!immediateReportPending) {
+    immediateReportMicros = pressMicros;
+  }
+  immediateReportPending = true;
+}
+
+void handleSOSEvent(const ButtonEvent& event) {
+  switch (event.type) {
+    case BUTTON_EVENT_PRESS:
+      sosActivatingPress = !sos_status;
+      if (!sos_status) {
+        Serial.println("SOS ACTIVATED");
+        sos_status = true;
+        requestImmediateReport(event.pressMicros);
+      }
+      break;
+    case BUTTON_EVENT_CLICK:
+    case BUTTON_EVENT_DOUBLE_CLICK:
+      if (sos_status && !sosActivatingPress) {
+        Serial.println("SOS resend requested");
+        requestImmediateReport(event.pressMicros);
+      }
+      break;
+    case BUTTON_EVENT_HOLD:
+      // The hold that raised the alarm must not cancel it
+      if (sos_status && !sosActivatingPress) {
+        Serial.println("SOS CANCELLED");
+        sos_status = false;
+        requestImmediateReport(event.pressMicros);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void handleConfigEvent(const ButtonEvent& event) {
+  switch (event.type) {
+    case BUTTON_EVENT_DOUBLE_CLICK:
+      Serial.println("Position report requested");
+      requestImmediateReport(event.pressMicros);
+      break;
+    case BUTTON_EVENT_LONG_PRESS:
+      // Tracking keeps running while the portal is open
+      if (configMode) {
+        stopConfigPortal();
+      } else {
+        startConfigPortal();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// Drain queued gestures; returns true when a report should go out right away
+bool handleButtons() {
+  ButtonEvent event;
+  while (xQueueReceive(buttonEvents, &event, 0) == pdTRUE) {
+    displayWake();
+    if (event.button == BUTTON_SOS) {
+      handleSOSEvent(event);
+    } else {
+      handleConfigEvent(event);
+    }
+  }
+  return immediateReportPending;
+}
+
+// Called right after an out-of-schedule report has been transmitted
+void recordPressToAir() {
+  if (!immediateReportPending) return;
+  immediateReportPending = false;
+
+  uint32_t latency = (micros() - immediateReportMicros) / 1000;
+  buttonStats.immediateReports++;
+  buttonStats.lastLatencyMs = latency;
+  buttonStats.maxLatencyMs = max(buttonStats.maxLatencyMs, latency);
+  buttonLatencyTotal += latency;
+  Serial.printf("Button: press to air %u ms\n", latency);
+}
+
+ButtonStats getButtonStats() {
+  ButtonStats stats = buttonStats;
+  stats.avgLatencyMs = stats.immediateReports > 0 ? buttonLatencyTotal / stats.immediateReports : 0;
+  return stats;
+}
+
+#endif
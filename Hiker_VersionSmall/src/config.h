@@ -22,10 +22,71 @@
 #define RXD2        20  // GPS TX → ESP32 RX (dedicated RX pin)
 #define TXD2        21  // GPS RX → ESP32 TX (dedicated TX pin)
 #define GPS_BAUD    9600
+#define GPS_UPDATE_INTERVAL   1000  // ms between fixes requested from the receiver
+#define GPS_RX_BUFFER_SIZE    1024  // Holds a full NMEA burst at 9600 baud
+#define GPS_TASK_STACK_SIZE   4096
+#define GPS_TASK_PRIORITY     2     // Above loop() so bursts are drained promptly
+#define GPS_USE_UBX           true  // Prefer UBX-NAV-PVT on u-blox receivers
+#define GPS_UERE_METERS       5.0   // User range error used to turn HDOP into metres
+
+// GPS power management - receiver sleeps between report slots
+#define GPS_POWER_SAVE         true
+#define GPS_WAKE_LEAD_DEFAULT  3000   // ms before a report slot to wake the receiver
+#define GPS_WAKE_LEAD_MIN      1000
+#define GPS_WAKE_LEAD_MAX      30000
+#define GPS_WAKE_LEAD_MARGIN   500    // Added on top of the observed time-to-fix
+#define GPS_MIN_SLEEP_TIME     2000   // Shorter gaps are not worth a sleep/wake cycle
+#define GPS_FIX_TIMEOUT        60000  // No usable fix after waking -> continuous tracking
+#define GPS_FIX_MAX_ACCURACY   25.0   // m, worse fixes do not count as acquired
+#define GPS_RECOVERY_FIXES     10     // Good fixes in a row before duty-cycling starts or resumes
+
+// Current draw used for the battery-life estimate
+#define BATTERY_CAPACITY_MAH   1000.0
+#define SYSTEM_CURRENT_MA      45.0   // ESP32-C3, OLED and LoRa idle, GPS excluded
+#define GPS_ACTIVE_CURRENT_MA  25.0
+#define GPS_SLEEP_CURRENT_MA   0.1
+
+// Track filter - constant-velocity Kalman on the transmitted position
+#define TRACK_ACCEL_NOISE      1.0f   // m/s^2, how hard a hiker can change pace
+#define TRACK_MAX_SPEED        8.0f   // m/s, faster jumps are treated as multipath
+#define TRACK_MIN_ACCURACY     2.0f   // m, floor on the receiver's own estimate
+#define TRACK_MIN_SATELLITES   6      // Fewer satellites doubles the measurement sigma
+#define TRACK_GATE_THRESHOLD   13.8f  // Chi-square, 2 DOF, 99.9%
+#define TRACK_MAX_REJECTS      5      // Consecutive rejections before re-initialising
+#define TRACK_MAX_GAP          60.0f  // s without an accepted fix before re-initialising
+
+// Reporting - defaults for the adaptive report policy (portal-editable)
+#define REPORT_MOVING_INTERVAL      5      // s between reports while moving
+#define REPORT_STATIONARY_INTERVAL  60     // s between reports while stationary
+#define REPORT_SOS_INTERVAL         10     // s between reports after the SOS burst
+#define REPORT_DISPLACEMENT         50     // m moved that triggers an early report
+#define REPORT_LOW_BATTERY_PERCENT  20     // Throttle reporting below this level
+#define REPORT_SOS_BURST            5      // Back-to-back reports when SOS starts
+#define REPORT_SOS_BURST_SPACING    2000   // ms between burst reports
+#define REPORT_MOVING_SPEED         0.5f   // m/s filtered speed that counts as moving
+#define REPORT_STATIONARY_HOLD      120000 // ms without movement before slowing down
+#define REPORT_LOW_BATTERY_FACTOR   3      // Interval multiplier on a low battery
+#define REPORT_MIN_INTERVAL         2000   // ms floor for displacement-triggered reports
+
+// Sleep scheduling between events
+#define POWER_SLEEP_ENABLED    true
+#define POWER_AWAKE_POLL       1000   // ms loop delay while the CPU has to stay up
+#define POWER_LIGHT_SLEEP_MIN  200    // Shorter idle gaps are spent in delay()
+#define POWER_DEEP_SLEEP_MIN   60000  // Idle gaps this long reboot through deep sleep
+#define POWER_MAX_LIGHT_SLEEP  20000  // Stays under the 30 s task watchdog
+#define LIGHT_SLEEP_CURRENT_MA 1.5
+#define DEEP_SLEEP_CURRENT_MA  0.05
 
 // Buttons
 #define CONFIG_BUTTON  0  // Config mode button (GPIO0)
 #define SOS_BUTTON     1  // SOS emergency button
+#define BUTTON_DEBOUNCE_TIME     30    // ms the contacts get to settle after an edge
+#define BUTTON_DOUBLE_CLICK_TIME 400   // ms after a release to wait for a second click
+#define BUTTON_HOLD_TIME         1500  // ms hold that cancels an active SOS
+#define BUTTON_POLL_INTERVAL     20    // ms between samples while a gesture is open
+#define BUTTON_EVENT_QUEUE_SIZE  8
+#define BUTTON_TASK_STACK_SIZE   2048
+#define BUTTON_TASK_PRIORITY     3     // Above the GPS task so presses are never late
 
 // OLED Display - Using GPIO 8 (SDA) and GPIO 9 (SCL) as specified
 #define SCREEN_WIDTH   128
@@ -34,17 +95,28 @@
 #define OLED_ADDRESS   0x3C
 #define I2C_SDA        8
 #define I2C_SCL        9
+#define DISPLAY_CONTRAST      0x40   // 0x00-0xFF, the panel defaults to 0xCF
+#define DISPLAY_BLANK_TIMEOUT 30000  // ms without a button press before the panel turns off
 
 // Battery - ADC pin for battery voltage monitoring
 #define BATTERY_PIN 3
+#define BATTERY_SAMPLE_INTERVAL  2000   // ms between oversampled readings
+#define BATTERY_OVERSAMPLE       32     // ADC reads averaged per reading
+#define BATTERY_SMOOTHING        0.1f   // EMA weight of each new reading
+#define BATTERY_HISTORY_INTERVAL 60000  // ms between drain-rate history entries
+#define BATTERY_HISTORY_SIZE     30     // 30 min window for the drain rate
+#define BATTERY_MIN_DRAIN        0.1f   // %/h, below this the runtime is unknown
+#define BATTERY_TASK_STACK_SIZE  2048
 
 // ============= CONFIGURATION CONSTANTS =============
-const float MAX_BATTERY_VOLTAGE = 4.2;  // fully charged Li-ion
-const float MIN_BATTERY_VOLTAGE = 3.3;  // considered empty
 const float VOLTAGE_DIVIDER_RATIO = 2.0;  // 100k:100k = divide by 2
 
 const int LONG_PRESS_DURATION = 3000;  // 3 seconds for config mode activation
 const String AP_SSID = "CONFIG NODE 01";
+#define CONFIG_PORTAL_IDLE_TIMEOUT     300000  // ms without requests or clients before the AP closes
+#define CONFIG_PORTAL_DNS_INTERVAL     10      // ms between captive DNS polls
+#define CONFIG_PORTAL_STOP_TIMEOUT     500     // ms to wait for the DNS task to exit
+#define CONFIG_PORTAL_TASK_STACK_SIZE  3072
 
 // ============= GPS ICON BITMAP =============
 #define GPS_ICON_WIDTH  16
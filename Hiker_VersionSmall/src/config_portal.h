@@ -4,34 +4,56 @@
 #include <WiFi.h>
 #include <DNSServer.h>
 #include <ESPAsyncWebServer.h>
+#include <LoRa.h>
 #include <Preferences.h>
 #include "config.h"
+#include "report_policy.h"
+
+// ============= CONFIG PORTAL =============
+// The portal runs next to tracking: the web server lives on the AsyncTCP
+// task and captive DNS on a small task of its own, so GPS, LoRa and SOS
+// keep going while it is open. Saved settings are applied live by loop(),
+// and the access point shuts itself down after CONFIG_PORTAL_IDLE_TIMEOUT
+// without requests or connected clients.
+
+// Global variables owned by main.cpp
+extern bool configMode;
 
 // Config portal objects
 AsyncWebServer server(80);
 DNSServer dns;
+volatile bool portalTaskRunning = false;
+volatile bool portalStopRequested = false;
+bool portalRoutesRegistered = false;
+volatile bool portalSettingsChanged = false;
+volatile unsigned long portalLastActivity = 0;
 
-void startConfigPortal() {
-  WiFi.softAP(AP_SSID);
-  dns.start(53, "*", WiFi.softAPIP());
-  
-  // Load current configuration
-  Preferences prefs;
-  prefs.begin("config", false);
-  uint32_t currentSync = prefs.getUInt("sync_word", 0xF3);
-  String currentMode = prefs.getString("mode", "Hiker");
-  uint8_t currentMaxHops = prefs.getUChar("max_hops", 5);
-  String currentDeviceId = prefs.getString("device_id", "H_001");
-  String currentFirebaseUrl = prefs.getString("firebase_url", "");
-  prefs.end();
-  
-  // Convert sync word to hex string
-  char syncBuffer[10];
-  sprintf(syncBuffer, "%02X", currentSync);
-  String sync = String(syncBuffer);
-  
-  // Serve configuration web page
-  server.on("/", HTTP_GET, [sync, currentMode, currentMaxHops, currentDeviceId, currentFirebaseUrl](AsyncWebServerRequest *request) {
+// Function declarations
+void startConfigPortal();
+void stopConfigPortal();
+void updateConfigPortal();
+
+void registerPortalRoutes() {
+  // Serve configuration web page, always showing the settings in effect
+  server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
+    portalLastActivity = millis();
+    
+    // Load current configuration
+    Preferences prefs;
+    prefs.begin("config", true);
+    uint32_t currentSync = prefs.getUInt("sync_word", 0xF3);
+    String currentMode = prefs.getString("mode", "Hiker");
+    uint8_t currentMaxHops = prefs.getUChar("max_hops", 5);
+    String currentDeviceId = prefs.getString("device_id", "H_001");
+    String currentFirebaseUrl = prefs.getString("firebase_url", "");
+    prefs.end();
+    ReportSettings currentReport = reportSettings;
+    
+    // Convert sync word to hex string
+    char syncBuffer[10];
+    sprintf(syncBuffer, "%02X", currentSync);
+    String sync = String(syncBuffer);
+    
     String html = R"rawliteral(
 <!DOCTYPE html>
 <html lang="en">
@@ -276,7 +298,47 @@ void startConfigPortal() {
     html += R"rawliteral(</div>
       </div>
       
-      <button type="submit" class="submit-btn">Save & Restart Device</button>
+      <div class="grid-2">
+        <div class="form-group">
+          <label class="form-label">Moving Interval (s)</label>
+          <input type="number" name="rpt_moving" class="form-input" min="2" max="600" value=")rawliteral";
+    html += String(currentReport.movingInterval);
+    html += R"rawliteral(" required>
+        </div>
+        
+        <div class="form-group">
+          <label class="form-label">Stationary Interval (s)</label>
+          <input type="number" name="rpt_still" class="form-input" min="5" max="3600" value=")rawliteral";
+    html += String(currentReport.stationaryInterval);
+    html += R"rawliteral(" required>
+        </div>
+      </div>
+      
+      <div class="grid-2">
+        <div class="form-group">
+          <label class="form-label">SOS Interval (s)</label>
+          <input type="number" name="rpt_sos" class="form-input" min="2" max="300" value=")rawliteral";
+    html += String(currentReport.sosInterval);
+    html += R"rawliteral(" required>
+        </div>
+        
+        <div class="form-group">
+          <label class="form-label">Report After (m)</label>
+          <input type="number" name="rpt_dist" class="form-input" min="10" max="1000" value=")rawliteral";
+    html += String(currentReport.displacement);
+    html += R"rawliteral(" required>
+        </div>
+      </div>
+      
+      <div class="form-group">
+        <label class="form-label">Low Battery Throttle (%)</label>
+        <input type="number" name="rpt_low_bat" class="form-input" min="0" max="100" value=")rawliteral";
+    html += String(currentReport.lowBatteryPercent);
+    html += R"rawliteral(" required>
+        <div class="device-hint">Reports slow down below this level, except during SOS</div>
+      </div>
+      
+      <button type="submit" class="submit-btn">Save & Apply</button>
     </form>
   </div>
   
@@ -340,6 +402,7 @@ void startConfigPortal() {
   
   // Handle configuration saving
   server.on("/save", HTTP_POST, [](AsyncWebServerRequest *request) {
+    portalLastActivity = millis();
     String sync = request->getParam("sync", true)->value();
     String mode = request->getParam("mode", true)->value();
     String maxHopsStr = request->getParam("max_hops", true)->value();
@@ -359,6 +422,23 @@ void startConfigPortal() {
     prefs.putUChar("max_hops", maxHopsStr.toInt());
     prefs.putString("device_id", deviceId);
     prefs.putString("firebase_url", firebaseUrl);
+    
+    // Report policy, clamped to the same ranges as the form
+    if (request->hasParam("rpt_moving", true)) {
+      prefs.putUShort("rpt_moving", constrain(request->getParam("rpt_moving", true)->value().toInt(), 2, 600));
+    }
+    if (request->hasParam("rpt_still", true)) {
+      prefs.putUShort("rpt_still", constrain(request->getParam("rpt_still", true)->value().toInt(), 5, 3600));
+    }
+    if (request->hasParam("rpt_sos", true)) {
+      prefs.putUShort("rpt_sos", constrain(request->getParam("rpt_sos", true)->value().toInt(), 2, 300));
+    }
+    if (request->hasParam("rpt_dist", true)) {
+      prefs.putUShort("rpt_dist", constrain(request->getParam("rpt_dist", true)->value().toInt(), 10, 1000));
+    }
+    if (request->hasParam("rpt_low_bat", true)) {
+      prefs.putUChar("rpt_low_bat", constrain(request->getParam("rpt_low_bat", true)->value().toInt(), 0, 100));
+    }
     prefs.end();
     
     String responseHtml = R"rawliteral(
@@ -404,11 +484,11 @@ void startConfigPortal() {
   <div class="container">
     <div class="checkmark">✓</div>
     <h2>Configuration Saved!</h2>
-    <p>Device will restart in a few seconds...</p>
+    <p>Settings applied, tracking continues...</p>
   </div>
   <script>
     setTimeout(() => {
-      document.body.innerHTML = '<div style="text-align:center; padding:50px; color:white;"><h2>Restarting Device...</h2></div>';
+      window.location.href = '/';
     }, 2000);
   </script>
 </body>
@@ -416,11 +496,101 @@ void startConfigPortal() {
 )rawliteral";
     
     request->send(200, "text/html", responseHtml);
-    delay(3000);
-    ESP.restart();
+    // Picked up by loop(), which owns the radio and the report policy
+    portalSettingsChanged = true;
   });
   
+  portalRoutesRegistered = true;
+}
+
+// Answers captive-portal DNS lookups; HTTP is served by the AsyncTCP task.
+// Stops itself when asked, so it is never deleted in the middle of a request.
+void portalTask(void* parameter) {
+  while (!portalStopRequested) {
+    dns.processNextRequest();
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_PORTAL_DNS_INTERVAL));
+  }
+  dns.stop();
+  portalTaskRunning = false;
+  vTaskDelete(NULL);
+}
+
+void startConfigPortal() {
+  if (configMode) return;
+  // A DNS task that missed the stop deadline still owns the server
+  if (portalTaskRunning) {
+    Serial.println("Config portal: previous DNS task still stopping, not started");
+    return;
+  }
+  
+  WiFi.mode(WIFI_AP);
+  WiFi.softAP(AP_SSID);
+  dns.start(53, "*", WiFi.softAPIP());
+  
+  if (!portalRoutesRegistered) {
+    registerPortalRoutes();
+  }
   server.begin();
+  
+  portalLastActivity = millis();
+  configMode = true;
+  portalStopRequested = false;
+  portalTaskRunning = true;
+  if (xTaskCreate(portalTask, "portal", CONFIG_PORTAL_TASK_STACK_SIZE, NULL, 1, NULL) != pdPASS) {
+    portalTaskRunning = false;
+    dns.stop();
+    Serial.println("Config portal: DNS task failed to start, no captive redirect");
+  }
+  Serial.println("Config portal started at " + WiFi.softAPIP().toString());
+}
+
+void stopConfigPortal() {
+  if (!configMode) return;
+  
+  // The DNS task finishes its current request and stops the server itself.
+  // If it is stuck, leave it to exit later rather than block loop()
+  portalStopRequested = true;
+  unsigned long deadline = millis() + CONFIG_PORTAL_STOP_TIMEOUT;
+  while (portalTaskRunning && (long)(millis() - deadline) < 0) {
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_PORTAL_DNS_INTERVAL));
+  }
+  if (portalTaskRunning) {
+    Serial.println("Config portal: DNS task did not stop in time, left to exit on its own");
+  }
+  server.end();
+  WiFi.softAPdisconnect(true);
+  WiFi.mode(WIFI_OFF);
+  configMode = false;
+  Serial.println("Config portal stopped");
+}
+
+// Called from loop(): applies saved settings and closes an idle portal
+void updateConfigPortal() {
+  if (portalSettingsChanged) {
+    portalSettingsChanged = false;
+    
+    Preferences prefs;
+    prefs.begin("config", true);
+    uint32_t syncWord = prefs.getUInt("sync_word", 0xF3);
+    prefs.end();
+    
+    // Max hops is read per relay, mode and device ID are only stored
+    LoRa.setSyncWord(syncWord);
+    loadReportSettings();
+    Serial.printf("Config portal: settings applied, sync word 0x%02X\n", syncWord);
+  }
+  
+  if (!configMode) return;
+  
+  // A connected phone counts as activity even if the page is just open
+  if (WiFi.softAPgetStationNum() > 0) {
+    portalLastActivity = millis();
+  }
+  unsigned long lastActivity = portalLastActivity;
+  if (millis() - lastActivity > CONFIG_PORTAL_IDLE_TIMEOUT) {
+    Serial.println("Config portal idle, closing");
+    stopConfigPortal();
+  }
 }
 
 #endif
\ No newline at end of file
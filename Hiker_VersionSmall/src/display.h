@@ -6,9 +6,57 @@
 #include <Adafruit_SSD1306.h>
 #include "config.h"
 
+// Global variables owned by main.cpp
+extern bool configMode;
+
 // Display object
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
+// ============= DISPLAY MANAGER =============
+// Screens are built from fixed text rows. A row is only redrawn when its
+// text changes, and only the 8-pixel pages it touches are sent over I2C.
+// The panel is switched off after DISPLAY_BLANK_TIMEOUT without a button
+// press; the framebuffer keeps updating and is flushed on wake.
+
+enum DisplayScreen {
+  DISPLAY_SCREEN_NONE,       // Something else drew directly, full redraw next time
+  DISPLAY_SCREEN_TRACKING,
+  DISPLAY_SCREEN_SEARCHING
+};
+
+struct DisplayStats {
+  uint32_t refreshes;     // Calls that pushed at least one page
+  uint32_t skipped;       // Calls where nothing on screen changed
+  uint32_t pagesPushed;
+  uint32_t pushMicros;    // Total time spent on I2C transfers
+  float onPercent;        // Share of uptime with the panel lit
+  bool blanked;
+};
+
+#define DISPLAY_ROWS       6
+#define DISPLAY_ROW_CHARS  22   // 128 px / 6 px per character, plus terminator
+#define DISPLAY_PAGES      (SCREEN_HEIGHT / 8)
+#define DISPLAY_I2C_CHUNK  32   // Data bytes per I2C transaction
+
+const uint8_t DISPLAY_ROW_Y[DISPLAY_ROWS] = {0, 12, 24, 36, 47, 56};
+
+bool displayAvailable = false;
+bool displayBlanked = false;
+DisplayScreen displayScreen = DISPLAY_SCREEN_NONE;
+char displayRows[DISPLAY_ROWS][DISPLAY_ROW_CHARS];
+bool displayIconShown = false;
+uint8_t displayDirtyPages = 0;
+unsigned long displayLastActivity = 0;
+unsigned long displayStateSince = 0;
+unsigned long displayOnTime = 0;
+unsigned long displayOffTime = 0;
+DisplayStats displayStats = {};
+
+// Function declarations
+void displayWake();
+void invalidateDisplay();
+DisplayStats getDisplayStats();
+
 void initDisplay() {
   // Use valid ESP32-C3 I2C pins: GPIO 5 (SDA), GPIO 6 (SCL)
   Wire.begin(I2C_SDA, I2C_SCL);
@@ -20,112 +68,238 @@ void initDisplay() {
       yield(); // Yield to watchdog
       if (display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS)) {
         Serial.println("Display initialized on retry");
-        return;
+        displayAvailable = true;
+        break;
       }
     }
-    Serial.println("Display initialization failed after retries, continuing without display");
-    return; // Continue without display rather than halt
+    if (!displayAvailable) {
+      Serial.println("Display initialization failed after retries, continuing without display");
+      return; // Continue without display rather than halt
+    }
+  } else {
+    Serial.println("Display initialized");
+    displayAvailable = true;
   }
-  Serial.println("Display initialized");
+
+  display.ssd1306_command(SSD1306_SETCONTRAST);
+  display.ssd1306_command(DISPLAY_CONTRAST);
+  displayLastActivity = millis();
+  displayStateSince = millis();
 }
 
 void showSplash() {
   // Check if display is available before trying to use it
-  if (!display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS)) {
+  if (!displayAvailable) {
     Serial.println("Display not available for splash screen");
     delay(2500);  // Still delay for consistent timing
     return;
   }
-  
+
   display.clearDisplay();
-  
+
   // Draw large GPS icon at the top center
   display.drawBitmap((SCREEN_WIDTH - GPS_ICON_WIDTH) / 2, 0, gps_icon_bitmap,
                    GPS_ICON_WIDTH, GPS_ICON_HEIGHT, WHITE);
-  
+
   // Display title
   display.setTextSize(1);
   display.setTextColor(WHITE);
   int16_t x1, y1;
   uint16_t w, h;
-  
+
   display.getTextBounds("TRAILBEACON", 0, 0, &x1, &y1, &w, &h);
   display.setCursor((SCREEN_WIDTH - w) / 2, 20);
   display.println("TRAILBEACON");
-  
+
   // Subtitle
   display.setTextSize(1);
   display.getTextBounds("by Hafeez", 0, 0, &x1, &y1, &w, &h);
   display.setCursor((SCREEN_WIDTH - w) / 2, 40);
   display.println("by Hafeez");
-  
+
   display.display();
+  invalidateDisplay();
   delay(2500);  // Show splash for 2.5 seconds
 }
 
-void updateDisplay(float lat, float lng, String timeStr, int batteryPercent, String loraStatus, int packetCount, bool sos_status) {
+// Force a full redraw after code outside this module drew on the panel
+void invalidateDisplay() {
+  displayScreen = DISPLAY_SCREEN_NONE;
+}
+
+void markDisplayDirty(int y, int height) {
+  for (int page = y / 8; page <= (y + height - 1) / 8 && page < DISPLAY_PAGES; page++) {
+    displayDirtyPages |= 1 << page;
+  }
+}
+
+// Start drawing `screen`; switching screens clears everything
+void beginDisplayScreen(DisplayScreen screen) {
+  if (displayScreen == screen) return;
+
+  displayScreen = screen;
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(WHITE);
-  
+  memset(displayRows, 0, sizeof(displayRows));
+  displayIconShown = false;
+  markDisplayDirty(0, SCREEN_HEIGHT);
+}
+
+void setDisplayRow(int row, const char* text) {
+  if (strncmp(displayRows[row], text, DISPLAY_ROW_CHARS - 1) == 0) return;
+
+  strncpy(displayRows[row], text, DISPLAY_ROW_CHARS - 1);
+  displayRows[row][DISPLAY_ROW_CHARS - 1] = '\0';
+
+  // Rows beside the GPS icon stop short of it
+  int y = DISPLAY_ROW_Y[row];
+  int width = y < GPS_ICON_HEIGHT ? SCREEN_WIDTH - GPS_ICON_WIDTH : SCREEN_WIDTH;
+  display.fillRect(0, y, width, 8, BLACK);
+  display.setCursor(0, y);
+  display.print(displayRows[row]);
+  markDisplayDirty(y, 8);
+}
+
+void setDisplayIcon(bool shown) {
+  if (displayIconShown == shown) return;
+
+  displayIconShown = shown;
+  int x = SCREEN_WIDTH - GPS_ICON_WIDTH;
+  display.fillRect(x, 0, GPS_ICON_WIDTH, GPS_ICON_HEIGHT, BLACK);
+  if (shown) {
+    display.drawBitmap(x, 0, gps_icon_bitmap, GPS_ICON_WIDTH, GPS_ICON_HEIGHT, WHITE);
+  }
+  markDisplayDirty(0, GPS_ICON_HEIGHT);
+}
+
+// Account on/off time and switch the panel
+void setDisplayBlanked(bool blanked) {
+  if (displayBlanked == blanked) return;
+
+  unsigned long now = millis();
+  if (displayBlanked) {
+    displayOffTime += now - displayStateSince;
+  } else {
+    displayOnTime += now - displayStateSince;
+  }
+  displayStateSince = now;
+  displayBlanked = blanked;
+  display.ssd1306_command(blanked ? SSD1306_DISPLAYOFF : SSD1306_DISPLAYON);
+}
+
+// Called on button presses; restarts the blanking timer
+void displayWake() {
+  displayLastActivity = millis();
+  if (displayAvailable) {
+    setDisplayBlanked(false);
+  }
+}
+
+// Send the dirty pages straight from the framebuffer (horizontal addressing)
+void pushDisplayPages() {
+  if (!displayBlanked && millis() - displayLastActivity > DISPLAY_BLANK_TIMEOUT) {
+    setDisplayBlanked(true);
+  }
+  // Nothing is lost while blanked, the pages stay dirty until the next wake
+  if (displayBlanked) return;
+  if (displayDirtyPages == 0) {
+    displayStats.skipped++;
+    return;
+  }
+
+  unsigned long start = micros();
+  uint8_t* buffer = display.getBuffer();
+  for (int page = 0; page < DISPLAY_PAGES; page++) {
+    if (!(displayDirtyPages & (1 << page))) continue;
+
+    display.ssd1306_command(SSD1306_PAGEADDR);
+    display.ssd1306_command(page);
+    display.ssd1306_command(page);
+    display.ssd1306_command(SSD1306_COLUMNADDR);
+    display.ssd1306_command(0);
+    display.ssd1306_command(SCREEN_WIDTH - 1);
+
+    const uint8_t* data = buffer + page * SCREEN_WIDTH;
+    for (int column = 0; column < SCREEN_WIDTH; column += DISPLAY_I2C_CHUNK) {
+      Wire.beginTransmission(OLED_ADDRESS);
+      Wire.write((uint8_t)0x40);  // Co = 0, D/C = 1: data follows
+      Wire.write(data + column, DISPLAY_I2C_CHUNK);
+      Wire.endTransmission();
+    }
+    displayStats.pagesPushed++;
+  }
+  displayStats.pushMicros += micros() - start;
+  displayStats.refreshes++;
+  displayDirtyPages = 0;
+}
+
+void updateDisplay(float lat, float lng, String timeStr, int batteryPercent, String loraStatus, int packetCount, bool sos_status) {
+  if (!displayAvailable) return;
+  beginDisplayScreen(DISPLAY_SCREEN_TRACKING);
+
+  char row[DISPLAY_ROW_CHARS + 16];
+
   // Show GPS coordinates
-  display.setCursor(0, 0);
-  display.print("Lat: ");
-  display.println(lat, 8);
-  
-  display.setCursor(0, 12);
-  display.print("Lng: ");
-  display.println(lng, 8);
-  
+  snprintf(row, sizeof(row), "Lat: %.8f", lat);
+  setDisplayRow(0, row);
+  snprintf(row, sizeof(row), "Lng: %.8f", lng);
+  setDisplayRow(1, row);
+
   // Show UTC time from GPS
-  display.setCursor(0, 24);
-  display.print("Time(Local): ");
-  display.println(timeStr);
-  
+  snprintf(row, sizeof(row), "Time(Local): %s", timeStr.c_str());
+  setDisplayRow(2, row);
+
   // Show LoRa status
-  display.setCursor(0, 36);
-  display.print("LoRa: " + loraStatus + "(" + packetCount + ")");
-
-  display.setCursor(0, 47);
-  display.print("Battery:");
-  display.print(batteryPercent);
-  display.println("%");
-  
-  // Show SOS status
-  if (sos_status) {
-    display.setCursor(0, 56);
-    display.println("SOS ACTIVATED");
-  }
-  
+  snprintf(row, sizeof(row), "LoRa: %s(%d)", loraStatus.c_str(), packetCount);
+  setDisplayRow(3, row);
+
+  snprintf(row, sizeof(row), "Battery:%d%%", batteryPercent);
+  setDisplayRow(4, row);
+
+  // Show SOS status, or where to find the config portal while it is open
+  setDisplayRow(5, sos_status ? "SOS ACTIVATED" : configMode ? "Config: 192.168.4.1" : "");
+
   // Draw GPS icon
-  display.drawBitmap(SCREEN_WIDTH - GPS_ICON_WIDTH, 0, gps_icon_bitmap,
-                   GPS_ICON_WIDTH, GPS_ICON_HEIGHT, WHITE);
-  
-  display.display();
+  setDisplayIcon(true);
+
+  pushDisplayPages();
 }
 
 void showGPSSearching(String loraStatus, unsigned long lastSendTime) {
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(WHITE);
-  
-  display.setCursor(0, 0);
-  display.println("Waiting for GPS...");
-  display.setCursor(0, 12);
-  display.println("Move to open area");
-  
-  display.setCursor(0, 24);
-  display.print("LoRa: ");
-  display.println(loraStatus);
-  
+  if (!displayAvailable) return;
+  beginDisplayScreen(DISPLAY_SCREEN_SEARCHING);
+
+  char row[DISPLAY_ROW_CHARS + 16];
+
+  setDisplayRow(0, "Waiting for GPS...");
+  setDisplayRow(1, "Move to open area");
+
+  snprintf(row, sizeof(row), "LoRa: %s", loraStatus.c_str());
+  setDisplayRow(2, row);
+
+  setDisplayRow(3, configMode ? "Config: 192.168.4.1" : "");
+
   // Blink GPS icon
-  if (millis() - lastSendTime >= 1000) {
-    display.drawBitmap(SCREEN_WIDTH - GPS_ICON_WIDTH, 0,
-                     gps_icon_bitmap, GPS_ICON_WIDTH, GPS_ICON_HEIGHT, WHITE);
+  setDisplayIcon(millis() - lastSendTime >= 1000);
+
+  pushDisplayPages();
+}
+
+DisplayStats getDisplayStats() {
+  unsigned long onTime = displayOnTime;
+  unsigned long offTime = displayOffTime;
+  if (displayBlanked) {
+    offTime += millis() - displayStateSince;
+  } else {
+    onTime += millis() - displayStateSince;
   }
-  
-  display.display();
+
+  DisplayStats stats = displayStats;
+  stats.onPercent = (onTime + offTime) > 0 ? 100.0 * onTime / (onTime + offTime) : 100.0;
+  stats.blanked = displayBlanked;
+  return stats;
 }
 
 #endif // DISPLAY_H
-// End of DISPLAY_H
\ No newline at end of file
+// End of DISPLAY_H
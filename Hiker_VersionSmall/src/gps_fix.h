@@ -0,0 +1,29 @@
+#ifndef GPS_FIX_H
+#define GPS_FIX_H
+
+#include <stdint.h>
+
+// ============= GPS FIX =============
+// Kept apart from gps_module.h so the track filter and its host tests
+// need neither the UART nor the GPS task.
+
+// Latest fix as decoded by the GPS task
+struct GPSFix {
+  bool locationValid;
+  double latitude;
+  double longitude;
+  bool altitudeValid;
+  double altitude;
+  double speedKmph;
+  double hdop;
+  float hAccuracy;        // Estimated horizontal accuracy in metres
+  uint32_t satellites;
+  bool timeValid;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  unsigned long fixTime;  // millis() when the location was last updated
+  bool fromUBX;           // Decoded from UBX-NAV-PVT rather than NMEA
+};
+
+#endif // GPS_FIX_H
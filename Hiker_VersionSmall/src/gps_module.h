@@ -3,6 +3,8 @@
 
 #include <TinyGPS++.h>
 #include "config.h"
+#include <ubx_parser.h>
+#include "gps_fix.h"
 
 // GPS Data structure
 struct GPSData {
@@ -11,32 +13,262 @@ struct GPSData {
   String timeStr;
 };
 
+// GPS ingestion counters
+struct GPSStats {
+  unsigned long fixAge;      // ms since the last location update
+  uint32_t passedChecksum;
+  uint32_t failedChecksum;
+  uint32_t sentencesWithFix;
+  uint32_t droppedBursts;    // UART RX buffer/FIFO overflows
+  const char* protocol;      // "UBX" or "NMEA", whichever produced the last fix
+  uint32_t ubxFrames;
+  uint32_t ubxChecksumFailures;
+  uint32_t parseMicrosPerFix;
+};
+
 // GPS objects (definition)
-HardwareSerial gpsSerial(0);  // 
+HardwareSerial gpsSerial(0);  //
 TinyGPSPlus gps;
+UBXParser ubx;
+
+// GPS task state - the task owns `gps`, everyone else reads the snapshot
+TaskHandle_t gpsTaskHandle = NULL;
+SemaphoreHandle_t gpsMutex = NULL;
+GPSFix gpsShared = {};     // Written by the GPS task under gpsMutex
+GPSFix gpsCurrent = {};    // Loop-side copy refreshed by updateGPS()
+volatile uint32_t gpsDroppedBursts = 0;
+volatile uint32_t gpsParseMicros = 0;  // CPU time spent decoding, for the per-fix cost
+volatile uint32_t gpsFixCount = 0;
 
 // Function declarations
 void initGPS();
 void updateGPS();
 bool isGPSValid();
 GPSData getGPSData();
+GPSFix getGPSFix();
+GPSStats getGPSStats();
+void updateGPSPower(unsigned long nextReportTime);
+bool isGPSReadyForReport();
+void onGPSReportSent(unsigned long nextReportTime);
+void resumeGPSAfterDeepSleep();
+
+// Send an NMEA command, appending the checksum
+void sendGPSNMEACommand(const char* body) {
+  uint8_t checksum = 0;
+  for (const char* p = body; *p; p++) {
+    checksum ^= (uint8_t)*p;
+  }
+  gpsSerial.printf("$%s*%02X\r\n", body, checksum);
+}
+
+// Send a UBX frame, appending the Fletcher checksum
+void sendGPSUBXCommand(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, uint16_t length) {
+  uint8_t header[6] = {0xB5, 0x62, msgClass, msgId, (uint8_t)(length & 0xFF), (uint8_t)(length >> 8)};
+  uint8_t ckA = 0, ckB = 0;
+  for (int i = 2; i < 6; i++) {
+    ckA += header[i];
+    ckB += ckA;
+  }
+  for (uint16_t i = 0; i < length; i++) {
+    ckA += payload[i];
+    ckB += ckA;
+  }
+  gpsSerial.write(header, sizeof(header));
+  gpsSerial.write(payload, length);
+  gpsSerial.write(ckA);
+  gpsSerial.write(ckB);
+}
+
+// Restrict the receiver to the messages we decode at GPS_UPDATE_INTERVAL.
+// u-blox receivers get UBX-NAV-PVT only (or RMC/GGA with GPS_USE_UBX off);
+// other chipsets ignore the UBX frames and get RMC/GGA through PMTK.
+void configureGPSSentences() {
+  // u-blox: CFG-MSG rate per NMEA sentence, everything off when UBX is used
+  const uint8_t nmeaRate = GPS_USE_UBX ? 0 : 1;
+  const uint8_t nmeaRates[][2] = {
+    {0x00, nmeaRate},  // GGA
+    {0x01, 0},         // GLL
+    {0x02, 0},         // GSA
+    {0x03, 0},         // GSV
+    {0x04, nmeaRate},  // RMC
+    {0x05, 0},         // VTG
+  };
+  for (const auto& rate : nmeaRates) {
+    uint8_t payload[3] = {0xF0, rate[0], rate[1]};
+    sendGPSUBXCommand(0x06, 0x01, payload, sizeof(payload));
+    delay(20);
+  }
+
+  // u-blox: CFG-MSG NAV-PVT once per navigation solution
+  uint8_t pvtPayload[3] = {UBX_CLASS_NAV, UBX_ID_NAV_PVT, (uint8_t)(GPS_USE_UBX ? 1 : 0)};
+  sendGPSUBXCommand(0x06, 0x01, pvtPayload, sizeof(pvtPayload));
+  delay(20);
+
+  // u-blox: CFG-RATE measurement period, 1 navigation cycle, GPS time
+  uint16_t period = GPS_UPDATE_INTERVAL;
+  uint8_t ratePayload[6] = {(uint8_t)(period & 0xFF), (uint8_t)(period >> 8), 0x01, 0x00, 0x01, 0x00};
+  sendGPSUBXCommand(0x06, 0x08, ratePayload, sizeof(ratePayload));
+  delay(20);
+
+  // MediaTek: only RMC and GGA, then the fix interval
+  sendGPSNMEACommand("PMTK314,0,1,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0");
+  char fixCommand[24];
+  snprintf(fixCommand, sizeof(fixCommand), "PMTK220,%d", GPS_UPDATE_INTERVAL);
+  sendGPSNMEACommand(fixCommand);
+
+  Serial.println(GPS_USE_UBX ? "GPS: Requested UBX-NAV-PVT (RMC/GGA fallback)"
+                             : "GPS: Sentence output limited to RMC/GGA");
+}
+
+void storeGPSFix(const GPSFix& fix) {
+  xSemaphoreTake(gpsMutex, portMAX_DELAY);
+  gpsShared = fix;
+  xSemaphoreGive(gpsMutex);
+}
+
+// Publish a fix from the last NAV-PVT. Runs in the GPS task.
+void publishUBXFix() {
+  const UBXNavPVT& pvt = ubx.pvt;
+  GPSFix fix;
+  fix.locationValid = pvt.gnssFixOK && pvt.fixType >= 2;
+  fix.latitude = pvt.latitude;
+  fix.longitude = pvt.longitude;
+  fix.altitudeValid = pvt.gnssFixOK && pvt.fixType >= 3;
+  fix.altitude = pvt.altitudeMSL;
+  fix.speedKmph = pvt.groundSpeed * 3.6;
+  fix.hdop = pvt.pDOP;  // NAV-PVT only carries position DOP
+  fix.hAccuracy = pvt.hAccuracy;
+  fix.satellites = pvt.numSV;
+  fix.timeValid = pvt.timeValid;
+  fix.hour = pvt.hour;
+  fix.minute = pvt.minute;
+  fix.second = pvt.second;
+  fix.fixTime = millis();
+  fix.fromUBX = true;
+
+  // Keep the last valid position when the receiver momentarily loses the fix
+  if (!fix.locationValid && gpsShared.locationValid) {
+    return;
+  }
+  storeGPSFix(fix);
+}
+
+// Copy the TinyGPS++ state into the shared snapshot. Runs in the GPS task.
+void publishGPSFix() {
+  GPSFix fix;
+  fix.locationValid = gps.location.isValid();
+  fix.latitude = gps.location.lat();
+  fix.longitude = gps.location.lng();
+  fix.altitudeValid = gps.altitude.isValid();
+  fix.altitude = gps.altitude.meters();
+  fix.speedKmph = gps.speed.kmph();
+  fix.hdop = gps.hdop.isValid() ? gps.hdop.hdop() : 99.99;
+  fix.hAccuracy = fix.hdop * GPS_UERE_METERS;
+  fix.satellites = gps.satellites.isValid() ? gps.satellites.value() : 0;
+  fix.timeValid = gps.time.isValid();
+  fix.hour = gps.time.hour();
+  fix.minute = gps.time.minute();
+  fix.second = gps.time.second();
+  fix.fixTime = millis() - gps.location.age();
+  fix.fromUBX = false;
+
+  storeGPSFix(fix);
+}
+
+// Woken by the UART driver whenever bytes arrive, sleeps otherwise
+void gpsTask(void* parameter) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    bool nmeaUpdated = false;
+    bool ubxUpdated = false;
+    uint32_t start = micros();
+    while (gpsSerial.available()) {
+      uint8_t c = gpsSerial.read();
+      bool wasInFrame = ubxInFrame(ubx);
+      if (ubxEncode(ubx, c)) {
+        ubxUpdated = true;
+      } else if (!wasInFrame && !ubxInFrame(ubx)) {
+        // Not part of a UBX frame, hand it to the NMEA fallback
+        if (gps.encode(c) && gps.location.isUpdated()) {
+          nmeaUpdated = true;
+        }
+      }
+    }
+    gpsParseMicros += micros() - start;
+
+    if (ubxUpdated) {
+      publishUBXFix();
+      gpsFixCount++;
+    } else if (nmeaUpdated) {
+      publishGPSFix();
+      gpsFixCount++;
+    }
+  }
+}
+
+void onGPSReceive() {
+  if (gpsTaskHandle != NULL) {
+    xTaskNotifyGive(gpsTaskHandle);
+  }
+}
+
+void onGPSReceiveError(hardwareSerial_error_t error) {
+  if (error == UART_BUFFER_FULL_ERROR || error == UART_FIFO_OVF_ERROR) {
+    gpsDroppedBursts++;
+  }
+}
 
 // Function implementations
 void initGPS() {
   Serial.printf("GPS: Initializing on pins RX=%d, TX=%d\n", RXD2, TXD2);
+  // A full NMEA burst must fit without the task having run yet
+  gpsSerial.setRxBufferSize(GPS_RX_BUFFER_SIZE);
   gpsSerial.begin(GPS_BAUD, SERIAL_8N1, RXD2, TXD2,false);
   delay(100); // Give GPS module time to start
   Serial.println("GPS: Serial port initialized");
+
+  configureGPSSentences();
+
+  ubxInit(ubx);
+  gpsMutex = xSemaphoreCreateMutex();
+  xTaskCreate(gpsTask, "gps", GPS_TASK_STACK_SIZE, NULL, GPS_TASK_PRIORITY, &gpsTaskHandle);
+
+  // Callback fires on every RX timeout (end of a sentence burst)
+  gpsSerial.onReceive(onGPSReceive, true);
+  gpsSerial.onReceiveError(onGPSReceiveError);
+  Serial.println("GPS: Ingestion task started");
 }
 
+// Refresh the loop's copy of the latest fix; parsing happens in gpsTask
 void updateGPS() {
-  while (gpsSerial.available()) {
-    gps.encode(gpsSerial.read());
-  }
+  if (gpsMutex == NULL) return;
+
+  xSemaphoreTake(gpsMutex, portMAX_DELAY);
+  gpsCurrent = gpsShared;
+  xSemaphoreGive(gpsMutex);
 }
 
 bool isGPSValid() {
-  return gps.location.isValid();
+  return gpsCurrent.locationValid;
+}
+
+GPSFix getGPSFix() {
+  return gpsCurrent;
+}
+
+GPSStats getGPSStats() {
+  GPSStats stats;
+  stats.fixAge = gpsCurrent.locationValid ? millis() - gpsCurrent.fixTime : ULONG_MAX;
+  stats.passedChecksum = gps.passedChecksum();
+  stats.failedChecksum = gps.failedChecksum();
+  stats.sentencesWithFix = gps.sentencesWithFix();
+  stats.droppedBursts = gpsDroppedBursts;
+  stats.protocol = gpsCurrent.fromUBX ? "UBX" : "NMEA";
+  stats.ubxFrames = ubx.framesDecoded;
+  stats.ubxChecksumFailures = ubx.checksumFailures;
+  stats.parseMicrosPerFix = gpsFixCount > 0 ? gpsParseMicros / gpsFixCount : 0;
+  return stats;
 }
 
 GPSData getGPSData() {
@@ -44,17 +276,208 @@ GPSData getGPSData() {
   data.latitude = 0;
   data.longitude = 0;
   data.timeStr = "N/A";
-  if (gps.location.isValid()) {
-    data.latitude = gps.location.lat();
-    data.longitude = gps.location.lng();
+  if (gpsCurrent.locationValid) {
+    data.latitude = gpsCurrent.latitude;
+    data.longitude = gpsCurrent.longitude;
     // Prepare time string (add 8 hours for local time)
-    if (gps.time.isValid()) {
-      char buffer[10];
-      sprintf(buffer, "%02d:%02d:%02d", (gps.time.hour() + 8) % 24, gps.time.minute(), gps.time.second());
+    if (gpsCurrent.timeValid) {
+      char buffer[9];
+      formatGPSTime(buffer, (gpsCurrent.hour + 8) % 24, gpsCurrent.minute, gpsCurrent.second);
       data.timeStr = String(buffer);
     }
   }
   return data;
 }
 
+// ============= GPS POWER MANAGEMENT =============
+// The receiver is put to sleep after each report and woken GPS_WAKE_LEAD
+// before the next slot, so the fix is a hot start. The lead follows the
+// observed time-to-fix; repeated timeouts fall back to continuous tracking.
+
+enum GPSPowerMode {
+  GPS_POWER_CONTINUOUS,  // Always on, duty-cycling disabled or fixes degraded
+  GPS_POWER_ACQUIRING,   // Awake and waiting for a fresh fix for the next slot
+  GPS_POWER_READY,       // Fresh fix in hand, waiting for the report to go out
+  GPS_POWER_SLEEPING     // Receiver in backup/standby until the wake time
+};
+
+struct GPSPowerStats {
+  const char* mode;
+  unsigned long wakeLead;      // Current lead time in ms
+  unsigned long avgTimeToFix;  // Smoothed time-to-fix after a wake, ms
+  uint32_t wakeCycles;
+  uint32_t fixTimeouts;
+  float dutyCycle;             // Fraction of time the receiver was powered
+  float estimatedHours;        // Battery life at the measured duty cycle
+  float continuousHours;       // Battery life with the receiver always on
+};
+
+GPSPowerMode gpsPowerMode = GPS_POWER_CONTINUOUS;
+unsigned long gpsWakeTime = 0;         // When the receiver was last woken
+unsigned long gpsPowerModeSince = 0;   // Start of the current on/off period
+unsigned long gpsOnTime = 0;           // Accumulated powered time, ms
+unsigned long gpsOffTime = 0;          // Accumulated sleep time, ms
+unsigned long gpsLastSeenFix = 0;      // fixTime of the last fix counted for recovery
+uint32_t gpsWakeCycles = 0;
+uint32_t gpsFixTimeouts = 0;
+
+// What the receiver has shown so far survives deep sleep; the initial
+// values only apply after a cold start
+RTC_DATA_ATTR unsigned long gpsWakeLead = GPS_WAKE_LEAD_DEFAULT;
+RTC_DATA_ATTR unsigned long gpsAvgTimeToFix = 0;
+RTC_DATA_ATTR uint8_t gpsRecoveryFixes = 0;
+// Starts degraded: until GPS_RECOVERY_FIXES good fixes in a row there is no
+// time-to-fix to size the wake lead by, and a cold receiver put to sleep
+// before its first fix would have to start from scratch after every wake
+RTC_DATA_ATTR bool gpsDegraded = true;
+
+const char* gpsPowerModeName(GPSPowerMode mode) {
+  switch (mode) {
+    case GPS_POWER_ACQUIRING: return "acquiring";
+    case GPS_POWER_READY:     return "ready";
+    case GPS_POWER_SLEEPING:  return "sleeping";
+    default:                  return "continuous";
+  }
+}
+
+// Close the running on/off period and switch mode
+void setGPSPowerMode(GPSPowerMode mode) {
+  unsigned long now = millis();
+  if (gpsPowerMode == GPS_POWER_SLEEPING) {
+    gpsOffTime += now - gpsPowerModeSince;
+  } else {
+    gpsOnTime += now - gpsPowerModeSince;
+  }
+  gpsPowerMode = mode;
+  gpsPowerModeSince = now;
+}
+
+// u-blox: RXM-PMREQ backup for `duration` ms. MediaTek: PMTK161 standby.
+void sleepGPSReceiver(unsigned long duration) {
+  uint8_t payload[8] = {
+    (uint8_t)(duration & 0xFF), (uint8_t)(duration >> 8),
+    (uint8_t)(duration >> 16), (uint8_t)(duration >> 24),
+    0x02, 0x00, 0x00, 0x00  // flags: backup
+  };
+  sendGPSUBXCommand(0x02, 0x41, payload, sizeof(payload));
+  sendGPSNMEACommand("PMTK161,0");
+  setGPSPowerMode(GPS_POWER_SLEEPING);
+}
+
+// Any UART activity wakes both receiver families
+void wakeGPSReceiver() {
+  for (int i = 0; i < 8; i++) {
+    gpsSerial.write(0xFF);
+  }
+  gpsWakeTime = millis();
+  gpsWakeCycles++;
+  setGPSPowerMode(GPS_POWER_ACQUIRING);
+}
+
+bool isGoodGPSFix(const GPSFix& fix) {
+  return fix.locationValid && fix.hAccuracy <= GPS_FIX_MAX_ACCURACY;
+}
+
+// Move the lead towards the observed time-to-fix (1/4 weight per sample)
+void recordGPSTimeToFix(unsigned long timeToFix) {
+  gpsAvgTimeToFix = gpsAvgTimeToFix == 0 ? timeToFix
+                                         : (gpsAvgTimeToFix * 3 + timeToFix) / 4;
+  gpsWakeLead = constrain(gpsAvgTimeToFix + GPS_WAKE_LEAD_MARGIN,
+                          (unsigned long)GPS_WAKE_LEAD_MIN, (unsigned long)GPS_WAKE_LEAD_MAX);
+}
+
+// Called from loop() after updateGPS() with the time the next report is due
+void updateGPSPower(unsigned long nextReportTime) {
+  if (!GPS_POWER_SAVE) return;
+
+  unsigned long now = millis();
+  switch (gpsPowerMode) {
+    case GPS_POWER_SLEEPING:
+      if ((long)(nextReportTime - now) <= (long)gpsWakeLead) {
+        wakeGPSReceiver();
+      }
+      break;
+
+    case GPS_POWER_ACQUIRING:
+      if (isGoodGPSFix(gpsCurrent) && (long)(gpsCurrent.fixTime - gpsWakeTime) >= 0) {
+        recordGPSTimeToFix(gpsCurrent.fixTime - gpsWakeTime);
+        setGPSPowerMode(GPS_POWER_READY);
+      } else if (now - gpsWakeTime > GPS_FIX_TIMEOUT) {
+        // Lost the sky or the backup state was lost - track continuously until it recovers
+        gpsFixTimeouts++;
+        gpsDegraded = true;
+        gpsRecoveryFixes = 0;
+        gpsWakeLead = GPS_WAKE_LEAD_MAX;
+        setGPSPowerMode(GPS_POWER_CONTINUOUS);
+        Serial.println("GPS: No fix after wake, falling back to continuous tracking");
+      }
+      break;
+
+    case GPS_POWER_CONTINUOUS:
+      if (!gpsDegraded) break;
+      if (gpsCurrent.fixTime != gpsLastSeenFix) {
+        gpsLastSeenFix = gpsCurrent.fixTime;
+        gpsRecoveryFixes = isGoodGPSFix(gpsCurrent) ? gpsRecoveryFixes + 1 : 0;
+        if (gpsRecoveryFixes >= GPS_RECOVERY_FIXES) {
+          gpsDegraded = false;
+          Serial.println("GPS: Fixes steady, duty-cycling the receiver");
+        }
+      }
+      break;
+
+    case GPS_POWER_READY:
+      break;
+  }
+}
+
+// After a deep sleep wake the receiver is still in backup, so treat the
+// wake like any other and wait for a fresh fix
+void resumeGPSAfterDeepSleep() {
+  if (!GPS_POWER_SAVE || gpsDegraded) return;
+  wakeGPSReceiver();
+}
+
+// Reports wait for a fresh fix while the receiver is waking up
+bool isGPSReadyForReport() {
+  return gpsPowerMode == GPS_POWER_CONTINUOUS || gpsPowerMode == GPS_POWER_READY;
+}
+
+// Called after a report went out; sleeps the receiver if the gap allows it
+void onGPSReportSent(unsigned long nextReportTime) {
+  if (!GPS_POWER_SAVE || gpsDegraded) return;
+  if (gpsPowerMode == GPS_POWER_SLEEPING || gpsPowerMode == GPS_POWER_ACQUIRING) return;
+
+  long sleepTime = (long)(nextReportTime - millis()) - (long)gpsWakeLead;
+  if (sleepTime >= GPS_MIN_SLEEP_TIME) {
+    sleepGPSReceiver(sleepTime);
+  } else if (gpsPowerMode == GPS_POWER_READY) {
+    setGPSPowerMode(GPS_POWER_CONTINUOUS);
+  }
+}
+
+GPSPowerStats getGPSPowerStats() {
+  unsigned long now = millis();
+  unsigned long onTime = gpsOnTime;
+  unsigned long offTime = gpsOffTime;
+  if (gpsPowerMode == GPS_POWER_SLEEPING) {
+    offTime += now - gpsPowerModeSince;
+  } else {
+    onTime += now - gpsPowerModeSince;
+  }
+
+  GPSPowerStats stats;
+  stats.mode = gpsPowerModeName(gpsPowerMode);
+  stats.wakeLead = gpsWakeLead;
+  stats.avgTimeToFix = gpsAvgTimeToFix;
+  stats.wakeCycles = gpsWakeCycles;
+  stats.fixTimeouts = gpsFixTimeouts;
+  stats.dutyCycle = (onTime + offTime) > 0 ? (float)onTime / (onTime + offTime) : 1.0;
+
+  float dutyCurrent = SYSTEM_CURRENT_MA + GPS_ACTIVE_CURRENT_MA * stats.dutyCycle +
+                      GPS_SLEEP_CURRENT_MA * (1.0 - stats.dutyCycle);
+  stats.estimatedHours = BATTERY_CAPACITY_MAH / dutyCurrent;
+  stats.continuousHours = BATTERY_CAPACITY_MAH / (SYSTEM_CURRENT_MA + GPS_ACTIVE_CURRENT_MA);
+  return stats;
+}
+
 #endif // GPS_MODULE_H
\ No newline at end of file
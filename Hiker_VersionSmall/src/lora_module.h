@@ -9,6 +9,7 @@
 
 // Forward declaration
 extern Adafruit_SSD1306 display;
+void invalidateDisplay();
 
 // Global variables for LoRa status
 extern String loraStatus;
@@ -50,6 +51,7 @@ void initLoRa() {
       display.setCursor(0, 10);
       display.println("Continuing...");
       display.display();
+      invalidateDisplay();
       delay(2000);
       return; // Continue without LoRa rather than halt
     }
@@ -93,6 +95,12 @@ void relayLoRaPacket(String receivedPacket) {
     return;
   }
   
+  // Relay route beacons and routed frames describe the link they were
+  // heard on; repeating them would advertise routes that do not exist
+  if (doc["rb"].is<const char*>() || doc["to"].is<const char*>()) {
+    return;
+  }
+  
   // Get max hops from preferences
   Preferences prefs;
   prefs.begin("config", false);
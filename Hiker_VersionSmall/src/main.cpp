@@ -11,10 +11,13 @@
 #include "config.h"
 #include "display.h"
 #include "gps_module.h"
+#include "track_filter.h"
+#include "report_policy.h"
 #include "lora_module.h"
 #include "battery.h"
 #include "config_portal.h"
 #include "buttons.h"
+#include "power_manager.h"
 #include <esp_task_wdt.h> // For watchdog timer
 
 // ============= GLOBAL VARIABLES =============
@@ -25,9 +28,39 @@ bool sos_status = false;
 String NODE_ID = "NODE_01";
 
 // Button state variables
-unsigned long buttonPressStart = 0;
 bool configMode = false;
 
+// Build the report packet; without a fix the position fields are left out
+String buildReportPacket(bool withPosition, const GPSData& gpsData, const TrackPosition& track, int batteryPercent) {
+  JsonDocument doc;
+  doc["node_id"] = NODE_ID;
+  if (withPosition) {
+    doc["latitude"] = gpsData.latitude;
+    doc["longitude"] = gpsData.longitude;
+    if (track.valid) {
+      doc["accuracy"] = roundf(track.accuracy * 10) / 10;  // metres, 1 sigma
+    }
+    doc["time"] = gpsData.timeStr;
+  }
+  doc["battery"] = batteryPercent;
+  doc["sos_status"] = sos_status;
+  
+  String output;
+  serializeJson(doc, output);
+  return output;
+}
+
+void transmitReport(const String& output, const TrackPosition& track) {
+  sendLoRaPacket(output);
+  loraStatus = "Sent!";
+  packetCount++;
+  lastSendTime = millis();
+  onReportSent(track);
+  onGPSReportSent(getNextReportTime());
+  recordPressToAir();
+  Serial.println(output);
+}
+
 // =================== SETUP ===================
 void setup() {
   Serial.begin(115200);
@@ -39,6 +72,8 @@ void setup() {
   esp_task_wdt_add(NULL);
   Serial.println("Watchdog timer initialized");
   
+  initPowerManager();
+  
   // Initialize all modules with error handling
   Serial.println("Initializing buttons...");
   initButtons();
@@ -52,40 +87,88 @@ void setup() {
   initDisplay();
   esp_task_wdt_reset(); // Reset watchdog
   
-  Serial.println("Showing splash screen...");
-  showSplash();
-  esp_task_wdt_reset(); // Reset watchdog
+  if (!wokeFromDeepSleep()) {
+    Serial.println("Showing splash screen...");
+    showSplash();
+    esp_task_wdt_reset(); // Reset watchdog
+  }
   
   Serial.println("Initializing GPS...");
   initGPS();
+  if (wokeFromDeepSleep()) {
+    resumeGPSAfterDeepSleep();
+  }
   esp_task_wdt_reset(); // Reset watchdog
   
   Serial.println("Initializing LoRa...");
   initLoRa();
   esp_task_wdt_reset(); // Reset watchdog
   
+  initReportPolicy(wokeFromDeepSleep());
+  
+  // Woken for a report slot, send as soon as the fix is back
+  if (wokeFromDeepSleep()) {
+    lastSendTime = millis() - reportInterval;
+  }
+  
   Serial.println("=== TrailBeacon initialized successfully ===");
 }
 
 // =================== MAIN LOOP ===================
 void loop() {
-  // Check for config mode activation
-  checkConfigButton();
+  // Button gestures arrive from the button task; SOS asks for a report right away
+  bool immediateReport = handleButtons();
+  updateConfigPortal();
   yield(); // Yield to watchdog
   
-  // Read battery status
+  // Read battery status (sampled in the background by the battery task)
   float voltage = readBatteryVoltage();
   int batteryPercent = getBatteryPercentage(voltage);
   yield(); // Yield to watchdog
 
-  // Check SOS button status
-  checkSOSButton();
-  yield(); // Yield to watchdog
-  
   // Read GPS data
   updateGPS();
+  updateTrackFilter(getGPSFix());
+  updateReportPolicy(getTrackPosition(), batteryPercent, sos_status);
+  updateGPSPower(getNextReportTime());
   yield(); // Yield to watchdog
   
+  // Report GPS ingestion health periodically
+  static unsigned long lastGPSStatsReport = 0;
+  if (millis() - lastGPSStatsReport > 60000) {
+    GPSStats stats = getGPSStats();
+    Serial.printf("GPS: fix age %lu ms, passed %u, checksum failures %u, dropped bursts %u\n",
+                  stats.fixAge, stats.passedChecksum, stats.failedChecksum, stats.droppedBursts);
+    Serial.printf("GPS: protocol %s, UBX frames %u (bad %u), %u us CPU per fix\n",
+                  stats.protocol, stats.ubxFrames, stats.ubxChecksumFailures, stats.parseMicrosPerFix);
+    GPSPowerStats power = getGPSPowerStats();
+    Serial.printf("GPS power: %s, lead %lu ms, TTFF %lu ms, wakes %u, timeouts %u\n",
+                  power.mode, power.wakeLead, power.avgTimeToFix, power.wakeCycles, power.fixTimeouts);
+    Serial.printf("GPS power: on %.1f%%, est. %.1f h battery (%.1f h always on)\n",
+                  power.dutyCycle * 100, power.estimatedHours, power.continuousHours);
+    PowerStats sleep = getPowerStats();
+    Serial.printf("Power: awake %.1f%%, light %.1f%%, deep %.1f%%, %u/%u sleeps, wakes btn %u radio %u\n",
+                  sleep.awakePercent, sleep.lightSleepPercent, sleep.deepSleepPercent,
+                  sleep.lightSleeps, sleep.deepSleeps, sleep.buttonWakes, sleep.radioWakes);
+    Serial.printf("Power: avg %.2f mA excl. GPS, est. %.1f h\n", sleep.averageCurrent, sleep.estimatedHours);
+    DisplayStats screen = getDisplayStats();
+    Serial.printf("Display: %u refreshes, %u skipped, %u pages, %u us on I2C, lit %.1f%%\n",
+                  screen.refreshes, screen.skipped, screen.pagesPushed, screen.pushMicros, screen.onPercent);
+    BatteryStatus battery = getBatteryStatus();
+    Serial.printf("Battery: %.3f V, %.1f%%, drain %.2f %%/h, runtime %.1f h\n",
+                  battery.voltage, battery.percent, battery.drainPerHour, battery.runtimeHours);
+    Serial.printf("Reporting: %s, every %lu ms%s\n", getReportModeName(), reportInterval,
+                  reportLowBattery ? " (low battery)" : "");
+    TrackFilterStats track = getTrackFilterStats();
+    Serial.printf("Track filter: accepted %u, rejected %u, resets %u\n",
+                  track.accepted, track.rejected, track.resets);
+    ButtonStats button = getButtonStats();
+    Serial.printf("Buttons: %u presses, %u dropped, press to air last %u ms, avg %u ms, max %u ms (%u reports)\n",
+                  button.presses, button.droppedEvents, button.lastLatencyMs, button.avgLatencyMs,
+                  button.maxLatencyMs, button.immediateReports);
+    lastGPSStatsReport = millis();
+  }
+  
   // Check for incoming LoRa packets
   receiveLoRaPackets();
   yield(); // Yield to watchdog
@@ -93,39 +176,40 @@ void loop() {
   // Process GPS data if valid
   if (isGPSValid()) {
     GPSData gpsData = getGPSData();
+    TrackPosition track = getTrackPosition();
+    if (track.valid) {
+      // Transmit the filtered position rather than the raw fix
+      gpsData.latitude = track.latitude;
+      gpsData.longitude = track.longitude;
+    }
     
-    // Create JSON data packet - Using new JsonDocument
-    JsonDocument doc;
-    doc["node_id"] = NODE_ID;
-    doc["latitude"] = gpsData.latitude;
-    doc["longitude"] = gpsData.longitude;
-    doc["time"] = gpsData.timeStr;
-    doc["battery"] = batteryPercent;
-    doc["sos_status"] = sos_status;
-    
-    String output;
-    serializeJson(doc, output);
+    // Create JSON data packet
+    String output = buildReportPacket(true, gpsData, track, batteryPercent);
     yield(); // Yield to watchdog
     
     // Update display with current GPS data
     updateDisplay(gpsData.latitude, gpsData.longitude, gpsData.timeStr, batteryPercent, loraStatus, packetCount, sos_status);
     yield(); // Yield to watchdog
     
-    // Send data automatically every 5 seconds
-    if (millis() - lastSendTime > 5000) {
-      sendLoRaPacket(output);
-      loraStatus = "Sent!";
-      packetCount++;
-      lastSendTime = millis();
-      Serial.println(output);
+    // Send when the report policy says so, once the GPS has a fresh fix.
+    // Button reports go out now with the best position we have.
+    if (immediateReport || (isReportDue() && isGPSReadyForReport())) {
+      transmitReport(output, track);
       yield(); // Yield to watchdog
     }
   } else {
+    // An SOS does not wait for a fix, the basecamp still sees who raised it
+    if (immediateReport) {
+      TrackPosition noPosition = {};
+      transmitReport(buildReportPacket(false, GPSData(), noPosition, batteryPercent), noPosition);
+    }
+    
     // Show searching for GPS screen
     showGPSSearching(loraStatus, lastSendTime);
     yield(); // Yield to watchdog
   }
   
-  delay(1000);
+  // Sleep until the next scheduled event, or poll if something needs the CPU
+  powerSleepUntilNextEvent();
   esp_task_wdt_reset(); // Reset watchdog at end of loop
 }
\ No newline at end of file
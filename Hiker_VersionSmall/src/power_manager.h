@@ -0,0 +1,215 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <esp_sleep.h>
+#include <esp_task_wdt.h>
+#include <driver/gpio.h>
+#include <sys/time.h>
+#include <LoRa.h>
+#include "config.h"
+#include "gps_module.h"
+#include "report_policy.h"
+#include "buttons.h"
+
+// ============= POWER SCHEDULER =============
+// Between events the hiker light-sleeps, or deep-sleeps when the next event
+// is far away. The next event is the GPS wake ahead of the report slot;
+// buttons and LoRa DIO0 wake the CPU early. Nothing sleeps while the GPS
+// receiver is powered, because UART bytes are lost while the CPU is down.
+
+// Global variables owned by main.cpp
+extern int packetCount;
+extern bool configMode;
+extern bool sos_status;
+
+// Survives deep sleep; cleared on every other kind of reset
+struct PowerRTCState {
+  uint32_t magic;
+  uint32_t bootCount;
+  uint32_t lightSleeps;
+  uint32_t deepSleeps;
+  uint32_t buttonWakes;
+  uint32_t radioWakes;
+  uint64_t awakeMs;
+  uint64_t lightSleepMs;
+  uint64_t deepSleepMs;
+  int64_t deepSleepEnteredUs;  // Wall-clock time when deep sleep started
+  int packetCount;
+  bool sosStatus;
+};
+
+struct PowerStats {
+  uint32_t bootCount;
+  uint32_t lightSleeps;
+  uint32_t deepSleeps;
+  uint32_t buttonWakes;
+  uint32_t radioWakes;
+  float awakePercent;
+  float lightSleepPercent;
+  float deepSleepPercent;
+  float averageCurrent;    // mA, weighted by time in each state
+  float estimatedHours;    // Battery life at that average
+};
+
+#define POWER_RTC_MAGIC 0x54424357  // "TBCW"
+
+RTC_DATA_ATTR PowerRTCState powerRTC;
+unsigned long powerAwakeSince = 0;
+bool powerDeepSleepWake = false;
+
+// Function declarations
+void initPowerManager();
+bool wokeFromDeepSleep();
+void powerSleepUntilNextEvent();
+PowerStats getPowerStats();
+
+int64_t powerWallClockUs() {
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (int64_t)now.tv_sec * 1000000LL + now.tv_usec;
+}
+
+void initPowerManager() {
+  powerDeepSleepWake = esp_reset_reason() == ESP_RST_DEEPSLEEP && powerRTC.magic == POWER_RTC_MAGIC;
+
+  if (powerDeepSleepWake) {
+    powerRTC.deepSleepMs += (powerWallClockUs() - powerRTC.deepSleepEnteredUs) / 1000;
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+      powerRTC.buttonWakes++;
+    }
+    packetCount = powerRTC.packetCount;
+    sos_status = powerRTC.sosStatus;
+  } else {
+    memset(&powerRTC, 0, sizeof(powerRTC));
+    powerRTC.magic = POWER_RTC_MAGIC;
+  }
+  powerRTC.bootCount++;
+  powerAwakeSince = millis();
+
+  // LoRa DIO0 goes high on RxDone; the buttons are armed per sleep, see
+  // powerArmButtonWake()
+  pinMode(LORA_DIO0, INPUT);
+  gpio_wakeup_enable((gpio_num_t)LORA_DIO0, GPIO_INTR_HIGH_LEVEL);
+
+  Serial.printf("Power: boot %u (%s)\n", powerRTC.bootCount,
+                powerDeepSleepWake ? "deep sleep wake" : "cold start");
+}
+
+bool wokeFromDeepSleep() {
+  return powerDeepSleepWake;
+}
+
+// Time until the next scheduled event, or 0 if the CPU has to stay up
+unsigned long powerTimeToNextEvent() {
+  if (!POWER_SLEEP_ENABLED || configMode) return 0;
+  // A gesture is still being timed, or its event has not been handled yet
+  if (buttonEventsPending()) return 0;
+  // Receiver is powered and streaming, or a fix is waiting for its slot
+  if (gpsPowerMode != GPS_POWER_SLEEPING) return 0;
+
+  unsigned long nextReport = getNextReportTime();
+  long untilWake = (long)(nextReport - millis()) - (long)gpsWakeLead;
+  return untilWake > 0 ? untilWake : 0;
+}
+
+// Light sleep only wakes on level triggers, but the button ISRs need both
+// edges (attachInterrupt CHANGE). Switch to low-level wake just for the
+// sleep, with the interrupt masked so a held button cannot storm the ISR.
+void powerArmButtonWake(bool armed) {
+  const gpio_num_t pins[] = {(gpio_num_t)CONFIG_BUTTON, (gpio_num_t)SOS_BUTTON};
+  for (gpio_num_t pin : pins) {
+    if (armed) {
+      gpio_intr_disable(pin);
+      gpio_wakeup_enable(pin, GPIO_INTR_LOW_LEVEL);
+    } else {
+      gpio_wakeup_disable(pin);
+      gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+      gpio_intr_enable(pin);
+    }
+  }
+}
+
+void powerLightSleep(unsigned long duration) {
+  unsigned long start = millis();
+  powerRTC.awakeMs += start - powerAwakeSince;
+
+  // Continuous RX maps DIO0 to RxDone so an incoming packet wakes us
+  LoRa.receive();
+  Serial.flush();
+  esp_task_wdt_reset();
+
+  esp_sleep_enable_timer_wakeup((uint64_t)duration * 1000ULL);
+  esp_sleep_enable_gpio_wakeup();
+  powerArmButtonWake(true);
+  esp_light_sleep_start();
+  powerArmButtonWake(false);
+
+  // millis() is compensated for the time spent asleep
+  powerAwakeSince = millis();
+  powerRTC.lightSleepMs += powerAwakeSince - start;
+  powerRTC.lightSleeps++;
+  esp_task_wdt_reset();
+
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+    if (digitalRead(LORA_DIO0) == HIGH) {
+      powerRTC.radioWakes++;
+    } else {
+      powerRTC.buttonWakes++;
+      notifyButtonsAfterWake();
+    }
+  }
+}
+
+// Does not return - the next boot restores state from powerRTC
+void powerDeepSleep(unsigned long duration) {
+  powerRTC.awakeMs += millis() - powerAwakeSince;
+  powerRTC.deepSleeps++;
+  powerRTC.packetCount = packetCount;
+  powerRTC.sosStatus = sos_status;
+  powerRTC.deepSleepEnteredUs = powerWallClockUs();
+
+  Serial.printf("Power: deep sleep for %lu ms\n", duration);
+  Serial.flush();
+
+  LoRa.sleep();
+  esp_sleep_enable_timer_wakeup((uint64_t)duration * 1000ULL);
+  esp_deep_sleep_enable_gpio_wakeup(BIT(CONFIG_BUTTON) | BIT(SOS_BUTTON), ESP_GPIO_WAKEUP_GPIO_LOW);
+  esp_deep_sleep_start();
+}
+
+// Replaces the fixed delay at the end of loop()
+void powerSleepUntilNextEvent() {
+  unsigned long idle = powerTimeToNextEvent();
+
+  if (idle >= POWER_DEEP_SLEEP_MIN) {
+    powerDeepSleep(idle);
+  } else if (idle >= POWER_LIGHT_SLEEP_MIN) {
+    // Bounded so the watchdog is fed even if no event arrives
+    powerLightSleep(min(idle, (unsigned long)POWER_MAX_LIGHT_SLEEP));
+  } else {
+    // Same as delay(), but a button gesture ends the wait early
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POWER_AWAKE_POLL));
+  }
+}
+
+PowerStats getPowerStats() {
+  uint64_t awake = powerRTC.awakeMs + (millis() - powerAwakeSince);
+  uint64_t total = awake + powerRTC.lightSleepMs + powerRTC.deepSleepMs;
+
+  PowerStats stats;
+  stats.bootCount = powerRTC.bootCount;
+  stats.lightSleeps = powerRTC.lightSleeps;
+  stats.deepSleeps = powerRTC.deepSleeps;
+  stats.buttonWakes = powerRTC.buttonWakes;
+  stats.radioWakes = powerRTC.radioWakes;
+  stats.awakePercent = total > 0 ? 100.0 * awake / total : 100.0;
+  stats.lightSleepPercent = total > 0 ? 100.0 * powerRTC.lightSleepMs / total : 0;
+  stats.deepSleepPercent = total > 0 ? 100.0 * powerRTC.deepSleepMs / total : 0;
+  stats.averageCurrent = (SYSTEM_CURRENT_MA * stats.awakePercent +
+                          LIGHT_SLEEP_CURRENT_MA * stats.lightSleepPercent +
+                          DEEP_SLEEP_CURRENT_MA * stats.deepSleepPercent) / 100.0;
+  stats.estimatedHours = BATTERY_CAPACITY_MAH / stats.averageCurrent;
+  return stats;
+}
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,155 @@
+#ifndef REPORT_POLICY_H
+#define REPORT_POLICY_H
+
+#include <Preferences.h>
+#include <TinyGPS++.h>
+#include "config.h"
+#include "track_filter.h"
+
+// ============= REPORT POLICY =============
+// Picks the time between position reports from the hiker's state:
+// slow when stationary, fast when moving, bursts while SOS is active and
+// throttled on a low battery. Moving far enough since the last report
+// triggers one early so the track keeps its shape on fast descents.
+
+// Global variables owned by main.cpp
+extern unsigned long lastSendTime;
+
+// Settings, editable through the config portal
+struct ReportSettings {
+  uint16_t movingInterval;      // s
+  uint16_t stationaryInterval;  // s
+  uint16_t sosInterval;         // s
+  uint16_t displacement;        // m moved that triggers an early report
+  uint8_t lowBatteryPercent;    // Throttle below this level
+};
+
+enum ReportMode {
+  REPORT_MOVING,
+  REPORT_STATIONARY,
+  REPORT_SOS
+};
+
+ReportSettings reportSettings = {
+  REPORT_MOVING_INTERVAL, REPORT_STATIONARY_INTERVAL, REPORT_SOS_INTERVAL,
+  REPORT_DISPLACEMENT, REPORT_LOW_BATTERY_PERCENT
+};
+ReportMode reportMode = REPORT_MOVING;
+unsigned long reportInterval = REPORT_MOVING_INTERVAL * 1000UL;
+unsigned long lastMovementTime = 0;   // Last time speed or displacement said "moving"
+double lastReportLat = 0;
+double lastReportLng = 0;
+bool haveLastReport = false;
+bool displacementDue = false;
+bool reportLowBattery = false;
+uint8_t sosBurstRemaining = 0;
+bool lastSOSState = false;
+
+// Function declarations
+void initReportPolicy(bool resumeStationary);
+void updateReportPolicy(const TrackPosition& track, int batteryPercent, bool sos);
+bool isReportDue();
+unsigned long getNextReportTime();
+void onReportSent(const TrackPosition& track);
+
+void loadReportSettings() {
+  Preferences prefs;
+  prefs.begin("config", true);
+  reportSettings.movingInterval = prefs.getUShort("rpt_moving", REPORT_MOVING_INTERVAL);
+  reportSettings.stationaryInterval = prefs.getUShort("rpt_still", REPORT_STATIONARY_INTERVAL);
+  reportSettings.sosInterval = prefs.getUShort("rpt_sos", REPORT_SOS_INTERVAL);
+  reportSettings.displacement = prefs.getUShort("rpt_dist", REPORT_DISPLACEMENT);
+  reportSettings.lowBatteryPercent = prefs.getUChar("rpt_low_bat", REPORT_LOW_BATTERY_PERCENT);
+  prefs.end();
+}
+
+// After a deep-sleep wake the hiker was stationary, so do not start fast
+void initReportPolicy(bool resumeStationary) {
+  loadReportSettings();
+  lastMovementTime = resumeStationary ? millis() - REPORT_STATIONARY_HOLD - 1 : millis();
+  Serial.printf("Report policy: moving %us, stationary %us, SOS %us, %um, low battery <%u%%\n",
+                reportSettings.movingInterval, reportSettings.stationaryInterval,
+                reportSettings.sosInterval, reportSettings.displacement,
+                reportSettings.lowBatteryPercent);
+}
+
+const char* getReportModeName() {
+  switch (reportMode) {
+    case REPORT_STATIONARY: return "stationary";
+    case REPORT_SOS:        return "sos";
+    default:                return "moving";
+  }
+}
+
+// Called every loop with the filtered position and current battery level
+void updateReportPolicy(const TrackPosition& track, int batteryPercent, bool sos) {
+  unsigned long now = millis();
+
+  // A fresh SOS starts a burst of back-to-back reports
+  if (sos && !lastSOSState) {
+    sosBurstRemaining = REPORT_SOS_BURST;
+  }
+  lastSOSState = sos;
+
+  displacementDue = false;
+  if (track.valid) {
+    if (track.speed >= REPORT_MOVING_SPEED) {
+      lastMovementTime = now;
+    }
+    if (haveLastReport) {
+      double moved = TinyGPSPlus::distanceBetween(lastReportLat, lastReportLng,
+                                                  track.latitude, track.longitude);
+      // Only count displacement clearly larger than the position error
+      if (moved >= reportSettings.displacement && moved > 2 * track.accuracy) {
+        displacementDue = true;
+        lastMovementTime = now;
+      }
+    }
+  }
+
+  unsigned long interval;
+  if (sos) {
+    reportMode = REPORT_SOS;
+    interval = sosBurstRemaining > 0 ? REPORT_SOS_BURST_SPACING : reportSettings.sosInterval * 1000UL;
+  } else if (now - lastMovementTime > REPORT_STATIONARY_HOLD) {
+    reportMode = REPORT_STATIONARY;
+    interval = reportSettings.stationaryInterval * 1000UL;
+  } else {
+    reportMode = REPORT_MOVING;
+    interval = reportSettings.movingInterval * 1000UL;
+  }
+
+  // SOS keeps its rate no matter what is left in the battery
+  reportLowBattery = batteryPercent < reportSettings.lowBatteryPercent;
+  if (reportLowBattery && !sos) {
+    interval *= REPORT_LOW_BATTERY_FACTOR;
+  }
+  reportInterval = interval;
+}
+
+bool isReportDue() {
+  unsigned long elapsed = millis() - lastSendTime;
+  if (displacementDue && reportMode != REPORT_SOS && elapsed >= REPORT_MIN_INTERVAL) {
+    return true;
+  }
+  return elapsed >= reportInterval;
+}
+
+unsigned long getNextReportTime() {
+  return lastSendTime + reportInterval;
+}
+
+// Called after a report went out; lastSendTime is already updated
+void onReportSent(const TrackPosition& track) {
+  if (track.valid) {
+    lastReportLat = track.latitude;
+    lastReportLng = track.longitude;
+    haveLastReport = true;
+  }
+  displacementDue = false;
+  if (sosBurstRemaining > 0) {
+    sosBurstRemaining--;
+  }
+}
+
+#endif // REPORT_POLICY_H
@@ -0,0 +1,204 @@
+#ifndef TRACK_FILTER_H
+#define TRACK_FILTER_H
+
+#include "config.h"
+#include "gps_fix.h"
+
+// ============= TRACK FILTER =============
+// Constant-velocity Kalman filter on a local east/north plane in metres.
+// The axes are filtered independently (2x2 covariance each), so every
+// update is a fixed handful of float operations and no allocation.
+// Measurements are weighted by the receiver's accuracy estimate and
+// rejected when they imply an impossible speed or fall outside the gate.
+
+// Filtered position handed to the packet builder
+struct TrackPosition {
+  bool valid;
+  double latitude;
+  double longitude;
+  float accuracy;   // 1-sigma horizontal error in metres
+  float speed;      // m/s
+};
+
+struct TrackFilterStats {
+  uint32_t accepted;
+  uint32_t rejected;
+  uint32_t resets;
+};
+
+// One axis of the constant-velocity model
+struct TrackAxis {
+  float position;   // m from the origin
+  float velocity;   // m/s
+  float pPP;        // Covariance: position/position
+  float pPV;        // position/velocity
+  float pVV;        // velocity/velocity
+};
+
+struct TrackFilter {
+  bool initialized;
+  double originLat;
+  double originLng;
+  double metresPerDegLng;
+  TrackAxis east;
+  TrackAxis north;
+  unsigned long lastFixTime;  // fixTime of the last measurement seen
+  unsigned long lastUpdate;   // fixTime of the last accepted measurement
+  uint8_t consecutiveRejects;
+  TrackFilterStats stats;
+};
+
+TrackFilter trackFilter = {};
+
+const double METRES_PER_DEG_LAT = 111320.0;
+
+// Function declarations
+void resetTrackFilter(const GPSFix& fix);
+bool updateTrackFilter(const GPSFix& fix);
+TrackPosition getTrackPosition();
+TrackFilterStats getTrackFilterStats();
+
+// Measurement variance from the receiver's accuracy, inflated on thin geometry
+float trackMeasurementVariance(const GPSFix& fix) {
+  float sigma = max(fix.hAccuracy, TRACK_MIN_ACCURACY);
+  if (fix.satellites > 0 && fix.satellites < TRACK_MIN_SATELLITES) {
+    sigma *= 2.0;
+  }
+  return sigma * sigma;
+}
+
+void trackAxisReset(TrackAxis& axis, float position, float variance) {
+  axis.position = position;
+  axis.velocity = 0;
+  axis.pPP = variance;
+  axis.pPV = 0;
+  axis.pVV = TRACK_MAX_SPEED * TRACK_MAX_SPEED;
+}
+
+// Propagate one axis by dt seconds with white-acceleration process noise
+void trackAxisPredict(TrackAxis& axis, float dt) {
+  const float q = TRACK_ACCEL_NOISE * TRACK_ACCEL_NOISE;
+  const float dt2 = dt * dt;
+
+  axis.position += axis.velocity * dt;
+  axis.pPP += dt * (2 * axis.pPV + dt * axis.pVV) + q * dt2 * dt2 / 4;
+  axis.pPV += dt * axis.pVV + q * dt2 * dt / 2;
+  axis.pVV += q * dt2;
+}
+
+// Normalised innovation squared, used for gating before committing the update
+float trackAxisInnovation(const TrackAxis& axis, float measurement, float variance) {
+  float residual = measurement - axis.position;
+  return residual * residual / (axis.pPP + variance);
+}
+
+void trackAxisCorrect(TrackAxis& axis, float measurement, float variance) {
+  float residual = measurement - axis.position;
+  float s = axis.pPP + variance;
+  float kP = axis.pPP / s;
+  float kV = axis.pPV / s;
+
+  axis.position += kP * residual;
+  axis.velocity += kV * residual;
+  axis.pVV -= kV * axis.pPV;
+  axis.pPV -= kV * axis.pPP;
+  axis.pPP -= kP * axis.pPP;
+}
+
+void resetTrackFilter(const GPSFix& fix) {
+  trackFilter.initialized = true;
+  trackFilter.originLat = fix.latitude;
+  trackFilter.originLng = fix.longitude;
+  trackFilter.metresPerDegLng = METRES_PER_DEG_LAT * cos(fix.latitude * DEG_TO_RAD);
+
+  float variance = trackMeasurementVariance(fix);
+  trackAxisReset(trackFilter.east, 0, variance);
+  trackAxisReset(trackFilter.north, 0, variance);
+  trackFilter.lastUpdate = fix.fixTime;
+  trackFilter.consecutiveRejects = 0;
+  trackFilter.stats.resets++;
+}
+
+// Feed the latest fix; returns false when it was a repeat or got rejected
+bool updateTrackFilter(const GPSFix& fix) {
+  if (!fix.locationValid || fix.fixTime == trackFilter.lastFixTime) {
+    return false;
+  }
+  trackFilter.lastFixTime = fix.fixTime;
+
+  if (!trackFilter.initialized) {
+    resetTrackFilter(fix);
+    trackFilter.stats.accepted++;
+    return true;
+  }
+
+  float dt = (fix.fixTime - trackFilter.lastUpdate) / 1000.0;
+  if (dt <= 0) {
+    return false;
+  }
+  // After a long gap the old velocity means nothing, start over
+  if (dt > TRACK_MAX_GAP) {
+    resetTrackFilter(fix);
+    trackFilter.stats.accepted++;
+    return true;
+  }
+
+  float measuredEast = (fix.longitude - trackFilter.originLng) * trackFilter.metresPerDegLng;
+  float measuredNorth = (fix.latitude - trackFilter.originLat) * METRES_PER_DEG_LAT;
+  float variance = trackMeasurementVariance(fix);
+
+  TrackAxis east = trackFilter.east;
+  TrackAxis north = trackFilter.north;
+  trackAxisPredict(east, dt);
+  trackAxisPredict(north, dt);
+
+  // Reject jumps that are physically impossible for a hiker...
+  float jumpEast = measuredEast - trackFilter.east.position;
+  float jumpNorth = measuredNorth - trackFilter.north.position;
+  float allowed = TRACK_MAX_SPEED * dt + 2 * sqrt(variance);
+  bool tooFast = jumpEast * jumpEast + jumpNorth * jumpNorth > allowed * allowed;
+
+  // ...or statistically inconsistent with the prediction
+  float nis = trackAxisInnovation(east, measuredEast, variance) +
+              trackAxisInnovation(north, measuredNorth, variance);
+  bool outsideGate = nis > TRACK_GATE_THRESHOLD;
+
+  if (tooFast || outsideGate) {
+    trackFilter.stats.rejected++;
+    // A run of rejections means the filter lost track, not that every fix is bad
+    if (++trackFilter.consecutiveRejects >= TRACK_MAX_REJECTS) {
+      resetTrackFilter(fix);
+    }
+    return false;
+  }
+
+  trackAxisCorrect(east, measuredEast, variance);
+  trackAxisCorrect(north, measuredNorth, variance);
+  trackFilter.east = east;
+  trackFilter.north = north;
+  trackFilter.lastUpdate = fix.fixTime;
+  trackFilter.consecutiveRejects = 0;
+  trackFilter.stats.accepted++;
+  return true;
+}
+
+TrackPosition getTrackPosition() {
+  TrackPosition position = {};
+  position.valid = trackFilter.initialized;
+  if (!position.valid) {
+    return position;
+  }
+
+  position.latitude = trackFilter.originLat + trackFilter.north.position / METRES_PER_DEG_LAT;
+  position.longitude = trackFilter.originLng + trackFilter.east.position / trackFilter.metresPerDegLng;
+  position.accuracy = sqrt((trackFilter.east.pPP + trackFilter.north.pPP) / 2);
+  position.speed = sqrt(trackFilter.east.velocity * trackFilter.east.velocity +
+                        trackFilter.north.velocity * trackFilter.north.velocity);
+  return position;
+}
+
+TrackFilterStats getTrackFilterStats() {
+  return trackFilter.stats;
+}
+
+#endif // TRACK_FILTER_H
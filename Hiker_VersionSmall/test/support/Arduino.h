@@ -0,0 +1,54 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// ============= HOST STAND-IN =============
+// Just enough of the Arduino core for the [env:native] tests to build
+// TinyGPS++ and the pure headers from src/ on the host.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define sq(x) ((x) * (x))
+
+#define PROGMEM
+
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+// config.h only keeps String constants; nothing on the host formats them
+class String : public std::string {
+public:
+  String(const char* text = "") : std::string(text) {}
+};
+
+inline unsigned long millis() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000UL + now.tv_nsec / 1000000UL;
+}
+
+inline unsigned long micros() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000UL + now.tv_nsec / 1000UL;
+}
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,2 @@
+// TinyGPS++ asks for the pre-1.0 Arduino header when ARDUINO is not defined
+#include "Arduino.h"
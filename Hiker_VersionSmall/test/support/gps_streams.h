@@ -0,0 +1,74 @@
+#ifndef GPS_STREAMS_H
+#define GPS_STREAMS_H
+
+#include <stdint.h>
+
+// ============= GPS BYTE STREAMS =============
+// Two seconds of a hiker walking east at 1 Hz. These are not captures from
+// a receiver: the frames were generated from the field values below,
+// following the u-blox M8 protocol description and NMEA 0183, with the UBX
+// and NMEA checksums computed to match. UBX_PVT_FIX_n and NMEA_FIX_n
+// describe the same fix, so the two decoders can be checked against each
+// other. The NAV-SAT payload is a filler byte pattern, not satellite data.
+
+// NAV-PVT, 2026-06-14 08:30:15 UTC, 3D fix, 9 SV, 45.9237000 N 6.8652000 E,
+// 1035.2 m MSL, hAcc 3.2 m, vAcc 4.8 m, 1.25 m/s at 87.5 deg, pDOP 1.45
+static const uint8_t UBX_PVT_FIX_1[] = {
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x28, 0x38, 0x93, 0x1B, 0xEA, 0x07, 0x06, 0x0E, 0x08, 0x1E,
+  0x0F, 0x07, 0xA8, 0x61, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x09, 0xE0, 0x8B,
+  0x17, 0x04, 0x88, 0x66, 0x5F, 0x1B, 0xA4, 0x87, 0x10, 0x00, 0xC0, 0xCB, 0x0F, 0x00, 0x80, 0x0C,
+  0x00, 0x00, 0xC0, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0xE2, 0x04, 0x00, 0x00, 0xB0, 0x83, 0x85, 0x00, 0x90, 0x01, 0x00, 0x00, 0xF0, 0x49,
+  0x02, 0x00, 0x91, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0xCF, 0x34,
+};
+
+// NAV-PVT one second later: 45.9237112 N 6.8652160 E, 1035.3 m, hAcc 3.1 m,
+// 1.30 m/s at 87.6 deg
+static const uint8_t UBX_PVT_FIX_2[] = {
+  0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x10, 0x3C, 0x93, 0x1B, 0xEA, 0x07, 0x06, 0x0E, 0x08, 0x1E,
+  0x10, 0x07, 0xA8, 0x61, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0xEA, 0x09, 0x80, 0x8C,
+  0x17, 0x04, 0xF8, 0x66, 0x5F, 0x1B, 0x08, 0x88, 0x10, 0x00, 0x24, 0xCC, 0x0F, 0x00, 0x1C, 0x0C,
+  0x00, 0x00, 0x5C, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x14, 0x05, 0x00, 0x00, 0xC0, 0xAA, 0x85, 0x00, 0x90, 0x01, 0x00, 0x00, 0xF0, 0x49,
+  0x02, 0x00, 0x91, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x39, 0x03,
+};
+
+// ACK-ACK for CFG-MSG, as sent after configureGPS()
+static const uint8_t UBX_ACK_ACK[] = {
+  0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x01, 0x0F, 0x38,
+};
+
+// NAV-SAT with 16 satellites: 200 bytes, larger than the parser buffer
+static const uint8_t UBX_NAV_SAT[] = {
+  0xB5, 0x62, 0x01, 0x35, 0xC8, 0x00, 0x00, 0x07, 0x0E, 0x15, 0x1C, 0x23, 0x2A, 0x31, 0x38, 0x3F,
+  0x46, 0x4D, 0x54, 0x5B, 0x62, 0x69, 0x70, 0x77, 0x7E, 0x85, 0x8C, 0x93, 0x9A, 0xA1, 0xA8, 0xAF,
+  0xB6, 0xBD, 0xC4, 0xCB, 0xD2, 0xD9, 0xE0, 0xE7, 0xEE, 0xF5, 0xFC, 0x03, 0x0A, 0x11, 0x18, 0x1F,
+  0x26, 0x2D, 0x34, 0x3B, 0x42, 0x49, 0x50, 0x57, 0x5E, 0x65, 0x6C, 0x73, 0x7A, 0x81, 0x88, 0x8F,
+  0x96, 0x9D, 0xA4, 0xAB, 0xB2, 0xB9, 0xC0, 0xC7, 0xCE, 0xD5, 0xDC, 0xE3, 0xEA, 0xF1, 0xF8, 0xFF,
+  0x06, 0x0D, 0x14, 0x1B, 0x22, 0x29, 0x30, 0x37, 0x3E, 0x45, 0x4C, 0x53, 0x5A, 0x61, 0x68, 0x6F,
+  0x76, 0x7D, 0x84, 0x8B, 0x92, 0x99, 0xA0, 0xA7, 0xAE, 0xB5, 0xBC, 0xC3, 0xCA, 0xD1, 0xD8, 0xDF,
+  0xE6, 0xED, 0xF4, 0xFB, 0x02, 0x09, 0x10, 0x17, 0x1E, 0x25, 0x2C, 0x33, 0x3A, 0x41, 0x48, 0x4F,
+  0x56, 0x5D, 0x64, 0x6B, 0x72, 0x79, 0x80, 0x87, 0x8E, 0x95, 0x9C, 0xA3, 0xAA, 0xB1, 0xB8, 0xBF,
+  0xC6, 0xCD, 0xD4, 0xDB, 0xE2, 0xE9, 0xF0, 0xF7, 0xFE, 0x05, 0x0C, 0x13, 0x1A, 0x21, 0x28, 0x2F,
+  0x36, 0x3D, 0x44, 0x4B, 0x52, 0x59, 0x60, 0x67, 0x6E, 0x75, 0x7C, 0x83, 0x8A, 0x91, 0x98, 0x9F,
+  0xA6, 0xAD, 0xB4, 0xBB, 0xC2, 0xC9, 0xD0, 0xD7, 0xDE, 0xE5, 0xEC, 0xF3, 0xFA, 0x01, 0x08, 0x0F,
+  0x16, 0x1D, 0x24, 0x2B, 0x32, 0x39, 0x40, 0x47, 0x4E, 0x55, 0x5C, 0x63, 0x6A, 0x71, 0x22, 0x0F,
+};
+
+// RMC and GGA for the same fix as UBX_PVT_FIX_1
+static const char NMEA_FIX_1[] =
+  "$GPRMC,083015.00,A,4555.42200,N,00651.91200,E,2.430,87.50,140626,,,A*54\r\n"
+  "$GPGGA,083015.00,4555.42200,N,00651.91200,E,1,09,0.95,1035.2,M,48.1,M,,*63\r\n";
+
+// RMC and GGA for the same fix as UBX_PVT_FIX_2
+static const char NMEA_FIX_2[] =
+  "$GPRMC,083016.00,A,4555.42267,N,00651.91296,E,2.527,87.60,140626,,,A*5D\r\n"
+  "$GPGGA,083016.00,4555.42267,N,00651.91296,E,1,09,0.95,1035.3,M,48.1,M,,*6F\r\n";
+
+// Antenna status sentence, in the form u-blox receivers print at start-up
+static const char NMEA_TXT[] =
+  "$GPTXT,01,01,02,ANTSTATUS=OK*3B\r\n";
+
+#endif // GPS_STREAMS_H
@@ -0,0 +1,304 @@
+#ifndef VALLEY_TRACK_H
+#define VALLEY_TRACK_H
+
+#include <stdint.h>
+
+// ============= VALLEY TRACK =============
+// Six minutes of a hiker on a winding valley trail near the basecamp, one
+// fix per second, next to where the hiker really was. Generated rather than
+// logged, so every sample has a known truth: a walk at 1.05-1.35 m/s with
+// the error a receiver shows on such a trail laid over it.
+//   - open sky: hAcc 2.5-4 m, 9-11 SV, error correlated over ~20 s
+//   - 60-89 s under canopy: hAcc 6-12 m, 4-6 SV, larger error
+//   - 120-123 s multipath off the valley wall: 45 m east while the
+//     receiver still claims hAcc 5 m
+//   - 140-169 s standing still at a rest stop
+//   - 180-275 s no fix in a gully while the hiker keeps walking
+
+#define VALLEY_TRACK_MULTIPATH_START 120   // s
+#define VALLEY_TRACK_MULTIPATH_END   124
+#define VALLEY_TRACK_CANOPY_START    60
+#define VALLEY_TRACK_CANOPY_END      90
+#define VALLEY_TRACK_REST_START      140
+#define VALLEY_TRACK_REST_END        170
+#define VALLEY_TRACK_GAP_START       180
+#define VALLEY_TRACK_GAP_END         276
+
+struct TrackSample {
+  unsigned long fixTime;  // ms
+  double latitude;        // As reported
+  double longitude;
+  float hAccuracy;        // m, as reported
+  uint8_t satellites;
+  double trueLatitude;    // Where the hiker was
+  double trueLongitude;
+};
+
+static const TrackSample VALLEY_TRACK[] = {
+  {   493, 3.2084074, 101.7333110,  2.8f, 11, 3.2084083, 101.7333069},
+  {  1509, 3.2084222, 101.7333217,  3.1f,  9, 3.2084166, 101.7333139},
+  {  2508, 3.2084258, 101.7333282,  2.7f, 11, 3.2084249, 101.7333210},
+  {  3508, 3.2084386, 101.7333393,  3.3f, 11, 3.2084333, 101.7333281},
+  {  4530, 3.2084476, 101.7333436,  3.1f, 11, 3.2084418, 101.7333354},
+  {  5515, 3.2084548, 101.7333685,  2.9f,  9, 3.2084502, 101.7333427},
+  {  6524, 3.2084562, 101.7333669,  3.7f, 11, 3.2084587, 101.7333501},
+  {  7474, 3.2084750, 101.7333669,  2.8f,  9, 3.2084672, 101.7333575},
+  {  8512, 3.2084822, 101.7333730,  3.5f,  9, 3.2084757, 101.7333651},
+  {  9509, 3.2084902, 101.7333831,  3.6f,  9, 3.2084842, 101.7333729},
+  { 10513, 3.2084922, 101.7333931,  3.3f, 10, 3.2084927, 101.7333807},
+  { 11523, 3.2085034, 101.7333922,  3.8f, 10, 3.2085011, 101.7333886},
+  { 12530, 3.2085171, 101.7334053,  3.8f, 10, 3.2085095, 101.7333967},
+  { 13503, 3.2085116, 101.7334198,  3.9f,  9, 3.2085179, 101.7334049},
+  { 14477, 3.2085247, 101.7334370,  3.8f,  9, 3.2085262, 101.7334133},
+  { 15479, 3.2085277, 101.7334609,  3.3f, 11, 3.2085345, 101.7334217},
+  { 16490, 3.2085282, 101.7334629,  3.4f,  9, 3.2085426, 101.7334304},
+  { 17489, 3.2085294, 101.7334719,  3.8f, 10, 3.2085507, 101.7334391},
+  { 18478, 3.2085500, 101.7334741,  2.6f, 11, 3.2085587, 101.7334480},
+  { 19473, 3.2085510, 101.7334897,  3.4f,  9, 3.2085666, 101.7334571},
+  { 20502, 3.2085651, 101.7334985,  3.5f, 11, 3.2085743, 101.7334663},
+  { 21479, 3.2085653, 101.7335075,  3.3f,  9, 3.2085820, 101.7334756},
+  { 22500, 3.2085821, 101.7335109,  3.7f, 10, 3.2085895, 101.7334851},
+  { 23488, 3.2085933, 101.7335119,  2.6f, 10, 3.2085968, 101.7334947},
+  { 24526, 3.2085979, 101.7335236,  3.3f,  9, 3.2086040, 101.7335045},
+  { 25489, 3.2086107, 101.7335337,  3.3f, 10, 3.2086110, 101.7335144},
+  { 26497, 3.2086203, 101.7335402,  2.9f, 10, 3.2086179, 101.7335244},
+  { 27470, 3.2086226, 101.7335557,  3.0f, 11, 3.2086245, 101.7335346},
+  { 28512, 3.2086313, 101.7335570,  2.8f, 11, 3.2086310, 101.7335448},
+  { 29506, 3.2086405, 101.7335663,  2.6f, 11, 3.2086373, 101.7335552},
+  { 30528, 3.2086318, 101.7335864,  3.5f, 10, 3.2086433, 101.7335657},
+  { 31513, 3.2086491, 101.7335945,  2.7f, 10, 3.2086492, 101.7335763},
+  { 32474, 3.2086509, 101.7336027,  3.3f, 11, 3.2086548, 101.7335870},
+  { 33523, 3.2086605, 101.7336214,  3.1f, 11, 3.2086602, 101.7335978},
+  { 34519, 3.2086698, 101.7336411,  3.7f, 10, 3.2086654, 101.7336086},
+  { 35504, 3.2086745, 101.7336470,  3.2f,  9, 3.2086703, 101.7336195},
+  { 36522, 3.2086726, 101.7336668,  2.9f, 10, 3.2086750, 101.7336305},
+  { 37529, 3.2086796, 101.7336723,  3.6f, 11, 3.2086795, 101.7336416},
+  { 38487, 3.2086909, 101.7336709,  3.8f, 10, 3.2086837, 101.7336526},
+  { 39523, 3.2086928, 101.7336873,  3.7f, 11, 3.2086877, 101.7336637},
+  { 40522, 3.2086826, 101.7337017,  3.9f,  9, 3.2086914, 101.7336749},
+  { 41483, 3.2086870, 101.7337079,  2.8f,  9, 3.2086950, 101.7336860},
+  { 42478, 3.2086944, 101.7337210,  3.2f,  9, 3.2086983, 101.7336972},
+  { 43510, 3.2086896, 101.7337257,  3.4f, 10, 3.2087013, 101.7337084},
+  { 44482, 3.2087023, 101.7337372,  2.9f, 11, 3.2087041, 101.7337195},
+  { 45520, 3.2086941, 101.7337461,  3.0f, 10, 3.2087067, 101.7337306},
+  { 46493, 3.2086888, 101.7337561,  3.1f, 11, 3.2087091, 101.7337418},
+  { 47488, 3.2086863, 101.7337622,  2.8f, 10, 3.2087113, 101.7337528},
+  { 48480, 3.2086997, 101.7337725,  2.8f, 11, 3.2087133, 101.7337639},
+  { 49505, 3.2086977, 101.7337898,  3.8f, 10, 3.2087151, 101.7337749},
+  { 50475, 3.2086991, 101.7337984,  3.9f,  9, 3.2087166, 101.7337858},
+  { 51497, 3.2087050, 101.7338071,  3.4f, 11, 3.2087180, 101.7337967},
+  { 52470, 3.2087201, 101.7338144,  3.0f, 10, 3.2087193, 101.7338076},
+  { 53530, 3.2087146, 101.7338293,  2.9f, 10, 3.2087203, 101.7338183},
+  { 54484, 3.2087254, 101.7338344,  3.0f,  9, 3.2087212, 101.7338291},
+  { 55512, 3.2087348, 101.7338360,  3.6f, 11, 3.2087219, 101.7338397},
+  { 56519, 3.2087327, 101.7338388,  3.6f, 10, 3.2087225, 101.7338503},
+  { 57523, 3.2087342, 101.7338496,  2.6f,  9, 3.2087230, 101.7338608},
+  { 58503, 3.2087154, 101.7338620,  3.3f,  9, 3.2087233, 101.7338712},
+  { 59489, 3.2087071, 101.7338689,  2.5f, 11, 3.2087236, 101.7338816},
+  { 60489, 3.2087210, 101.7338763,  8.6f,  4, 3.2087237, 101.7338919},
+  { 61479, 3.2087223, 101.7338788,  6.2f,  4, 3.2087237, 101.7339021},
+  { 62512, 3.2087253, 101.7339137, 10.5f,  5, 3.2087236, 101.7339122},
+  { 63494, 3.2087126, 101.7339053,  9.7f,  6, 3.2087235, 101.7339223},
+  { 64518, 3.2087134, 101.7339353, 11.4f,  5, 3.2087233, 101.7339323},
+  { 65512, 3.2086961, 101.7339238,  8.9f,  6, 3.2087230, 101.7339422},
+  { 66485, 3.2087230, 101.7339309,  6.0f,  5, 3.2087227, 101.7339521},
+  { 67498, 3.2087159, 101.7339294, 11.4f,  4, 3.2087223, 101.7339619},
+  { 68488, 3.2087119, 101.7339447,  9.4f,  5, 3.2087219, 101.7339717},
+  { 69500, 3.2086993, 101.7339501,  6.5f,  6, 3.2087215, 101.7339814},
+  { 70529, 3.2087271, 101.7339648,  8.8f,  6, 3.2087210, 101.7339911},
+  { 71477, 3.2087170, 101.7339758, 11.2f,  4, 3.2087206, 101.7340007},
+  { 72479, 3.2086901, 101.7339579,  6.3f,  6, 3.2087201, 101.7340103},
+  { 73521, 3.2086848, 101.7339828,  9.0f,  4, 3.2087197, 101.7340199},
+  { 74472, 3.2086688, 101.7339838,  9.9f,  6, 3.2087193, 101.7340294},
+  { 75485, 3.2087068, 101.7339809,  7.2f,  6, 3.2087189, 101.7340389},
+  { 76486, 3.2087238, 101.7340141,  8.7f,  6, 3.2087185, 101.7340484},
+  { 77511, 3.2087154, 101.7340171, 11.2f,  4, 3.2087182, 101.7340578},
+  { 78527, 3.2087037, 101.7340319, 11.7f,  6, 3.2087179, 101.7340673},
+  { 79489, 3.2086510, 101.7340460,  9.5f,  5, 3.2087176, 101.7340767},
+  { 80493, 3.2086536, 101.7340706,  9.9f,  5, 3.2087175, 101.7340862},
+  { 81516, 3.2086513, 101.7341101,  7.8f,  4, 3.2087174, 101.7340956},
+  { 82504, 3.2086375, 101.7341294,  8.2f,  6, 3.2087173, 101.7341051},
+  { 83470, 3.2086229, 101.7341203,  6.8f,  4, 3.2087174, 101.7341145},
+  { 84484, 3.2086360, 101.7341491, 10.0f,  6, 3.2087176, 101.7341240},
+  { 85529, 3.2086616, 101.7341553, 10.1f,  6, 3.2087178, 101.7341335},
+  { 86507, 3.2086644, 101.7341616, 11.8f,  6, 3.2087182, 101.7341430},
+  { 87508, 3.2086620, 101.7341768, 10.9f,  4, 3.2087186, 101.7341526},
+  { 88524, 3.2086769, 101.7341993,  8.5f,  5, 3.2087192, 101.7341621},
+  { 89525, 3.2086906, 101.7341993, 10.0f,  6, 3.2087200, 101.7341717},
+  { 90484, 3.2086954, 101.7342128,  3.7f, 11, 3.2087208, 101.7341814},
+  { 91520, 3.2087013, 101.7342262,  2.7f, 10, 3.2087219, 101.7341910},
+  { 92483, 3.2087073, 101.7342465,  2.9f,  9, 3.2087230, 101.7342007},
+  { 93512, 3.2087209, 101.7342476,  2.9f, 11, 3.2087243, 101.7342105},
+  { 94520, 3.2087111, 101.7342678,  2.8f, 11, 3.2087258, 101.7342202},
+  { 95519, 3.2087151, 101.7342773,  3.9f, 11, 3.2087275, 101.7342300},
+  { 96501, 3.2087144, 101.7342873,  2.8f, 11, 3.2087293, 101.7342398},
+  { 97496, 3.2087217, 101.7342835,  4.0f, 11, 3.2087314, 101.7342497},
+  { 98530, 3.2087197, 101.7342900,  3.8f,  9, 3.2087336, 101.7342596},
+  { 99497, 3.2087134, 101.7343053,  3.6f,  9, 3.2087360, 101.7342695},
+  {100497, 3.2087262, 101.7343190,  4.0f, 11, 3.2087386, 101.7342794},
+  {101517, 3.2087298, 101.7343370,  3.9f, 11, 3.2087414, 101.7342894},
+  {102505, 3.2087333, 101.7343383,  2.5f,  9, 3.2087445, 101.7342993},
+  {103489, 3.2087387, 101.7343466,  2.5f, 10, 3.2087477, 101.7343093},
+  {104471, 3.2087510, 101.7343575,  2.9f, 11, 3.2087512, 101.7343193},
+  {105503, 3.2087426, 101.7343603,  3.5f,  9, 3.2087549, 101.7343293},
+  {106498, 3.2087369, 101.7343584,  2.6f, 11, 3.2087588, 101.7343393},
+  {107501, 3.2087364, 101.7343670,  3.2f,  9, 3.2087630, 101.7343492},
+  {108470, 3.2087333, 101.7343783,  3.2f,  9, 3.2087674, 101.7343592},
+  {109480, 3.2087451, 101.7343805,  3.3f, 10, 3.2087720, 101.7343692},
+  {110530, 3.2087426, 101.7344021,  3.8f,  9, 3.2087768, 101.7343791},
+  {111501, 3.2087618, 101.7344201,  3.0f, 10, 3.2087819, 101.7343890},
+  {112515, 3.2087561, 101.7344188,  3.8f,  9, 3.2087872, 101.7343988},
+  {113515, 3.2087723, 101.7344302,  3.6f, 10, 3.2087928, 101.7344086},
+  {114522, 3.2087724, 101.7344322,  3.3f, 10, 3.2087985, 101.7344184},
+  {115481, 3.2087783, 101.7344392,  3.7f,  9, 3.2088045, 101.7344281},
+  {116477, 3.2087894, 101.7344511,  2.8f, 11, 3.2088107, 101.7344378},
+  {117520, 3.2087997, 101.7344689,  3.2f, 11, 3.2088171, 101.7344474},
+  {118499, 3.2088032, 101.7344770,  3.4f, 11, 3.2088238, 101.7344569},
+  {119474, 3.2088136, 101.7344799,  3.2f, 11, 3.2088306, 101.7344664},
+  {120502, 3.2088174, 101.7348839,  5.0f, 10, 3.2088376, 101.7344758},
+  {121495, 3.2088399, 101.7348974,  5.0f, 10, 3.2088449, 101.7344851},
+  {122525, 3.2088622, 101.7349102,  5.0f,  9, 3.2088523, 101.7344943},
+  {123515, 3.2088735, 101.7349186,  5.0f,  9, 3.2088599, 101.7345035},
+  {124490, 3.2088983, 101.7345367,  3.2f, 11, 3.2088677, 101.7345125},
+  {125472, 3.2088945, 101.7345412,  3.1f, 10, 3.2088756, 101.7345215},
+  {126507, 3.2089053, 101.7345571,  3.5f, 10, 3.2088837, 101.7345304},
+  {127526, 3.2089057, 101.7345645,  3.7f,  9, 3.2088919, 101.7345392},
+  {128494, 3.2088957, 101.7345679,  3.3f, 11, 3.2089002, 101.7345479},
+  {129488, 3.2089015, 101.7345782,  3.3f,  9, 3.2089087, 101.7345565},
+  {130491, 3.2089011, 101.7345813,  3.6f,  9, 3.2089173, 101.7345650},
+  {131523, 3.2089108, 101.7345858,  3.5f, 11, 3.2089260, 101.7345735},
+  {132522, 3.2089197, 101.7345826,  3.2f, 10, 3.2089348, 101.7345818},
+  {133523, 3.2089266, 101.7345862,  3.8f,  9, 3.2089437, 101.7345901},
+  {134525, 3.2089305, 101.7345977,  2.8f, 11, 3.2089526, 101.7345983},
+  {135486, 3.2089331, 101.7346088,  3.8f, 11, 3.2089616, 101.7346064},
+  {136525, 3.2089360, 101.7346137,  3.8f,  9, 3.2089707, 101.7346145},
+  {137514, 3.2089559, 101.7346159,  3.3f, 11, 3.2089798, 101.7346225},
+  {138530, 3.2089750, 101.7346313,  2.7f, 11, 3.2089889, 101.7346304},
+  {139515, 3.2089837, 101.7346375,  3.0f, 11, 3.2089981, 101.7346383},
+  {140529, 3.2089845, 101.7346494,  3.2f, 10, 3.2089981, 101.7346383},
+  {141510, 3.2089829, 101.7346488,  3.4f, 11, 3.2089981, 101.7346383},
+  {142507, 3.2089754, 101.7346600,  3.8f, 10, 3.2089981, 101.7346383},
+  {143510, 3.2089772, 101.7346587,  2.8f, 11, 3.2089981, 101.7346383},
+  {144483, 3.2089772, 101.7346723,  2.5f, 11, 3.2089981, 101.7346383},
+  {145524, 3.2089738, 101.7346775,  3.1f, 10, 3.2089981, 101.7346383},
+  {146526, 3.2089707, 101.7346891,  3.6f, 10, 3.2089981, 101.7346383},
+  {147474, 3.2089696, 101.7346937,  4.0f,  9, 3.2089981, 101.7346383},
+  {148526, 3.2089720, 101.7346845,  3.6f, 10, 3.2089981, 101.7346383},
+  {149484, 3.2089723, 101.7346772,  3.5f,  9, 3.2089981, 101.7346383},
+  {150507, 3.2089689, 101.7346782,  3.3f,  9, 3.2089981, 101.7346383},
+  {151518, 3.2089606, 101.7346753,  3.3f, 10, 3.2089981, 101.7346383},
+  {152517, 3.2089678, 101.7346845,  2.7f, 11, 3.2089981, 101.7346383},
+  {153512, 3.2089706, 101.7346836,  3.2f, 11, 3.2089981, 101.7346383},
+  {154519, 3.2089823, 101.7346750,  3.3f,  9, 3.2089981, 101.7346383},
+  {155470, 3.2089807, 101.7346721,  3.7f, 10, 3.2089981, 101.7346383},
+  {156499, 3.2089742, 101.7346714,  2.7f, 10, 3.2089981, 101.7346383},
+  {157499, 3.2089693, 101.7346792,  3.3f, 10, 3.2089981, 101.7346383},
+  {158507, 3.2089736, 101.7346717,  3.8f,  9, 3.2089981, 101.7346383},
+  {159484, 3.2089665, 101.7346664,  2.6f, 10, 3.2089981, 101.7346383},
+  {160519, 3.2089622, 101.7346667,  3.5f, 11, 3.2089981, 101.7346383},
+  {161525, 3.2089448, 101.7346750,  3.2f, 11, 3.2089981, 101.7346383},
+  {162505, 3.2089613, 101.7346732,  3.7f, 11, 3.2089981, 101.7346383},
+  {163483, 3.2089693, 101.7346757,  3.3f, 10, 3.2089981, 101.7346383},
+  {164490, 3.2089800, 101.7346819,  3.8f, 10, 3.2089981, 101.7346383},
+  {165502, 3.2089865, 101.7346842,  3.8f,  9, 3.2089981, 101.7346383},
+  {166508, 3.2089951, 101.7346783,  3.3f, 10, 3.2089981, 101.7346383},
+  {167513, 3.2090027, 101.7346741,  2.8f, 10, 3.2089981, 101.7346383},
+  {168478, 3.2090075, 101.7346758,  3.9f, 11, 3.2089981, 101.7346383},
+  {169527, 3.2089988, 101.7346765,  2.8f, 10, 3.2089981, 101.7346383},
+  {170500, 3.2090098, 101.7346838,  2.6f, 10, 3.2090038, 101.7346465},
+  {171519, 3.2090135, 101.7346916,  2.6f,  9, 3.2090094, 101.7346548},
+  {172513, 3.2090218, 101.7346958,  3.6f,  9, 3.2090148, 101.7346632},
+  {173523, 3.2090290, 101.7347079,  3.9f, 10, 3.2090199, 101.7346716},
+  {174470, 3.2090267, 101.7347015,  3.3f,  9, 3.2090249, 101.7346800},
+  {175493, 3.2090167, 101.7347123,  2.6f, 10, 3.2090297, 101.7346885},
+  {176499, 3.2090287, 101.7347088,  3.6f, 10, 3.2090343, 101.7346971},
+  {177511, 3.2090289, 101.7347298,  3.0f, 11, 3.2090388, 101.7347057},
+  {178473, 3.2090244, 101.7347330,  2.8f,  9, 3.2090430, 101.7347143},
+  {179472, 3.2090483, 101.7347513,  3.4f,  9, 3.2090470, 101.7347230},
+  {276487, 3.2093131, 101.7356608,  3.0f, 10, 3.2092953, 101.7357144},
+  {277520, 3.2093232, 101.7356739,  3.1f, 10, 3.2093026, 101.7357213},
+  {278503, 3.2093282, 101.7356887,  2.6f,  9, 3.2093099, 101.7357281},
+  {279527, 3.2093366, 101.7356974,  3.0f, 10, 3.2093172, 101.7357348},
+  {280526, 3.2093421, 101.7357046,  2.9f,  9, 3.2093246, 101.7357413},
+  {281508, 3.2093400, 101.7357276,  4.0f, 10, 3.2093319, 101.7357478},
+  {282483, 3.2093365, 101.7357454,  3.3f,  9, 3.2093393, 101.7357542},
+  {283526, 3.2093352, 101.7357508,  3.3f, 10, 3.2093466, 101.7357606},
+  {284501, 3.2093468, 101.7357523,  2.5f, 10, 3.2093540, 101.7357668},
+  {285525, 3.2093553, 101.7357601,  2.6f, 10, 3.2093613, 101.7357731},
+  {286518, 3.2093589, 101.7357637,  2.7f, 10, 3.2093686, 101.7357792},
+  {287508, 3.2093627, 101.7357693,  3.2f, 10, 3.2093759, 101.7357854},
+  {288522, 3.2093734, 101.7357681,  2.9f, 11, 3.2093832, 101.7357915},
+  {289473, 3.2093772, 101.7357816,  3.8f, 11, 3.2093904, 101.7357976},
+  {290517, 3.2093874, 101.7357853,  3.3f,  9, 3.2093977, 101.7358037},
+  {291501, 3.2093965, 101.7358019,  3.9f, 11, 3.2094049, 101.7358098},
+  {292495, 3.2094141, 101.7358120,  3.8f, 11, 3.2094121, 101.7358159},
+  {293475, 3.2094209, 101.7358225,  3.0f,  9, 3.2094193, 101.7358221},
+  {294503, 3.2094203, 101.7358270,  3.7f,  9, 3.2094264, 101.7358282},
+  {295516, 3.2094447, 101.7358338,  3.7f, 10, 3.2094336, 101.7358344},
+  {296495, 3.2094490, 101.7358438,  3.4f, 11, 3.2094406, 101.7358407},
+  {297505, 3.2094570, 101.7358492,  3.6f,  9, 3.2094477, 101.7358470},
+  {298512, 3.2094706, 101.7358585,  2.8f,  9, 3.2094547, 101.7358534},
+  {299497, 3.2094777, 101.7358628,  4.0f, 10, 3.2094617, 101.7358598},
+  {300487, 3.2094774, 101.7358778,  3.1f,  9, 3.2094686, 101.7358663},
+  {301491, 3.2094809, 101.7358739,  3.0f, 11, 3.2094755, 101.7358730},
+  {302491, 3.2094979, 101.7358812,  2.9f,  9, 3.2094824, 101.7358797},
+  {303524, 3.2094935, 101.7358799,  3.8f, 10, 3.2094892, 101.7358865},
+  {304471, 3.2094982, 101.7358827,  2.7f, 10, 3.2094959, 101.7358934},
+  {305528, 3.2094984, 101.7358904,  3.0f, 10, 3.2095026, 101.7359005},
+  {306478, 3.2095006, 101.7358998,  3.1f, 11, 3.2095093, 101.7359077},
+  {307521, 3.2095213, 101.7359101,  3.7f, 10, 3.2095158, 101.7359150},
+  {308486, 3.2095246, 101.7359149,  3.8f,  9, 3.2095223, 101.7359225},
+  {309475, 3.2095317, 101.7359253,  3.4f, 11, 3.2095287, 101.7359301},
+  {310509, 3.2095513, 101.7359342,  2.7f, 11, 3.2095351, 101.7359378},
+  {311516, 3.2095558, 101.7359421,  3.9f,  9, 3.2095413, 101.7359457},
+  {312470, 3.2095629, 101.7359637,  4.0f,  9, 3.2095475, 101.7359538},
+  {313514, 3.2095652, 101.7359791,  3.3f, 11, 3.2095536, 101.7359620},
+  {314521, 3.2095689, 101.7359825,  2.8f, 10, 3.2095595, 101.7359704},
+  {315481, 3.2095779, 101.7359800,  3.6f, 11, 3.2095654, 101.7359789},
+  {316521, 3.2095792, 101.7360015,  2.7f, 10, 3.2095711, 101.7359877},
+  {317512, 3.2095750, 101.7360083,  2.9f, 10, 3.2095767, 101.7359966},
+  {318514, 3.2095788, 101.7360160,  3.4f, 11, 3.2095822, 101.7360056},
+  {319480, 3.2095779, 101.7360281,  3.4f,  9, 3.2095875, 101.7360149},
+  {320510, 3.2095811, 101.7360304,  3.7f, 10, 3.2095927, 101.7360243},
+  {321504, 3.2095834, 101.7360358,  3.6f,  9, 3.2095978, 101.7360339},
+  {322525, 3.2095905, 101.7360458,  3.5f, 10, 3.2096027, 101.7360437},
+  {323524, 3.2096061, 101.7360525,  3.8f,  9, 3.2096074, 101.7360536},
+  {324477, 3.2096176, 101.7360712,  3.7f, 10, 3.2096120, 101.7360637},
+  {325523, 3.2096212, 101.7360822,  3.5f,  9, 3.2096164, 101.7360739},
+  {326485, 3.2096155, 101.7360935,  3.3f, 10, 3.2096206, 101.7360843},
+  {327527, 3.2096170, 101.7361054,  2.6f, 11, 3.2096246, 101.7360949},
+  {328478, 3.2096138, 101.7361165,  3.1f,  9, 3.2096285, 101.7361056},
+  {329530, 3.2096126, 101.7361287,  3.3f, 10, 3.2096322, 101.7361164},
+  {330512, 3.2096183, 101.7361433,  3.4f, 11, 3.2096356, 101.7361274},
+  {331485, 3.2096196, 101.7361620,  3.7f, 11, 3.2096389, 101.7361385},
+  {332484, 3.2096257, 101.7361682,  3.5f, 10, 3.2096420, 101.7361497},
+  {333499, 3.2096279, 101.7361796,  3.3f, 11, 3.2096449, 101.7361611},
+  {334509, 3.2096372, 101.7361849,  3.1f, 10, 3.2096476, 101.7361725},
+  {335517, 3.2096344, 101.7361800,  2.7f, 11, 3.2096501, 101.7361841},
+  {336475, 3.2096438, 101.7361955,  3.0f, 11, 3.2096523, 101.7361957},
+  {337506, 3.2096371, 101.7362040,  2.7f, 11, 3.2096544, 101.7362074},
+  {338512, 3.2096388, 101.7362152,  2.6f,  9, 3.2096564, 101.7362192},
+  {339522, 3.2096480, 101.7362242,  2.8f, 10, 3.2096581, 101.7362311},
+  {340486, 3.2096605, 101.7362293,  2.5f, 11, 3.2096596, 101.7362430},
+  {341476, 3.2096623, 101.7362441,  3.2f,  9, 3.2096610, 101.7362550},
+  {342523, 3.2096624, 101.7362514,  3.2f,  9, 3.2096621, 101.7362671},
+  {343474, 3.2096736, 101.7362765,  3.0f,  9, 3.2096631, 101.7362791},
+  {344474, 3.2096606, 101.7362835,  2.7f,  9, 3.2096640, 101.7362912},
+  {345472, 3.2096666, 101.7362937,  3.1f,  9, 3.2096647, 101.7363033},
+  {346528, 3.2096695, 101.7363008,  3.9f, 11, 3.2096652, 101.7363155},
+  {347526, 3.2096730, 101.7363042,  2.6f,  9, 3.2096656, 101.7363276},
+  {348521, 3.2096761, 101.7363330,  2.8f, 10, 3.2096659, 101.7363397},
+  {349498, 3.2096734, 101.7363333,  3.2f, 11, 3.2096660, 101.7363519},
+  {350511, 3.2096688, 101.7363407,  3.7f, 11, 3.2096661, 101.7363640},
+  {351502, 3.2096768, 101.7363554,  3.1f, 11, 3.2096660, 101.7363761},
+  {352475, 3.2096706, 101.7363637,  2.5f, 10, 3.2096658, 101.7363882},
+  {353506, 3.2096689, 101.7363735,  3.7f, 11, 3.2096656, 101.7364003},
+  {354483, 3.2096706, 101.7363871,  3.5f, 10, 3.2096652, 101.7364123},
+  {355509, 3.2096590, 101.7364018,  3.8f,  9, 3.2096648, 101.7364243},
+  {356484, 3.2096654, 101.7364126,  2.8f,  9, 3.2096644, 101.7364363},
+  {357478, 3.2096691, 101.7364264,  3.9f, 11, 3.2096639, 101.7364482},
+  {358483, 3.2096675, 101.7364363,  3.5f, 11, 3.2096634, 101.7364601},
+  {359510, 3.2096717, 101.7364414,  3.6f,  9, 3.2096628, 101.7364719},
+};
+
+#endif // VALLEY_TRACK_H
@@ -0,0 +1,98 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <TinyGPS++.h>
+#include <ubx_parser.h>
+#include "gps_streams.h"
+
+// ============= SETTINGS =============
+#define BENCH_FIXES 20000   // Per decoder, alternating the two seconds in gps_streams.h
+
+static UBXParser ubx;
+static TinyGPSPlus nmea;
+
+void setUp() {
+  ubxInit(ubx);
+  nmea = TinyGPSPlus();
+}
+
+void tearDown() {}
+
+static void feedNMEA(const char* text) {
+  while (*text) {
+    nmea.encode(*text++);
+  }
+}
+
+static void feedUBX(const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    ubxEncode(ubx, data[i]);
+  }
+}
+
+// ============= TESTS =============
+// Same second through both decoders: the fallback must report what UBX does
+void test_decoders_agree_on_the_same_fix() {
+  feedUBX(UBX_PVT_FIX_1, sizeof(UBX_PVT_FIX_1));
+  feedNMEA(NMEA_FIX_1);
+
+  TEST_ASSERT_EQUAL(2, nmea.passedChecksum());
+  TEST_ASSERT_EQUAL(0, nmea.failedChecksum());
+  TEST_ASSERT_TRUE(nmea.location.isValid());
+  // NMEA carries 1e-5 arc minutes, about 2e-7 degrees
+  TEST_ASSERT_DOUBLE_WITHIN(2e-7, ubx.pvt.latitude, nmea.location.lat());
+  TEST_ASSERT_DOUBLE_WITHIN(2e-7, ubx.pvt.longitude, nmea.location.lng());
+  TEST_ASSERT_FLOAT_WITHIN(0.05, ubx.pvt.altitudeMSL, nmea.altitude.meters());
+  TEST_ASSERT_FLOAT_WITHIN(0.01, ubx.pvt.groundSpeed, nmea.speed.mps());
+  TEST_ASSERT_FLOAT_WITHIN(0.01, ubx.pvt.heading, nmea.course.deg());
+  TEST_ASSERT_EQUAL(ubx.pvt.numSV, nmea.satellites.value());
+  TEST_ASSERT_EQUAL(ubx.pvt.hour, nmea.time.hour());
+  TEST_ASSERT_EQUAL(ubx.pvt.minute, nmea.time.minute());
+  TEST_ASSERT_EQUAL(ubx.pvt.second, nmea.time.second());
+  TEST_ASSERT_EQUAL(ubx.pvt.day, nmea.date.day());
+}
+
+// CPU per fix: one NAV-PVT frame against the RMC+GGA pair TinyGPS++ needs
+// for the same information. Host timings only show the ratio; the ESP32-C3
+// figure comes from getGPSStats().parseMicrosPerFix on the device.
+void test_cpu_per_fix() {
+  unsigned long start = micros();
+  for (int i = 0; i < BENCH_FIXES; i++) {
+    if (i & 1) {
+      feedUBX(UBX_PVT_FIX_2, sizeof(UBX_PVT_FIX_2));
+    } else {
+      feedUBX(UBX_PVT_FIX_1, sizeof(UBX_PVT_FIX_1));
+    }
+  }
+  unsigned long ubxMicros = micros() - start;
+
+  start = micros();
+  for (int i = 0; i < BENCH_FIXES; i++) {
+    feedNMEA((i & 1) ? NMEA_FIX_2 : NMEA_FIX_1);
+  }
+  unsigned long nmeaMicros = micros() - start;
+
+  TEST_ASSERT_EQUAL(BENCH_FIXES, ubx.framesDecoded);
+  TEST_ASSERT_EQUAL(0, ubx.checksumFailures);
+  TEST_ASSERT_EQUAL(2 * BENCH_FIXES, nmea.sentencesWithFix());
+  TEST_ASSERT_EQUAL(0, nmea.failedChecksum());
+
+  char message[160];
+  snprintf(message, sizeof(message),
+           "UBX  %.1f ns/fix, %u bytes/fix",
+           ubxMicros * 1000.0 / BENCH_FIXES, (unsigned)sizeof(UBX_PVT_FIX_1));
+  TEST_MESSAGE(message);
+  snprintf(message, sizeof(message),
+           "NMEA %.1f ns/fix, %u bytes/fix (TinyGPS++, RMC+GGA)",
+           nmeaMicros * 1000.0 / BENCH_FIXES, (unsigned)strlen(NMEA_FIX_1));
+  TEST_MESSAGE(message);
+
+  TEST_ASSERT_LESS_THAN(nmeaMicros, ubxMicros);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_decoders_agree_on_the_same_fix);
+  RUN_TEST(test_cpu_per_fix);
+  return UNITY_END();
+}
@@ -0,0 +1,252 @@
+#include <unity.h>
+#include <math.h>
+#include "track_filter.h"
+#include "valley_track.h"
+
+// ============= HELPERS =============
+#define WALK_LAT   3.2084
+#define WALK_LNG   101.7333
+#define WALK_SPEED 1.2f    // m/s, due north
+
+static uint32_t noiseState;
+
+// Deterministic uniform noise in [-1, 1], the same on every host
+static float noise() {
+  noiseState = noiseState * 1664525UL + 1013904223UL;
+  return (noiseState >> 8) / 8388608.0f - 1.0f;
+}
+
+static GPSFix makeFix(double latitude, double longitude, float hAccuracy,
+                      uint32_t satellites, unsigned long fixTime) {
+  GPSFix fix = {};
+  fix.locationValid = true;
+  fix.latitude = latitude;
+  fix.longitude = longitude;
+  fix.hAccuracy = hAccuracy;
+  fix.satellites = satellites;
+  fix.fixTime = fixTime;
+  return fix;
+}
+
+static GPSFix sampleFix(const TrackSample& sample) {
+  return makeFix(sample.latitude, sample.longitude, sample.hAccuracy,
+                 sample.satellites, sample.fixTime);
+}
+
+// Walk fix i: 1 Hz, +-5 m of noise north and east
+static GPSFix walkFix(int i) {
+  double north = i * WALK_SPEED + 5.0 * noise();
+  double east = 5.0 * noise();
+  return makeFix(WALK_LAT + north / METRES_PER_DEG_LAT,
+                 WALK_LNG + east / (METRES_PER_DEG_LAT * cos(WALK_LAT * DEG_TO_RAD)),
+                 5.0, 8, i * 1000UL + 1);
+}
+
+// Metres between two points; flat earth is plenty over a few hundred metres
+static double distance(double lat1, double lng1, double lat2, double lng2) {
+  double north = (lat2 - lat1) * METRES_PER_DEG_LAT;
+  double east = (lng2 - lng1) * METRES_PER_DEG_LAT * cos(lat1 * DEG_TO_RAD);
+  return sqrt(north * north + east * east);
+}
+
+static double trackError(double latitude, double longitude) {
+  TrackPosition position = getTrackPosition();
+  return distance(latitude, longitude, position.latitude, position.longitude);
+}
+
+static bool inWindow(const TrackSample& sample, int start, int end) {
+  return sample.fixTime >= start * 1000UL && sample.fixTime < end * 1000UL;
+}
+
+static const size_t VALLEY_TRACK_LENGTH = sizeof(VALLEY_TRACK) / sizeof(VALLEY_TRACK[0]);
+
+void setUp() {
+  trackFilter = TrackFilter();
+  noiseState = 20260614;
+}
+
+void tearDown() {}
+
+// ============= SYNTHETIC WALK =============
+void test_walk_rejects_300m_jump() {
+  float speedSum = 0;
+  for (int i = 0; i < 300; i++) {
+    GPSFix fix = walkFix(i);
+    if (i == 100) {
+      fix.latitude += 300.0 / METRES_PER_DEG_LAT;
+      TEST_ASSERT_FALSE(updateTrackFilter(fix));
+      continue;
+    }
+    updateTrackFilter(fix);
+    if (i == 101) {
+      // The jump left no mark on the estimate
+      TEST_ASSERT_LESS_THAN_DOUBLE(10.0, trackError(WALK_LAT + i * WALK_SPEED / METRES_PER_DEG_LAT, WALK_LNG));
+    }
+    if (i >= 200) speedSum += getTrackPosition().speed;
+  }
+
+  TrackFilterStats stats = getTrackFilterStats();
+  TEST_ASSERT_EQUAL(299, stats.accepted);
+  TEST_ASSERT_EQUAL(1, stats.rejected);
+  TEST_ASSERT_EQUAL(1, stats.resets);
+
+  TrackPosition position = getTrackPosition();
+  TEST_ASSERT_TRUE(position.valid);
+  // Any single second's speed is noisy; the last hundred average out
+  TEST_ASSERT_FLOAT_WITHIN(0.2, WALK_SPEED, speedSum / 100);
+  TEST_ASSERT_LESS_THAN_FLOAT(5.0, position.accuracy);
+}
+
+void test_walk_error_below_raw_fixes() {
+  double rawSquares = 0;
+  double filteredSquares = 0;
+  int counted = 0;
+  for (int i = 0; i < 300; i++) {
+    GPSFix fix = walkFix(i);
+    updateTrackFilter(fix);
+    if (i < 20) continue;   // Let the velocity settle first
+
+    double trueLat = WALK_LAT + i * WALK_SPEED / METRES_PER_DEG_LAT;
+    double raw = distance(trueLat, WALK_LNG, fix.latitude, fix.longitude);
+    double filtered = trackError(trueLat, WALK_LNG);
+    rawSquares += raw * raw;
+    filteredSquares += filtered * filtered;
+    counted++;
+  }
+  // Independent noise each second, so averaging has to show
+  TEST_ASSERT_LESS_THAN_DOUBLE(0.75 * sqrt(rawSquares / counted), sqrt(filteredSquares / counted));
+}
+
+void test_repeat_and_invalid_fixes_are_ignored() {
+  GPSFix fix = walkFix(0);
+  TEST_ASSERT_TRUE(updateTrackFilter(fix));
+  TEST_ASSERT_FALSE(updateTrackFilter(fix));
+
+  GPSFix invalid = walkFix(1);
+  invalid.locationValid = false;
+  TEST_ASSERT_FALSE(updateTrackFilter(invalid));
+
+  TrackFilterStats stats = getTrackFilterStats();
+  TEST_ASSERT_EQUAL(1, stats.accepted);
+  TEST_ASSERT_EQUAL(0, stats.rejected);
+}
+
+void test_gap_restarts_at_the_new_fix() {
+  for (int i = 0; i < 30; i++) {
+    updateTrackFilter(walkFix(i));
+  }
+  // Far beyond what the old velocity allows, but after TRACK_MAX_GAP
+  GPSFix fix = walkFix(30 + (int)TRACK_MAX_GAP + 1);
+  fix.latitude += 500.0 / METRES_PER_DEG_LAT;
+  TEST_ASSERT_TRUE(updateTrackFilter(fix));
+
+  TEST_ASSERT_EQUAL(2, getTrackFilterStats().resets);
+  TEST_ASSERT_LESS_THAN_DOUBLE(0.01, trackError(fix.latitude, fix.longitude));
+  TEST_ASSERT_EQUAL_FLOAT(0, getTrackPosition().speed);
+}
+
+void test_run_of_rejects_restarts_the_filter() {
+  int i = 0;
+  for (; i < 30; i++) {
+    updateTrackFilter(walkFix(i));
+  }
+  // The filter was wrong, not the receiver: the hiker really is 300 m on
+  GPSFix fix;
+  for (int run = 0; run < TRACK_MAX_REJECTS; run++, i++) {
+    fix = walkFix(i);
+    fix.latitude += 300.0 / METRES_PER_DEG_LAT;
+    TEST_ASSERT_FALSE(updateTrackFilter(fix));
+  }
+
+  TrackFilterStats stats = getTrackFilterStats();
+  TEST_ASSERT_EQUAL(TRACK_MAX_REJECTS, stats.rejected);
+  TEST_ASSERT_EQUAL(2, stats.resets);
+  TEST_ASSERT_LESS_THAN_DOUBLE(0.01, trackError(fix.latitude, fix.longitude));
+
+  fix = walkFix(i);
+  fix.latitude += 300.0 / METRES_PER_DEG_LAT;
+  TEST_ASSERT_TRUE(updateTrackFilter(fix));
+}
+
+// ============= VALLEY TRACK =============
+void test_valley_track_rejects_multipath_only() {
+  int multipathRejected = 0;
+  int otherRejected = 0;
+  for (size_t i = 0; i < VALLEY_TRACK_LENGTH; i++) {
+    const TrackSample& sample = VALLEY_TRACK[i];
+    bool accepted = updateTrackFilter(sampleFix(sample));
+    if (inWindow(sample, VALLEY_TRACK_MULTIPATH_START, VALLEY_TRACK_MULTIPATH_END)) {
+      multipathRejected += !accepted;
+    } else {
+      otherRejected += !accepted;
+    }
+  }
+
+  TEST_ASSERT_EQUAL(VALLEY_TRACK_MULTIPATH_END - VALLEY_TRACK_MULTIPATH_START, multipathRejected);
+  TEST_ASSERT_EQUAL(0, otherRejected);
+  // Once to start and once after the gully
+  TEST_ASSERT_EQUAL(2, getTrackFilterStats().resets);
+}
+
+void test_valley_track_error_below_raw_fixes() {
+  double rawSquares = 0;
+  double filteredSquares = 0;
+  double worstFiltered = 0;
+  for (size_t i = 0; i < VALLEY_TRACK_LENGTH; i++) {
+    const TrackSample& sample = VALLEY_TRACK[i];
+    updateTrackFilter(sampleFix(sample));
+
+    double raw = distance(sample.trueLatitude, sample.trueLongitude, sample.latitude, sample.longitude);
+    double filtered = trackError(sample.trueLatitude, sample.trueLongitude);
+    rawSquares += raw * raw;
+    filteredSquares += filtered * filtered;
+    worstFiltered = fmax(worstFiltered, filtered);
+  }
+
+  // The receiver's error is correlated over ~20 s, which no filter can
+  // average away, so away from the valley wall it only keeps pace with the
+  // raw fixes; the gain is in never following the reflections
+  TEST_ASSERT_LESS_THAN_DOUBLE(sqrt(rawSquares / VALLEY_TRACK_LENGTH), sqrt(filteredSquares / VALLEY_TRACK_LENGTH));
+  TEST_ASSERT_LESS_THAN_DOUBLE(20.0, worstFiltered);
+}
+
+void test_valley_track_settles_at_rest_stop() {
+  for (size_t i = 0; i < VALLEY_TRACK_LENGTH; i++) {
+    const TrackSample& sample = VALLEY_TRACK[i];
+    updateTrackFilter(sampleFix(sample));
+    if (sample.fixTime / 1000 == VALLEY_TRACK_REST_END - 1) {
+      TEST_ASSERT_LESS_THAN_FLOAT(0.5, getTrackPosition().speed);
+      return;
+    }
+  }
+  TEST_FAIL_MESSAGE("Track has no fix at the end of the rest stop");
+}
+
+void test_valley_track_accuracy_follows_the_sky() {
+  float canopyAccuracy = 0;
+  float openAccuracy = 0;
+  for (size_t i = 0; i < VALLEY_TRACK_LENGTH; i++) {
+    const TrackSample& sample = VALLEY_TRACK[i];
+    updateTrackFilter(sampleFix(sample));
+    unsigned long second = sample.fixTime / 1000;
+    if (second == VALLEY_TRACK_CANOPY_START - 1) openAccuracy = getTrackPosition().accuracy;
+    if (second == VALLEY_TRACK_CANOPY_END - 1) canopyAccuracy = getTrackPosition().accuracy;
+  }
+  // Better than any single open-sky fix claims, worse under the trees
+  TEST_ASSERT_LESS_THAN_FLOAT(2.5, openAccuracy);
+  TEST_ASSERT_LESS_THAN_FLOAT(canopyAccuracy, openAccuracy);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_walk_rejects_300m_jump);
+  RUN_TEST(test_walk_error_below_raw_fixes);
+  RUN_TEST(test_repeat_and_invalid_fixes_are_ignored);
+  RUN_TEST(test_gap_restarts_at_the_new_fix);
+  RUN_TEST(test_run_of_rejects_restarts_the_filter);
+  RUN_TEST(test_valley_track_rejects_multipath_only);
+  RUN_TEST(test_valley_track_error_below_raw_fixes);
+  RUN_TEST(test_valley_track_settles_at_rest_stop);
+  RUN_TEST(test_valley_track_accuracy_follows_the_sky);
+  return UNITY_END();
+}
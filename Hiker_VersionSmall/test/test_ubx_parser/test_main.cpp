@@ -0,0 +1,181 @@
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <ubx_parser.h>
+#include "gps_streams.h"
+
+// ============= HELPERS =============
+static UBXParser parser;
+
+// Feed a byte stream, returning the number of NAV-PVT fixes decoded
+static int feed(const uint8_t* data, size_t length) {
+  int fixes = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (ubxEncode(parser, data[i])) fixes++;
+  }
+  return fixes;
+}
+
+static int feedText(const char* text) {
+  return feed((const uint8_t*)text, strlen(text));
+}
+
+// Split a mixed stream the way gpsTask() does: bytes outside UBX frames go
+// to the NMEA decoder, here collected as text
+static int split(const uint8_t* data, size_t length, std::string& nmea) {
+  int fixes = 0;
+  for (size_t i = 0; i < length; i++) {
+    bool wasInFrame = ubxInFrame(parser);
+    if (ubxEncode(parser, data[i])) {
+      fixes++;
+    } else if (!wasInFrame && !ubxInFrame(parser)) {
+      nmea += (char)data[i];
+    }
+  }
+  return fixes;
+}
+
+void setUp() {
+  ubxInit(parser);
+}
+
+void tearDown() {}
+
+// ============= TESTS =============
+void test_decodes_nav_pvt_fields() {
+  TEST_ASSERT_EQUAL(1, feed(UBX_PVT_FIX_1, sizeof(UBX_PVT_FIX_1)));
+
+  const UBXNavPVT& pvt = parser.pvt;
+  TEST_ASSERT_EQUAL(2026, pvt.year);
+  TEST_ASSERT_EQUAL(6, pvt.month);
+  TEST_ASSERT_EQUAL(14, pvt.day);
+  TEST_ASSERT_EQUAL(8, pvt.hour);
+  TEST_ASSERT_EQUAL(30, pvt.minute);
+  TEST_ASSERT_EQUAL(15, pvt.second);
+  TEST_ASSERT_TRUE(pvt.dateValid);
+  TEST_ASSERT_TRUE(pvt.timeValid);
+  TEST_ASSERT_EQUAL(3, pvt.fixType);
+  TEST_ASSERT_TRUE(pvt.gnssFixOK);
+  TEST_ASSERT_EQUAL(9, pvt.numSV);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-7, 45.9237, pvt.latitude);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-7, 6.8652, pvt.longitude);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 1035.2, pvt.altitudeMSL);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 3.2, pvt.hAccuracy);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 4.8, pvt.vAccuracy);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 1.25, pvt.groundSpeed);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 87.5, pvt.heading);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 0.4, pvt.speedAccuracy);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 1.45, pvt.pDOP);
+  TEST_ASSERT_EQUAL(1, parser.framesDecoded);
+  TEST_ASSERT_EQUAL(0, parser.checksumFailures);
+  TEST_ASSERT_FALSE(ubxInFrame(parser));
+}
+
+void test_back_to_back_frames() {
+  TEST_ASSERT_EQUAL(1, feed(UBX_PVT_FIX_1, sizeof(UBX_PVT_FIX_1)));
+  TEST_ASSERT_EQUAL(1, feed(UBX_PVT_FIX_2, sizeof(UBX_PVT_FIX_2)));
+  TEST_ASSERT_EQUAL(16, parser.pvt.second);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-7, 45.9237112, parser.pvt.latitude);
+  TEST_ASSERT_DOUBLE_WITHIN(1e-7, 6.8652160, parser.pvt.longitude);
+  TEST_ASSERT_EQUAL(2, parser.framesDecoded);
+}
+
+void test_byte_at_a_time_matches_whole_frame() {
+  // The UART hands the task whatever has arrived; frames split anywhere
+  for (size_t cut = 1; cut < sizeof(UBX_PVT_FIX_1); cut++) {
+    ubxInit(parser);
+    int fixes = feed(UBX_PVT_FIX_1, cut);
+    fixes += feed(UBX_PVT_FIX_1 + cut, sizeof(UBX_PVT_FIX_1) - cut);
+    TEST_ASSERT_EQUAL(1, fixes);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-7, 45.9237, parser.pvt.latitude);
+  }
+}
+
+void test_bad_checksum_is_rejected_and_parser_resyncs() {
+  uint8_t corrupted[sizeof(UBX_PVT_FIX_1)];
+  memcpy(corrupted, UBX_PVT_FIX_1, sizeof(corrupted));
+  corrupted[6 + 28] ^= 0x01;   // One bit of the latitude
+
+  TEST_ASSERT_EQUAL(0, feed(corrupted, sizeof(corrupted)));
+  TEST_ASSERT_EQUAL(1, parser.checksumFailures);
+  TEST_ASSERT_EQUAL(0, parser.framesDecoded);
+
+  TEST_ASSERT_EQUAL(1, feed(UBX_PVT_FIX_2, sizeof(UBX_PVT_FIX_2)));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-7, 45.9237112, parser.pvt.latitude);
+}
+
+void test_other_messages_are_checked_but_not_fixes() {
+  TEST_ASSERT_EQUAL(0, feed(UBX_ACK_ACK, sizeof(UBX_ACK_ACK)));
+  TEST_ASSERT_EQUAL(1, parser.framesDecoded);
+  TEST_ASSERT_EQUAL(0, parser.checksumFailures);
+  TEST_ASSERT_FALSE(ubxInFrame(parser));
+}
+
+void test_oversized_message_does_not_overrun_buffer() {
+  // 200-byte payload into a 92-byte buffer: checksummed, not stored
+  TEST_ASSERT_EQUAL(0, feed(UBX_NAV_SAT, sizeof(UBX_NAV_SAT)));
+  TEST_ASSERT_EQUAL(1, parser.framesDecoded);
+  TEST_ASSERT_EQUAL(0, parser.checksumFailures);
+
+  TEST_ASSERT_EQUAL(1, feed(UBX_PVT_FIX_1, sizeof(UBX_PVT_FIX_1)));
+  TEST_ASSERT_DOUBLE_WITHIN(1e-7, 6.8652, parser.pvt.longitude);
+}
+
+void test_truncated_frame_costs_at_most_the_next_one() {
+  // A frame cut off by a UART overflow swallows the start of the next one
+  // as payload; the parser must be back in sync for the one after
+  TEST_ASSERT_EQUAL(0, feed(UBX_PVT_FIX_1, 40));
+  feed(UBX_PVT_FIX_2, sizeof(UBX_PVT_FIX_2));
+  feed(UBX_PVT_FIX_1, sizeof(UBX_PVT_FIX_1));
+  TEST_ASSERT_EQUAL(1, feed(UBX_PVT_FIX_2, sizeof(UBX_PVT_FIX_2)));
+  TEST_ASSERT_EQUAL(16, parser.pvt.second);
+}
+
+void test_nmea_alone_never_enters_a_frame() {
+  TEST_ASSERT_EQUAL(0, feedText(NMEA_TXT));
+  TEST_ASSERT_EQUAL(0, feedText(NMEA_FIX_1));
+  TEST_ASSERT_EQUAL(0, feedText(NMEA_FIX_2));
+  TEST_ASSERT_FALSE(ubxInFrame(parser));
+  TEST_ASSERT_EQUAL(0, parser.framesDecoded);
+  TEST_ASSERT_EQUAL(0, parser.checksumFailures);
+}
+
+void test_mixed_stream_splits_cleanly() {
+  // Start-up: NMEA still on until configureGPS() turns it off, then UBX only
+  std::string stream = NMEA_TXT;
+  stream += NMEA_FIX_1;
+  stream.append((const char*)UBX_ACK_ACK, sizeof(UBX_ACK_ACK));
+  stream.append((const char*)UBX_PVT_FIX_1, sizeof(UBX_PVT_FIX_1));
+  stream += NMEA_FIX_2;
+  stream.append((const char*)UBX_NAV_SAT, sizeof(UBX_NAV_SAT));
+  stream.append((const char*)UBX_PVT_FIX_2, sizeof(UBX_PVT_FIX_2));
+
+  std::string nmea;
+  TEST_ASSERT_EQUAL(2, split((const uint8_t*)stream.data(), stream.size(), nmea));
+  TEST_ASSERT_EQUAL_STRING((std::string(NMEA_TXT) + NMEA_FIX_1 + NMEA_FIX_2).c_str(), nmea.c_str());
+  TEST_ASSERT_EQUAL(4, parser.framesDecoded);
+  TEST_ASSERT_EQUAL(16, parser.pvt.second);
+}
+
+void test_format_gps_time() {
+  char buffer[9];
+  formatGPSTime(buffer, 8, 30, 5);
+  TEST_ASSERT_EQUAL_STRING("08:30:05", buffer);
+  formatGPSTime(buffer, 23, 59, 59);
+  TEST_ASSERT_EQUAL_STRING("23:59:59", buffer);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_decodes_nav_pvt_fields);
+  RUN_TEST(test_back_to_back_frames);
+  RUN_TEST(test_byte_at_a_time_matches_whole_frame);
+  RUN_TEST(test_bad_checksum_is_rejected_and_parser_resyncs);
+  RUN_TEST(test_other_messages_are_checked_but_not_fixes);
+  RUN_TEST(test_oversized_message_does_not_overrun_buffer);
+  RUN_TEST(test_truncated_frame_costs_at_most_the_next_one);
+  RUN_TEST(test_nmea_alone_never_enters_a_frame);
+  RUN_TEST(test_mixed_stream_splits_cleanly);
+  RUN_TEST(test_format_gps_time);
+  return UNITY_END();
+}
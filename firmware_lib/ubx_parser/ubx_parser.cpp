@@ -0,0 +1,133 @@
+#include "ubx_parser.h"
+
+// Little-endian field readers
+static inline uint16_t ubxU2(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t ubxU4(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+static inline int32_t ubxI4(const uint8_t* p) { return (int32_t)ubxU4(p); }
+
+void ubxInit(UBXParser& parser) {
+  memset(&parser, 0, sizeof(parser));
+  parser.state = UBX_STATE_SYNC_1;
+}
+
+// True while a frame is being assembled, so NMEA bytes can be told apart
+bool ubxInFrame(const UBXParser& parser) {
+  return parser.state != UBX_STATE_SYNC_1;
+}
+
+void ubxDecodeNavPVT(const uint8_t* p, UBXNavPVT& pvt) {
+  pvt.year = ubxU2(p + 4);
+  pvt.month = p[6];
+  pvt.day = p[7];
+  pvt.hour = p[8];
+  pvt.minute = p[9];
+  pvt.second = p[10];
+  pvt.dateValid = p[11] & 0x01;
+  pvt.timeValid = p[11] & 0x02;
+  pvt.fixType = p[20];
+  pvt.gnssFixOK = p[21] & 0x01;
+  pvt.numSV = p[23];
+  pvt.longitude = ubxI4(p + 24) * 1e-7;
+  pvt.latitude = ubxI4(p + 28) * 1e-7;
+  pvt.altitudeMSL = ubxI4(p + 36) * 0.001f;
+  pvt.hAccuracy = ubxU4(p + 40) * 0.001f;
+  pvt.vAccuracy = ubxU4(p + 44) * 0.001f;
+  pvt.groundSpeed = ubxI4(p + 60) * 0.001f;
+  pvt.heading = ubxI4(p + 64) * 1e-5f;
+  pvt.speedAccuracy = ubxU4(p + 68) * 0.001f;
+  pvt.pDOP = ubxU2(p + 76) * 0.01f;
+}
+
+// Feed one byte; returns true when a complete NAV-PVT has been decoded
+bool ubxEncode(UBXParser& parser, uint8_t c) {
+  switch (parser.state) {
+    case UBX_STATE_SYNC_1:
+      if (c == UBX_SYNC_1) parser.state = UBX_STATE_SYNC_2;
+      return false;
+
+    case UBX_STATE_SYNC_2:
+      parser.state = (c == UBX_SYNC_2) ? UBX_STATE_CLASS : UBX_STATE_SYNC_1;
+      return false;
+
+    case UBX_STATE_CLASS:
+      parser.msgClass = c;
+      parser.ckA = c;
+      parser.ckB = parser.ckA;
+      parser.state = UBX_STATE_ID;
+      return false;
+
+    case UBX_STATE_ID:
+      parser.msgId = c;
+      parser.ckA += c;
+      parser.ckB += parser.ckA;
+      parser.state = UBX_STATE_LENGTH_1;
+      return false;
+
+    case UBX_STATE_LENGTH_1:
+      parser.length = c;
+      parser.ckA += c;
+      parser.ckB += parser.ckA;
+      parser.state = UBX_STATE_LENGTH_2;
+      return false;
+
+    case UBX_STATE_LENGTH_2:
+      parser.length |= (uint16_t)c << 8;
+      parser.ckA += c;
+      parser.ckB += parser.ckA;
+      parser.index = 0;
+      parser.state = parser.length > 0 ? UBX_STATE_PAYLOAD : UBX_STATE_CK_A;
+      return false;
+
+    case UBX_STATE_PAYLOAD:
+      // Messages larger than the buffer are checksummed but not stored
+      if (parser.index < UBX_MAX_PAYLOAD) {
+        parser.payload[parser.index] = c;
+      }
+      parser.index++;
+      parser.ckA += c;
+      parser.ckB += parser.ckA;
+      if (parser.index >= parser.length) {
+        parser.state = UBX_STATE_CK_A;
+      }
+      return false;
+
+    case UBX_STATE_CK_A:
+      if (c != parser.ckA) {
+        parser.checksumFailures++;
+        parser.state = UBX_STATE_SYNC_1;
+        return false;
+      }
+      parser.state = UBX_STATE_CK_B;
+      return false;
+
+    case UBX_STATE_CK_B:
+      parser.state = UBX_STATE_SYNC_1;
+      if (c != parser.ckB) {
+        parser.checksumFailures++;
+        return false;
+      }
+      parser.framesDecoded++;
+      if (parser.msgClass == UBX_CLASS_NAV && parser.msgId == UBX_ID_NAV_PVT &&
+          parser.length == UBX_NAV_PVT_LENGTH) {
+        ubxDecodeNavPVT(parser.payload, parser.pvt);
+        return true;
+      }
+      return false;
+  }
+
+  parser.state = UBX_STATE_SYNC_1;
+  return false;
+}
+
+// Format HH:MM:SS without printf; buffer must hold 9 bytes
+void formatGPSTime(char* buffer, uint8_t hour, uint8_t minute, uint8_t second) {
+  buffer[0] = '0' + hour / 10;
+  buffer[1] = '0' + hour % 10;
+  buffer[2] = ':';
+  buffer[3] = '0' + minute / 10;
+  buffer[4] = '0' + minute % 10;
+  buffer[5] = ':';
+  buffer[6] = '0' + second / 10;
+  buffer[7] = '0' + second % 10;
+  buffer[8] = '\0';
+}
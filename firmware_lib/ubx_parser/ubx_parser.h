@@ -0,0 +1,75 @@
+#ifndef UBX_PARSER_H
+#define UBX_PARSER_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Shared by the hiker and basecamp firmware (lib_extra_dirs in each
+// platformio.ini), so both decode the receiver the same way.
+
+// ============= UBX PROTOCOL =============
+#define UBX_SYNC_1          0xB5
+#define UBX_SYNC_2          0x62
+#define UBX_CLASS_NAV       0x01
+#define UBX_ID_NAV_PVT      0x07
+#define UBX_NAV_PVT_LENGTH  92
+#define UBX_MAX_PAYLOAD     UBX_NAV_PVT_LENGTH
+
+// Decoded UBX-NAV-PVT (navigation position velocity time solution)
+struct UBXNavPVT {
+  uint16_t year;
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t second;
+  bool dateValid;
+  bool timeValid;
+  uint8_t fixType;       // 0 none, 2 2D, 3 3D, 4 GNSS+DR
+  bool gnssFixOK;
+  uint8_t numSV;
+  double latitude;       // degrees
+  double longitude;      // degrees
+  float altitudeMSL;     // m
+  float hAccuracy;       // m
+  float vAccuracy;       // m
+  float groundSpeed;     // m/s
+  float heading;         // degrees
+  float speedAccuracy;   // m/s
+  float pDOP;
+};
+
+enum UBXParseState {
+  UBX_STATE_SYNC_1,
+  UBX_STATE_SYNC_2,
+  UBX_STATE_CLASS,
+  UBX_STATE_ID,
+  UBX_STATE_LENGTH_1,
+  UBX_STATE_LENGTH_2,
+  UBX_STATE_PAYLOAD,
+  UBX_STATE_CK_A,
+  UBX_STATE_CK_B
+};
+
+struct UBXParser {
+  UBXParseState state;
+  uint8_t msgClass;
+  uint8_t msgId;
+  uint16_t length;
+  uint16_t index;
+  uint8_t ckA;
+  uint8_t ckB;
+  uint8_t payload[UBX_MAX_PAYLOAD];
+  UBXNavPVT pvt;           // Last successfully decoded NAV-PVT
+  uint32_t framesDecoded;
+  uint32_t checksumFailures;
+};
+
+// ============= UBX FUNCTIONS =============
+void ubxInit(UBXParser& parser);
+bool ubxInFrame(const UBXParser& parser);
+void ubxDecodeNavPVT(const uint8_t* p, UBXNavPVT& pvt);
+bool ubxEncode(UBXParser& parser, uint8_t c);
+void formatGPSTime(char* buffer, uint8_t hour, uint8_t minute, uint8_t second);
+
+#endif // UBX_PARSER_H